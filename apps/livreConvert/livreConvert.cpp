@@ -0,0 +1,93 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/data/VolumeDataSource.h>
+#include <livre/lib/data/LVBWriter.h>
+
+#include <boost/program_options.hpp>
+
+namespace po = boost::program_options;
+
+namespace
+{
+
+livre::BrickCompression getCompression( const std::string& name )
+{
+    if( name == "lz4" )
+        return livre::BRICK_COMPRESSION_LZ4;
+    if( name == "zstd" )
+        return livre::BRICK_COMPRESSION_ZSTD;
+    if( name != "none" )
+        LBTHROW( std::runtime_error( "Unknown compression " + name ));
+    return livre::BRICK_COMPRESSION_NONE;
+}
+
+}
+
+int main( const int argc, char** argv )
+{
+    std::string input;
+    std::string output;
+    std::string compressionName;
+    uint32_t frames = 0;
+
+    po::options_description options( "livreConvert - convert volumes to the "
+                                      "native Livre bricked format (.lvb)" );
+    options.add_options()
+        ( "help,h", "Show this help" )
+        ( "input,i", po::value< std::string >( &input )->required(),
+          "URI of the input volume, e.g. uvf:///path/volume.uvf" )
+        ( "output,o", po::value< std::string >( &output )->required(),
+          "Path of the output .lvb file" )
+        ( "compression,c",
+          po::value< std::string >( &compressionName )->default_value( "none" ),
+          "Brick compression: none, lz4 or zstd" )
+        ( "frames,f", po::value< uint32_t >( &frames ),
+          "Number of frames to convert (default: all, 1 if unbounded)" );
+
+    try
+    {
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, options ), vm );
+        if( vm.count( "help" ))
+        {
+            std::cout << options << std::endl;
+            return EXIT_SUCCESS;
+        }
+        po::notify( vm );
+
+        const livre::BrickCompression compression =
+            getCompression( compressionName );
+        if( !livre::isBrickCompressionSupported( compression ))
+            LBTHROW( std::runtime_error( compressionName +
+                                         " compression is not available" ));
+
+        livre::VolumeDataSource::loadPlugins();
+        livre::VolumeDataSource source( (lunchbox::URI( input )));
+        livre::writeLVB( source, output, compression, frames );
+    }
+    catch( const std::exception& e )
+    {
+        std::cerr << e.what() << std::endl << options << std::endl;
+        livre::VolumeDataSource::unloadPlugins();
+        return EXIT_FAILURE;
+    }
+    livre::VolumeDataSource::unloadPlugins();
+    return EXIT_SUCCESS;
+}
@@ -24,10 +24,19 @@
 #include <livre/core/data/VolumeDataSource.h>
 #include <livre/lib/zeq/events.h>
 #include <zeq/zeq.h>
+#include <lunchbox/atomic.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/mtQueue.h>
+#include <lunchbox/scopedMutex.h>
 #include <lunchbox/stdExt.h>
 
 #include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <list>
 
 namespace livre
 {
@@ -38,47 +47,155 @@ namespace livre
  * to a Livre application using a remote data source. Runs a broker on *:27766
  * to allow remote, non-zeroconf connections.
  *
+ * Requests are read by a pool of worker threads, through VolumeDataSource
+ * which serializes the reads of plugins that are not thread safe. Recently
+ * served bricks are kept in a LRU cache bounded in bytes, shared by all clients
+ * of a data source, and identical requests arriving while a brick is being read
+ * are answered by that single read.
+ *
  * Example: @include tests/remote/dataSource.cpp
  */
 class DataService
 {
 public:
+    /** Default size of the brick cache in bytes */
+    static const size_t defaultCacheSize = 1024 * LB_1MB;
+
     DataService()
         : _publisher( lunchbox::URI( "livresource://" ))
         , _subscriber( lunchbox::URI( "livresink://" ))
         , _broker( "*:27766", _subscriber )
         , _running( true )
+        , _reads( 0 )
+        , _cacheHits( 0 )
+        , _coalesced( 0 )
+        , _cacheSize( defaultCacheSize )
+        , _cacheUsed( 0 )
     {
-        _setup();
+        _setup( 0 );
     }
 
-    explicit DataService( const std::string& address )
+    /**
+     * @param address the zeroconf session of the service.
+     * @param nThreads the number of worker threads, 0 for one per core.
+     * @param cacheSize the maximum size of the brick cache in bytes.
+     */
+    explicit DataService( const std::string& address,
+                          const size_t nThreads = 0,
+                          const size_t cacheSize = defaultCacheSize )
         : _publisher( lunchbox::URI( "livresource://" + address ))
         , _subscriber( lunchbox::URI( "livresink://" + address ))
         , _broker( "*:27766", _subscriber )
         , _running( true )
+        , _reads( 0 )
+        , _cacheHits( 0 )
+        , _coalesced( 0 )
+        , _cacheSize( cacheSize )
+        , _cacheUsed( 0 )
     {
-        _setup();
+        _setup( nThreads );
     }
 
-    ~DataService() { VolumeDataSource::unloadPlugins(); }
+    ~DataService()
+    {
+        for( size_t i = 0; i < _nThreads; ++i )
+            _tasks.push( Task( ));
+        _threads.join_all();
+        VolumeDataSource::unloadPlugins();
+    }
 
     bool isRunning() const { return _running; }
     void processOne() { _subscriber.receive(); }
 
+    /** @return the number of bricks read from the data sources. */
+    size_t getReadCount() const { return size_t( _reads ); }
+
+    /** @return the number of requests answered from the brick cache. */
+    size_t getCacheHitCount() const { return size_t( _cacheHits ); }
+
+    /** @return the number of requests answered by a read in flight. */
+    size_t getCoalescedCount() const { return size_t( _coalesced ); }
+
 private:
     typedef stde::hash_map< ::zeq::uint128_t,
                             VolumeDataSourcePtr > DataSourceMap;
+
+    /** Identifies one brick of one data source */
+    struct BrickKey
+    {
+        BrickKey( const ::zeq::uint128_t& source_, const NodeId& nodeId_ )
+            : source( source_ ), nodeId( nodeId_.getId( )) {}
+
+        bool operator==( const BrickKey& rhs ) const
+            { return source == rhs.source && nodeId == rhs.nodeId; }
+
+        ::zeq::uint128_t source;
+        uint64_t nodeId;
+    };
+
+    struct BrickKeyHash
+    {
+        size_t operator()( const BrickKey& key ) const
+        {
+            size_t seed = 0;
+            boost::hash_combine( seed, key.source.high( ));
+            boost::hash_combine( seed, key.source.low( ));
+            boost::hash_combine( seed, key.nodeId );
+            return seed;
+        }
+    };
+
+    /** A brick read, the data source is empty for the pool shutdown */
+    struct Task
+    {
+        Task() : key( ::zeq::uint128_t(), NodeId( )) {}
+        Task( const BrickKey& key_, const VolumeDataSourcePtr& dataSource_,
+              const LODNode& node_ )
+            : key( key_ ), dataSource( dataSource_ ), node( node_ ) {}
+
+        BrickKey key;
+        VolumeDataSourcePtr dataSource;
+        LODNode node;
+    };
+
+    typedef std::list< BrickKey > LRUList;
+    typedef std::pair< MemoryUnitPtr, LRUList::iterator > CacheEntry;
+    typedef boost::unordered_map< BrickKey, CacheEntry,
+                                  BrickKeyHash > BrickCache;
+    /** The compressions requested for a pending read, one bit each */
+    typedef boost::unordered_map< BrickKey, uint32_t,
+                                  BrickKeyHash > PendingMap;
+
     ::zeq::Publisher _publisher;
     ::zeq::Subscriber _subscriber;
     ::zeq::connection::Broker _broker;
     DataSourceMap _dataSources;
     bool _running;
 
-    void _setup()
+    size_t _nThreads;
+    lunchbox::MTQueue< Task > _tasks;
+    boost::thread_group _threads;
+    lunchbox::Lock _publishLock;
+    lunchbox::a_ssize_t _reads;
+    lunchbox::a_ssize_t _cacheHits;
+    lunchbox::a_ssize_t _coalesced;
+
+    lunchbox::Lock _lock; // protects all members below
+    PendingMap _pending;
+    BrickCache _cache;
+    LRUList _lru; // most recently used first
+    const size_t _cacheSize;
+    size_t _cacheUsed;
+
+    void _setup( const size_t nThreads )
     {
         VolumeDataSource::loadPlugins();
 
+        _nThreads = nThreads ? nThreads :
+                    std::max( boost::thread::hardware_concurrency(), 1u );
+        for( size_t i = 0; i < _nThreads; ++i )
+            _threads.create_thread( boost::bind( &DataService::_run, this ));
+
         if( !_subscriber.registerHandler( zeq::EVENT_DATASOURCE,
                     boost::bind( &livre::DataService::_newClient, this, _1 )) ||
             !_subscriber.registerHandler( ::zeq::vocabulary::EVENT_EXIT,
@@ -88,7 +205,9 @@ private:
                          "ZeroEQ event handler registration failed" ));
         }
 
-        LBINFO << "Livre data service set up" << std::endl;
+        LBINFO << "Livre data service set up with " << _nThreads
+               << " threads and " << _cacheSize / LB_1MB << " MB of cache"
+               << std::endl;
     }
 
     void _stop( const ::zeq::Event& ) { _running = false; }
@@ -118,8 +237,13 @@ private:
         }
 
         const VolumeInformation& info=dataSource->getVolumeInformation();
-        _publisher.publish( zeq::serializeDataSourceData(
-                                std::make_pair( dataEvent, info )));
+        {
+            // the worker threads publish concurrently
+            lunchbox::ScopedWrite mutex( _publishLock );
+            _publisher.publish( zeq::serializeDataSourceData(
+                                    std::make_pair( dataEvent, info ),
+                                    getSupportedBrickCompressions( )));
+        }
         LBINFO << "Serving " << uri << std::endl;
     }
 
@@ -130,11 +254,105 @@ private:
         if( !dataSource )
             return;
 
-        MemoryUnitPtr data = dataSource->getData( request.second );
-        _publisher.publish( zeq::serializeDataSampleData( request.first + 1
-                                                          , data ));
+        const BrickKey key( request.first, request.second.getNodeId( ));
+        const uint32_t compression =
+            1u << zeq::deserializeDataSampleCompression( event );
+        {
+            lunchbox::ScopedWrite mutex( _lock );
+            PendingMap::iterator i = _pending.find( key );
+            if( i != _pending.end( ))
+            {
+                // answered by the read in flight
+                i->second |= compression;
+                ++_coalesced;
+                return;
+            }
+            _pending[ key ] = compression;
+        }
+        _tasks.push( Task( key, dataSource, request.second ));
+    }
+
+    void _run()
+    {
+        for( ;; )
+        {
+            const Task task = _tasks.pop();
+            if( !task.dataSource )
+                return;
+            _read( task );
+        }
+    }
+
+    void _read( const Task& task )
+    {
+        MemoryUnitPtr data = _getCached( task.key );
+        if( data )
+            ++_cacheHits;
+        else
+        {
+            data = task.dataSource->getData( task.node );
+            ++_reads;
+            _addCached( task.key, data );
+        }
+
+        uint32_t compressions = 0;
+        {
+            lunchbox::ScopedWrite mutex( _lock );
+            PendingMap::iterator i = _pending.find( task.key );
+            compressions = i->second;
+            _pending.erase( i );
+        }
+
+        // clients share the response event of a data source, so one response
+        // per requested compression answers all of them
+        for( uint32_t compression = 0; compressions; ++compression )
+        {
+            const uint32_t bit = 1u << compression;
+            if( !( compressions & bit ))
+                continue;
+            compressions &= ~bit;
+
+            const ::zeq::Event& response = zeq::serializeDataSampleData(
+                task.key.source + 1, task.node.getNodeId(), data,
+                BrickCompression( compression ));
+            lunchbox::ScopedWrite mutex( _publishLock );
+            _publisher.publish( response );
+        }
         std::cout << '.' << std::flush;
     }
+
+    MemoryUnitPtr _getCached( const BrickKey& key )
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        BrickCache::iterator i = _cache.find( key );
+        if( i == _cache.end( ))
+            return MemoryUnitPtr();
+
+        _lru.splice( _lru.begin(), _lru, i->second.second );
+        return i->second.first;
+    }
+
+    void _addCached( const BrickKey& key, const MemoryUnitPtr& data )
+    {
+        if( !data || data->getMemSize() > _cacheSize )
+            return;
+
+        lunchbox::ScopedWrite mutex( _lock );
+        if( _cache.count( key ))
+            return;
+
+        _cacheUsed += data->getMemSize();
+        _lru.push_front( key );
+        _cache[ key ] = CacheEntry( data, _lru.begin( ));
+
+        while( _cacheUsed > _cacheSize )
+        {
+            BrickCache::iterator i = _cache.find( _lru.back( ));
+            _cacheUsed -= i->second.first->getMemSize();
+            _cache.erase( i );
+            _lru.pop_back();
+        }
+    }
 };
 }
 
@@ -19,9 +19,14 @@
 
 #include "dataService.h"
 
+/** Usage: livreService [session [threads [cacheMB]]] */
 int main( const int argc, char** argv )
 {
-    livre::DataService service( argc == 2 ?  argv[1] : "" );
+    const size_t nThreads = argc > 2 ? ::atoi( argv[2] ) : 0;
+    const size_t cacheSize = argc > 3 ? ::atoi( argv[3] ) * LB_1MB :
+                                        livre::DataService::defaultCacheSize;
+    livre::DataService service( argc > 1 ?  argv[1] : "", nThreads,
+                                cacheSize );
     while( service.isRunning( ))
         service.processOne();
 
@@ -22,8 +22,12 @@
 #include <livre/core/cache/CacheObject.h>
 #include <livre/core/cache/CachePolicy.h>
 #include <livre/core/cache/CacheStatistics.h>
+#include <livre/core/cache/FrequencySketch.h>
 
-#define CACHE_LOG_SIZE 1000000
+#include <lunchbox/scopedMutex.h>
+
+#define CACHE_LOG_SIZE 1024
+#define CLOCK_PEEK_LENGTH 32
 
 namespace livre
 {
@@ -40,22 +44,42 @@ CacheObjectPtr Cache::getObjectFromCache( const CacheId cacheObjectID ) const
 
 Cache::ApplyResult Cache::applyPolicy( CachePolicy& cachePolicy ) const
 {
-    ReadLock readLock( mutex_, boost::try_to_lock );
-    if( !readLock.owns_lock() )
-        return AR_CACHEBUSY;
+    ReadLock reclaimLock( reclaimMutex_ );
+    return applyPolicy_( cachePolicy );
+}
 
-    if( cacheMap_.empty() || !cachePolicy.willPolicyBeActivated( *this ) )
+Cache::ApplyResult Cache::applyPolicy_( CachePolicy& cachePolicy ) const
+{
+    if( getNumberOfCacheObjects() == 0 ||
+        !cachePolicy.willPolicyBeActivated( *this ) )
+    {
         return AR_NOTACTIVATED;
+    }
+
+    if( cachePolicy.isRecencyOrdered_() )
+        return applyRecencyPolicy_( cachePolicy );
 
     std::vector< CacheObject* > cacheObjectList;
-    cacheObjectList.reserve( cacheMap_.size() );
+    cacheObjectList.reserve( getNumberOfCacheObjects() );
 
-    for( CacheMap::const_iterator it = cacheMap_.begin(); it != cacheMap_.end(); ++it )
+    // Objects are only removed from the shards by reclaim_(), which waits for
+    // the policy applications, so the collected objects stay valid after
+    // releasing the shard locks.
+    for( size_t i = 0; i < NUM_SHARDS; ++i )
     {
-        CacheObject* object = it->second.get();
-        if( object && object->isValid() && object->isLoaded_() )
+        const CacheShard& shard = shards_[ i ];
+        ReadLock readLock( shard.mutex, boost::try_to_lock );
+        if( !readLock.owns_lock() )
+            return AR_CACHEBUSY;
+
+        for( CacheMap::const_iterator it = shard.cacheMap.begin();
+             it != shard.cacheMap.end(); ++it )
         {
-            cacheObjectList.push_back( object );
+            CacheObject* object = it->second.get();
+            if( object && object->isValid() && object->isLoaded_() )
+            {
+                cacheObjectList.push_back( object );
+            }
         }
     }
 
@@ -69,46 +93,271 @@ Cache::ApplyResult Cache::applyPolicy( CachePolicy& cachePolicy ) const
     return AR_ACTIVATED;
 }
 
+void Cache::setAdmissionFilter( const size_t capacity )
+{
+    admissionSketch_.reset( capacity > 0 ? new FrequencySketch( capacity )
+                                         : 0 );
+}
+
+bool Cache::hasAdmissionFilter( ) const
+{
+    return admissionSketch_.get() != 0;
+}
+
+Cache::ApplyResult Cache::applyPolicyOnLoad_( CachePolicy& cachePolicy,
+                                      const CacheObject& cacheObject ) const
+{
+    ReadLock reclaimLock( reclaimMutex_ );
+    if( !admissionSketch_ || !cachePolicy.isRecencyOrdered_() ||
+        !cachePolicy.willPolicyBeActivated( *this ))
+    {
+        return applyPolicy_( cachePolicy );
+    }
+
+    const CacheObject* victim = peekClockVictim_( &cacheObject );
+    const bool admitted = !victim ||
+        admissionSketch_->estimate( cacheObject.getCacheID( )) >
+        admissionSketch_->estimate( victim->getCacheID( ));
+    statisticsPtr_->countAdmission_( admitted );
+    if( admitted )
+        return applyPolicy_( cachePolicy );
+
+    // The loaded object cannot be unloaded before its load returns, so the
+    // rejected object waits at the clock hand and the object rejected before
+    // is unloaded instead of a resident. The cache exceeds its maximum memory
+    // by one object at most.
+    CacheObject* previous = putOnProbation_( cacheObject.getUnconst_( ));
+    if( !previous )
+        return AR_ACTIVATED;
+
+    previous->cacheUnload();
+    if( previous->isLoaded_( )) // still in use
+        return applyPolicy_( cachePolicy );
+    return AR_ACTIVATED;
+}
+
+Cache::ApplyResult Cache::applyRecencyPolicy_( CachePolicy& cachePolicy ) const
+{
+    size_t attempts = 0;
+    {
+        lunchbox::ScopedWrite mutex( clockLock_ );
+        attempts = clockSize_;
+    }
+    if( attempts == 0 )
+        return AR_EMPTY;
+
+    // Objects in use or locked survive cacheUnload(), so give up after as many
+    // victims as there are loaded objects.
+    while( attempts-- > 0 )
+    {
+        CacheObject* victim = nextClockVictim_();
+        if( !victim )
+            break;
+
+        victim->cacheUnload( );
+        if( cachePolicy.isPolicySatisfied( *this ) )
+            break;
+    }
+    return AR_ACTIVATED;
+}
+
+CacheObject* Cache::nextClockVictim_() const
+{
+    lunchbox::ScopedWrite mutex( clockLock_ );
+
+    // Two rounds at most: the first may only clear the used bits
+    for( size_t i = 0; i < 2 * clockSize_; ++i )
+    {
+        CacheObject* object = clockHand_;
+        clockHand_ = object->clockNext_;
+
+        if( object->isPinned() || !object->isUnloadable() )
+            continue;
+        if( object->testAndClearUsed_() )
+            continue;
+        return object;
+    }
+    return 0;
+}
+
+const CacheObject* Cache::peekClockVictim_( const CacheObject* loaded ) const
+{
+    lunchbox::ScopedWrite mutex( clockLock_ );
+
+    // Without clearing the used bits, the first unused object is the victim
+    const CacheObject* candidate = 0;
+    const CacheObject* object = clockHand_;
+    const size_t length = std::min( clockSize_, size_t( CLOCK_PEEK_LENGTH ));
+    for( size_t i = 0; i < length; ++i, object = object->clockNext_ )
+    {
+        if( object == loaded || object->isPinned() || !object->isUnloadable() )
+            continue;
+        if( !object->isUsed_() )
+            return object;
+        if( !candidate )
+            candidate = object;
+    }
+    return candidate;
+}
+
+CacheObject* Cache::putOnProbation_( CacheObject* object ) const
+{
+    lunchbox::ScopedWrite mutex( clockLock_ );
+    CacheObject* previous = probation_ == object ? 0 : probation_;
+    probation_ = object;
+
+    object->testAndClearUsed_();
+    if( clockHand_ == object )
+        return previous;
+
+    object->clockPrev_->clockNext_ = object->clockNext_;
+    object->clockNext_->clockPrev_ = object->clockPrev_;
+
+    CacheObject* next = clockHand_;
+    object->clockPrev_ = next->clockPrev_;
+    object->clockNext_ = next;
+    next->clockPrev_->clockNext_ = object;
+    next->clockPrev_ = object;
+    clockHand_ = object;
+    return previous;
+}
+
+void Cache::onLoaded_( const CacheObject& cacheObject )
+{
+    CacheObject* object = cacheObject.getUnconst_();
+    lunchbox::ScopedWrite mutex( clockLock_ );
+    if( object->clockNext_ )
+        return;
+
+    // Insert behind the hand, so the new object is inspected last
+    if( clockHand_ )
+    {
+        CacheObject* previous = clockHand_->clockPrev_;
+        object->clockPrev_ = previous;
+        object->clockNext_ = clockHand_;
+        previous->clockNext_ = object;
+        clockHand_->clockPrev_ = object;
+    }
+    else
+    {
+        object->clockPrev_ = object;
+        object->clockNext_ = object;
+        clockHand_ = object;
+    }
+    ++clockSize_;
+}
+
+void Cache::onUnload_( const CacheObject& cacheObject )
+{
+    CacheObject* object = cacheObject.getUnconst_();
+    lunchbox::ScopedWrite mutex( clockLock_ );
+    if( !object->clockNext_ )
+        return;
+
+    if( object->clockNext_ == object )
+        clockHand_ = 0;
+    else
+    {
+        object->clockPrev_->clockNext_ = object->clockNext_;
+        object->clockNext_->clockPrev_ = object->clockPrev_;
+        if( clockHand_ == object )
+            clockHand_ = object->clockNext_;
+    }
+    object->clockPrev_ = 0;
+    object->clockNext_ = 0;
+    --clockSize_;
+    if( probation_ == object )
+        probation_ = 0;
+}
+
 Cache::Cache()
     : statisticsPtr_( new CacheStatistics( "Statistics", CACHE_LOG_SIZE ) )
+    , maxObjectCount_( 0 )
+    , objectCount_( 0 )
+    , nextReclaimCount_( 0 )
+    , clockHand_( 0 )
+    , clockSize_( 0 )
+    , probation_( 0 )
 {
 }
 
 Cache::~Cache()
 {
-    for( CacheMap::iterator it = cacheMap_.begin(); it != cacheMap_.end(); ++it )
+    for( size_t i = 0; i < NUM_SHARDS; ++i )
     {
-        CacheObjectPtr cacheObject = it->second;
-        cacheObject->unregisterObserver( this );
-        cacheObject->unregisterObserver( statisticsPtr_.get() );
+        CacheMap& cacheMap = shards_[ i ].cacheMap;
+        for( CacheMap::iterator it = cacheMap.begin(); it != cacheMap.end(); ++it )
+        {
+            CacheObjectPtr cacheObject = it->second;
+            cacheObject->unregisterObserver( this );
+            cacheObject->unregisterObserver( statisticsPtr_.get() );
+            cacheObject->setStatistics_( 0 );
+        }
     }
 }
 
+Cache::CacheShard& Cache::getShard_( const CacheId cacheObjectID ) const
+{
+    // Fibonacci hashing spreads the packed node id bits over all shards
+    const uint64_t hash = uint64_t( cacheObjectID ) * 0x9E3779B97F4A7C15ull;
+    return shards_[ hash >> 60 ];
+}
+
 CacheObjectPtr Cache::getObjectFromCache_( const CacheId cacheObjectID )
 {
     LBASSERT( cacheObjectID != INVALID_CACHE_ID );
 
-    WriteLock writeLock( mutex_ );
-    CacheMap::iterator it = cacheMap_.find( cacheObjectID );
-    if( it == cacheMap_.end() )
+    if( admissionSketch_ )
+        admissionSketch_->increment( cacheObjectID );
+
+    CacheShard& shard = getShard_( cacheObjectID );
     {
-        CacheObjectPtr cacheObjectPtr( generateCacheObjectFromID_( cacheObjectID ) );
-        cacheObjectPtr->registerObserver( this );
-        cacheObjectPtr->registerObserver( statisticsPtr_.get() );
-        cacheMap_[ cacheObjectID ] = cacheObjectPtr;
+        ReadLock readLock( shard.mutex );
+        CacheMap::const_iterator it = shard.cacheMap.find( cacheObjectID );
+        if( it != shard.cacheMap.end() )
+        {
+            LBASSERT( it->second->commonInfoPtr_ );
+            return it->second;
+        }
     }
 
-    LBASSERT( cacheMap_[ cacheObjectID ]->commonInfoPtr_ );
+    CacheObjectPtr cacheObject;
+    {
+        WriteLock writeLock( shard.mutex );
+        CacheObjectPtr& cacheObjectPtr = shard.cacheMap[ cacheObjectID ];
+        if( !cacheObjectPtr ) // not created by another thread in the meantime
+        {
+            cacheObjectPtr.reset( generateCacheObjectFromID_( cacheObjectID ) );
+            cacheObjectPtr->registerObserver( this );
+            cacheObjectPtr->registerObserver( statisticsPtr_.get() );
+            cacheObjectPtr->setStatistics_( statisticsPtr_.get() );
+            ++objectCount_;
+        }
+
+        LBASSERT( cacheObjectPtr->commonInfoPtr_ );
+        cacheObject = cacheObjectPtr;
+    }
 
-    return cacheMap_[ cacheObjectID ];
+    // The returned object is referenced, so it is not removed
+    if( maxObjectCount_ > 0 &&
+        ssize_t( objectCount_ ) > ssize_t( nextReclaimCount_ ))
+    {
+        // Objects in use stay, so wait for a quarter of new objects at least
+        reclaim_( maxObjectCount_ * 3 / 4 );
+        nextReclaimCount_ = std::max( ssize_t( maxObjectCount_ ),
+                                      ssize_t( objectCount_ ) +
+                                          ssize_t( maxObjectCount_ / 4 ));
+    }
+    return cacheObject;
 }
 
 CacheObjectPtr Cache::getObjectFromCache_( const CacheId cacheObjectID ) const
 {
-    ReadLock readLock( mutex_ );
-    CacheMap::const_iterator it = cacheMap_.find( cacheObjectID );
+    const CacheShard& shard = getShard_( cacheObjectID );
+    ReadLock readLock( shard.mutex );
+    CacheMap::const_iterator it = shard.cacheMap.find( cacheObjectID );
 
-    if( it == cacheMap_.end() )
+    if( it == shard.cacheMap.end() )
         return CacheObjectPtr();
 
     LBASSERT( it->second->commonInfoPtr_ );
@@ -128,10 +377,95 @@ void Cache::unloadCacheObjectsWithPolicy_( CachePolicy& cachePolicy,
     }
 }
 
+void Cache::setMaximumObjectCount( const size_t maxObjectCount )
+{
+    maxObjectCount_ = maxObjectCount;
+    nextReclaimCount_ = maxObjectCount;
+}
+
+size_t Cache::getMaximumObjectCount( ) const
+{
+    return maxObjectCount_;
+}
+
+size_t Cache::reclaim( )
+{
+    return reclaim_( 0 );
+}
+
+size_t Cache::reclaim_( const size_t maxObjectCount )
+{
+    WriteLock reclaimLock( reclaimMutex_, boost::try_to_lock );
+    if( !reclaimLock.owns_lock() )
+        return 0;
+
+    size_t nReclaimed = 0;
+    for( size_t i = 0; i < NUM_SHARDS; ++i )
+    {
+        CacheMap& cacheMap = shards_[ i ].cacheMap;
+        WriteLock writeLock( shards_[ i ].mutex );
+        CacheMap::iterator it = cacheMap.begin();
+        while( it != cacheMap.end() && objectCount_ > ssize_t( maxObjectCount ))
+        {
+            // Only the map references it, and the shard lock keeps it so
+            CacheObject* object = it->second.get();
+            if( object->isLoaded_() || object->isPinned() ||
+                object->getReferenceCount_() > 1 )
+            {
+                ++it;
+                continue;
+            }
+
+            // Releasing the last reference must not notify the cache, and
+            // does not delete the object: no other owner exists, delete it
+            object->unregisterObserver( this );
+            object->unregisterObserver( statisticsPtr_.get() );
+            object->setStatistics_( 0 );
+            it = cacheMap.erase( it );
+            delete object;
+            --objectCount_;
+            ++nReclaimed;
+        }
+    }
+    statisticsPtr_->countReclaim_( nReclaimed );
+    return nReclaimed;
+}
+
 size_t Cache::getNumberOfCacheObjects( ) const
 {
-    ReadLock readLock( mutex_ );
-    return cacheMap_.size( );
+    size_t count = 0;
+    for( size_t i = 0; i < NUM_SHARDS; ++i )
+    {
+        ReadLock readLock( shards_[ i ].mutex );
+        count += shards_[ i ].cacheMap.size( );
+    }
+    return count;
+}
+
+CacheIds Cache::getLoadedCacheIds( ) const
+{
+    typedef std::pair< double, CacheId > UsedObject;
+    std::vector< UsedObject > usedObjects;
+    for( size_t i = 0; i < NUM_SHARDS; ++i )
+    {
+        const CacheShard& shard = shards_[ i ];
+        ReadLock readLock( shard.mutex );
+        for( CacheMap::const_iterator it = shard.cacheMap.begin();
+             it != shard.cacheMap.end(); ++it )
+        {
+            const CacheObject* object = it->second.get();
+            if( object && object->isValid() && object->isLoaded_() )
+                usedObjects.push_back( UsedObject( -object->getLastUsed(),
+                                                   it->first ));
+        }
+    }
+
+    std::sort( usedObjects.begin(), usedObjects.end( ));
+    CacheIds cacheIds;
+    cacheIds.reserve( usedObjects.size( ));
+    BOOST_FOREACH( const UsedObject& usedObject, usedObjects )
+        cacheIds.push_back( usedObject.second );
+    return cacheIds;
 }
 
 CacheStatistics& Cache::getStatistics( )
@@ -31,6 +31,27 @@ namespace livre
 /**
  * The Cache class manages the \see CacheObject s according to applied policies, methods
  * are thread safe inserting/querying nodes.
+ *
+ * The objects are distributed over lock-striped shards. Lookups of existing
+ * objects only take a shared lock on their shard, and only the creation of a
+ * new object takes an exclusive lock on its shard.
+ *
+ * The loaded objects are linked in an intrusive CLOCK ring. Least recently
+ * used policies unload objects by advancing the clock hand, giving a second
+ * chance to objects used since the hand last passed them, which takes constant
+ * amortized time per unloaded object.
+ *
+ * An optional admission filter counts the non const lookups in a \see
+ * FrequencySketch.
+ * A newly loaded object then only displaces a resident of least recently used
+ * policies if it was requested more often than the next victim of the clock.
+ * Otherwise it is put on probation at the hand, and is unloaded in place of a
+ * resident when the next object is loaded.
+ *
+ * The objects are kept after unloading, with the metadata of their last use.
+ * Above a maximum number of objects, the objects which are neither loaded,
+ * pinned nor referenced outside of the cache are removed, so the memory of the
+ * metadata stays bounded when new ids keep coming, e.g. during a playback.
  */
 class Cache : public CacheObjectObserver
 {
@@ -67,11 +88,45 @@ public:
      */
     LIVRECORE_API ApplyResult applyPolicy( CachePolicy& cachePolicy ) const;
 
+    /**
+     * Enables the admission filter. Not thread safe, to be called before the
+     * cache is used.
+     * @param capacity The number of objects fitting in the cache, 0 disables
+     *        the filter.
+     */
+    LIVRECORE_API void setAdmissionFilter( size_t capacity );
+
+    /** @return true if the admission filter is enabled. */
+    LIVRECORE_API bool hasAdmissionFilter( ) const;
+
+    /**
+     * Sets the maximum number of objects. When a new object exceeds it, the
+     * cache removes the unused objects down to three quarters of it.
+     * @param maxObjectCount The maximum number of objects, 0 for no limit.
+     */
+    LIVRECORE_API void setMaximumObjectCount( size_t maxObjectCount );
+
+    /** @return The maximum number of objects, 0 for no limit. */
+    LIVRECORE_API size_t getMaximumObjectCount( ) const;
+
+    /**
+     * Removes all the objects which are neither loaded, pinned nor referenced
+     * outside of the cache.
+     * @return The number of removed objects, 0 if a policy is being applied.
+     */
+    LIVRECORE_API size_t reclaim( );
+
     /**
      * @return The number of cache objects managed ( not the number of loaded objects ).
      */
     LIVRECORE_API size_t getNumberOfCacheObjects( ) const;
 
+    /**
+     * @return The ids of the loaded objects, the most recently used first. The lookups are not
+     * counted in the statistics.
+     */
+    LIVRECORE_API CacheIds getLoadedCacheIds( ) const;
+
     /**
      * @return Statistics.
      */
@@ -105,15 +160,70 @@ protected:
      */
     virtual CacheObject* generateCacheObjectFromID_( const CacheId cacheID ) = 0;
 
+    /**
+     * Links the loaded object into the CLOCK ring. Derived classes overriding
+     * it have to call this implementation.
+     * @param cacheObject The CacheObject that notifies.
+     */
+    LIVRECORE_API void onLoaded_( const CacheObject& cacheObject );
+
+    /**
+     * Unlinks the object to be unloaded from the CLOCK ring. Derived classes
+     * overriding it have to call this implementation.
+     * @param cacheObject The CacheObject that notifies.
+     */
+    LIVRECORE_API void onUnload_( const CacheObject& cacheObject );
+
+    /**
+     * Applies a policy to the cache after an object was loaded. If the
+     * admission filter is enabled and rejects the object, it is moved to the
+     * clock hand and the object rejected before is unloaded instead.
+     * @param cachePolicy The policy to be applied to cache.
+     * @param cacheObject The object just loaded.
+     * @return The state for the cache policy application.
+     */
+    LIVRECORE_API ApplyResult applyPolicyOnLoad_( CachePolicy& cachePolicy,
+                                        const CacheObject& cacheObject ) const;
+
     CacheStatisticsPtr statisticsPtr_;  //!< The statistics object ptr.
 
 private:
 
+    /** One stripe of the cache map with its own lock */
+    struct CacheShard
+    {
+        CacheMap cacheMap;
+        mutable ReadWriteMutex mutex;
+    };
+
+    enum { NUM_SHARDS = 16 }; //!< Power of two
+
+    CacheShard& getShard_( const CacheId cacheObjectID ) const;
+
     void unloadCacheObjectsWithPolicy_( CachePolicy& cachePolicy,
                                         const std::vector< CacheObject * >& cacheObjectList ) const;
 
-    CacheMap cacheMap_;
-    mutable ReadWriteMutex mutex_;
+    ApplyResult applyPolicy_( CachePolicy& cachePolicy ) const;
+    ApplyResult applyRecencyPolicy_( CachePolicy& cachePolicy ) const;
+    CacheObject* nextClockVictim_() const;
+    const CacheObject* peekClockVictim_( const CacheObject* loaded ) const;
+    CacheObject* putOnProbation_( CacheObject* object ) const;
+    size_t reclaim_( size_t maxObjectCount );
+
+    mutable CacheShard shards_[ NUM_SHARDS ];
+
+    /** Shared by the policy applications, which keep raw object pointers */
+    mutable ReadWriteMutex reclaimMutex_;
+    size_t maxObjectCount_;
+    lunchbox::a_ssize_t objectCount_;
+    lunchbox::a_ssize_t nextReclaimCount_; //!< Object count to reclaim at
+
+    mutable lunchbox::Lock clockLock_;
+    mutable CacheObject* clockHand_; //!< Next object to inspect
+    size_t clockSize_; //!< Number of objects in the ring
+    mutable CacheObject* probation_; //!< Last object rejected, unloaded next
+
+    FrequencySketchPtr admissionSketch_; //!< Lookups, 0 if no filter
 };
 
 }
@@ -25,77 +25,89 @@
 #include <livre/core/cache/CacheObjectObserver.h>
 #include <livre/core/cache/CacheStatistics.h>
 
+#include <boost/thread/thread.hpp>
+
 namespace livre
 {
 
+namespace
+{
+/** Subtracted from the reference count while cacheUnload() runs */
+const int32_t UNLOADING = 1 << 30;
+}
+
 struct CacheObject::CacheInfo : public CacheObjectListener
 {
     CacheInfo( ) :
         referenceCount( 0 ),
-        lastUsedTime( 0.0 ),
+        lastUsedTime( 0 ),
         loadTime( 0.0 ),
-        unloadable( true )
+        unloadable( true ),
+        loaded( 0 ),
+        pinned( 0 ),
+        used( 0 ),
+        useCount( 0 ),
+        statistics( 0 )
     { }
 
-    uint32_t referenceCount;
-    double lastUsedTime;
+    lunchbox::a_int32_t referenceCount;
+    lunchbox::a_int64_t lastUsedTime; //!< In microseconds
     double loadTime;
     bool unloadable;
-    ReadWriteMutex mutex;
+    lunchbox::a_int32_t loaded; //!< Set after load_(), cleared before unload_()
+    lunchbox::a_int32_t pinned;
+    lunchbox::a_int32_t used; //!< CLOCK reference bit
+    lunchbox::a_int32_t useCount;
+    CacheStatistics* statistics; //!< Counts the lookups, set by the Cache
+    ReadWriteMutex mutex; //!< Serializes the load and unload transitions
 };
 
 CacheObject::CacheObject( )
     : commonInfoPtr_( new CacheInfo( ) )
+    , clockPrev_( 0 )
+    , clockNext_( 0 )
 {
 }
 
 void CacheObject::increaseReference_( )
 {
-    WriteLock lock( commonInfoPtr_->mutex );
-    commonInfoPtr_->referenceCount++;
-
-    for( CacheObjectObserverSet::iterator it = commonInfoPtr_->getObservers().begin();
-         it != commonInfoPtr_->getObservers().end();
-         ++it )
+    // A negative count is an unload in progress: wait for it to finish, so the
+    // new reference never sees the object being unloaded below it
+    for( ;; )
     {
-        (*it)->onReferenced_( *this );
+        const int32_t count = commonInfoPtr_->referenceCount;
+        if( count < 0 )
+            boost::this_thread::yield();
+        else if( commonInfoPtr_->referenceCount.compareAndSwap( count,
+                                                                count + 1 ))
+            return;
     }
 }
 
 void CacheObject::decreaseReference_( )
 {
-    WriteLock lock( commonInfoPtr_->mutex );
-    commonInfoPtr_->referenceCount--;
+    if( --commonInfoPtr_->referenceCount != 0 || !isValid_( ))
+        return;
 
-    if( commonInfoPtr_->referenceCount == 0 && isValid_() )
-    {
-        for( CacheObjectObserverSet::iterator it = commonInfoPtr_->getObservers().begin();
-             it != commonInfoPtr_->getObservers().end();
-             ++it )
-        {
-            (*it)->onUnload_( *this );
-        }
-        unload_();
-    }
+    WriteLock lock( commonInfoPtr_->mutex );
+    if( !isLoaded_( ))
+        return;
 
     for( CacheObjectObserverSet::iterator it = commonInfoPtr_->getObservers().begin();
          it != commonInfoPtr_->getObservers().end();
          ++it )
     {
-        (*it)->onUnreferenced_( *this );
+        (*it)->onUnload_( *this );
     }
+    commonInfoPtr_->loaded = 0;
+    unload_();
 }
 
 bool CacheObject::isLoaded() const
 {
-    ReadLock lock( commonInfoPtr_->mutex );
-    const bool ret = isValid_( ) && isLoaded_( );
-    for( CacheObjectObserverSet::const_iterator it = commonInfoPtr_->getObservers().begin();
-         it != commonInfoPtr_->getObservers().end();
-         ++it )
-    {
-        ret ? (*it)->onCacheHit_( *this ) : (*it)->onCacheMiss_( *this );
-    }
+    const bool ret = commonInfoPtr_->loaded != 0 && isValid_( );
+    if( commonInfoPtr_->statistics )
+        commonInfoPtr_->statistics->countLookup_( ret );
     return ret;
 }
 
@@ -115,6 +127,7 @@ void CacheObject::cacheLoad()
         return;
 
     commonInfoPtr_->loadTime = ThreadClock::getClock().getTimef() - start;
+    commonInfoPtr_->loaded = 1;
 
     for( CacheObjectObserverSet::iterator it = commonInfoPtr_->getObservers().begin();
          it != commonInfoPtr_->getObservers().end();
@@ -133,7 +146,14 @@ void CacheObject::cacheUnload( )
     if( !isUnloadable() )
         return;
 
-    if( !isLoaded_( ) || commonInfoPtr_->referenceCount > 1 )
+    if( !isLoaded_( ))
+        return;
+
+    // Only the cache may hold a reference: block new ones until unloaded
+    const int32_t count = commonInfoPtr_->referenceCount;
+    if( count < 0 || count > 1 ||
+        !commonInfoPtr_->referenceCount.compareAndSwap( count,
+                                                        count - UNLOADING ))
     {
         return;
     }
@@ -145,13 +165,15 @@ void CacheObject::cacheUnload( )
         (*it)->onUnload_( *this );
     }
 
+    commonInfoPtr_->loaded = 0;
     unload_( );
     resetLastUsed_();
+    commonInfoPtr_->referenceCount += UNLOADING;
 }
 
 double CacheObject::getLastUsed( ) const
 {
-    return commonInfoPtr_->lastUsedTime;
+    return double( commonInfoPtr_->lastUsedTime ) / 1000.0;
 }
 
 double CacheObject::getLoadTime( ) const
@@ -159,6 +181,11 @@ double CacheObject::getLoadTime( ) const
     return commonInfoPtr_->loadTime;
 }
 
+uint32_t CacheObject::getUseCount( ) const
+{
+    return commonInfoPtr_->useCount;
+}
+
 bool CacheObject::isUnloadable( ) const
 {
     return commonInfoPtr_->unloadable;
@@ -169,29 +196,64 @@ void CacheObject::setUnloadable( bool unloadable )
     commonInfoPtr_->unloadable = unloadable;
 }
 
+bool CacheObject::isPinned( ) const
+{
+    return commonInfoPtr_->pinned != 0;
+}
+
+void CacheObject::setPinned( const bool pinned )
+{
+    commonInfoPtr_->pinned = pinned ? 1 : 0;
+}
+
+bool CacheObject::testAndClearUsed_( )
+{
+    if( commonInfoPtr_->used == 0 )
+        return false;
+    commonInfoPtr_->used = 0;
+    return true;
+}
+
+bool CacheObject::isUsed_( ) const
+{
+    return commonInfoPtr_->used != 0;
+}
+
 uint32_t CacheObject::getReferenceCount_( ) const
 {
-    return commonInfoPtr_->referenceCount;
+    const int32_t count = commonInfoPtr_->referenceCount;
+    return count < 0 ? count + UNLOADING : count;
 }
 
 void CacheObject::registerObserver( CacheObjectObserver* observer )
 {
+    WriteLock lock( commonInfoPtr_->mutex );
     commonInfoPtr_->registerObserver( observer );
 }
 
 void CacheObject::unregisterObserver( CacheObjectObserver* observer )
 {
+    WriteLock lock( commonInfoPtr_->mutex );
     commonInfoPtr_->unregisterObserver( observer );
 }
 
+void CacheObject::setStatistics_( CacheStatistics* statistics )
+{
+    commonInfoPtr_->statistics = statistics;
+}
+
 void CacheObject::updateLastUsed_( const double lastUsedTime )
 {
-    commonInfoPtr_->lastUsedTime = lastUsedTime;
+    commonInfoPtr_->lastUsedTime = int64_t( lastUsedTime * 1000.0 );
+    commonInfoPtr_->used = 1;
+    ++commonInfoPtr_->useCount;
 }
 
 void CacheObject::resetLastUsed_( )
 {
-    updateLastUsed_( 0.0 );
+    commonInfoPtr_->lastUsedTime = 0;
+    commonInfoPtr_->used = 0;
+    commonInfoPtr_->useCount = 0;
 }
 
 void CacheObject::updateLastUsedWithCurrentTime_( )
@@ -70,17 +70,23 @@ public:
     LIVRECORE_API double getLastUsed() const;
 
     /**
-     * @return The last time object is loaded.
+     * @return The time in milliseconds spent in the last load of the object.
      */
     LIVRECORE_API double getLoadTime() const;
 
+    /**
+     * @return The number of uses since the object was loaded.
+     */
+    LIVRECORE_API uint32_t getUseCount() const;
+
     /**
      * @return The object is unloadable, where \see Cache cannot unload it.
      */
     LIVRECORE_API bool isUnloadable() const;
 
     /**
-     * @return The object is loaded in cache. The function is thread safe.
+     * @return The object is loaded in cache. The function is thread safe and
+     * does not lock, the lookup is counted in the statistics of the cache.
      */
     LIVRECORE_API bool isLoaded() const;
 
@@ -91,7 +97,20 @@ public:
     LIVRECORE_API void setUnloadable( bool unloadable );
 
     /**
-     * getReferenceCount_ Should not be called by user. The function is threadsafe.
+     * @return True if the object is temporarily protected from unloading.
+     */
+    LIVRECORE_API bool isPinned() const;
+
+    /**
+     * Protects the object temporarily from being unloaded by the \see Cache
+     * policies, e.g. while it is visible.
+     * @param pinned If true, the policies skip the object.
+     */
+    LIVRECORE_API void setPinned( bool pinned );
+
+    /**
+     * getReferenceCount_ Should not be called by user. The function is
+     * threadsafe, the count is atomic.
      * @return The number of references to CacheObject.
      */
     LIVRECORE_API uint32_t getReferenceCount_() const;
@@ -165,6 +184,15 @@ private:
     LIVRECORE_API void increaseReference_();
     LIVRECORE_API void decreaseReference_();
 
+    /** @return true if the object was used since the last call. */
+    bool testAndClearUsed_();
+
+    /** @return true if the object was used, without clearing it. */
+    bool isUsed_() const;
+
+    /** Sets the statistics counting the lookups, 0 for none. */
+    void setStatistics_( CacheStatistics* statistics );
+
     friend void intrusive_ptr_add_ref( CacheObject *object ) { object->increaseReference_(); }
     friend void intrusive_ptr_release( CacheObject *object ) { object->decreaseReference_(); }
 
@@ -174,6 +202,10 @@ private:
     struct CacheInfo;
     mutable boost::shared_ptr< CacheInfo > commonInfoPtr_;
 
+    // Intrusive hooks of the CLOCK ring of loaded objects, owned by Cache
+    CacheObject* clockPrev_;
+    CacheObject* clockNext_;
+
     LB_TS_VAR( thread_ );
 };
 
@@ -28,6 +28,8 @@ namespace livre
 
 /**
  * The CacheObjectObserver class help \see CacheObject to notify its actions.
+ * Only the load and unload transitions are notified, the frequent operations,
+ * e.g. referencing and lookups, are not.
  */
 class CacheObjectObserver
 {
@@ -46,30 +48,6 @@ protected:
      */
     virtual void onUnload_( const CacheObject& cacheObject LB_UNUSED ) { }
 
-    /**
-     * Notifies the CacheObserver on increase of reference count.
-     * @param cacheObject The CacheObject that notifies.
-     */
-    virtual void onReferenced_( const CacheObject& cacheObject LB_UNUSED ) { }
-
-    /**
-     * Notifies the CacheObserver on decrease of reference count.
-     * @param cacheObject The CacheObject that notifies.
-     */
-    virtual void onUnreferenced_( const CacheObject& cacheObject LB_UNUSED ) { }
-
-    /**
-     * Notifies the CacheObserver if object is in Cache
-     * @param cacheObject The CacheObject that notifies.
-     */
-    virtual void onCacheHit_( const CacheObject& cacheObject LB_UNUSED ) { }
-
-    /**
-     * Notifies notify the CacheObserver if object is not in Cache
-     * @param cacheObject The CacheObject that notifies.
-     */
-    virtual void onCacheMiss_( const CacheObject& cacheObject LB_UNUSED ) { }
-
     virtual ~CacheObjectObserver() {}
 };
 
@@ -64,6 +64,12 @@ protected:
                          const std::vector< CacheObject * >& cacheObjectList,
                          std::vector< CacheObject * >& modifiedObjectList ) = 0;
 
+    /**
+     * @return True if the objects are unloaded in least recently used order.
+     * The \see Cache then selects the objects with its CLOCK in constant time
+     * per object instead of calling apply_().
+     */
+    virtual bool isRecencyOrdered_() const { return false; }
 
 
 };
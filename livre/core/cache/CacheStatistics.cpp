@@ -22,122 +22,256 @@
 #include <livre/core/cache/CacheObject.h>
 #include <livre/core/util/ThreadClock.h>
 
+#include <lunchbox/scopedMutex.h>
+
+#include <sstream>
+
 namespace livre
 {
 
-struct CacheStatistics::LoadInfo
+namespace
 {
-    enum Operation
-    {
-        OP_LOAD,
-        OP_UNLOAD
-    };
-
-    LoadInfo( )
-        : op( OP_LOAD ),
-          cacheSize( 0 ),
-          cumulativeCacheSize( 0 ),
-          cumulativeNbNodes( 0 )
-    {
-        time = ThreadClock::getClock().getTimed();
-    }
+/** @return The bin of value in a histogram with power of two bins. */
+size_t _getBin( const double value, const size_t nBins )
+{
+    size_t bin = 0;
+    for( double limit = 2.0; value >= limit && bin + 1 < nBins; limit *= 2.0 )
+        ++bin;
+    return bin;
+}
 
-    LoadInfo(  const LoadInfo& previous,
-               Operation operation,
-               const size_t cSize,
-               const float lTime = 0.0f )
-        : op( operation ), cacheSize( cSize ), loadTime( lTime )
+std::string _escape( const std::string& string )
+{
+    std::string escaped;
+    BOOST_FOREACH( const char c, string )
     {
-        time = ThreadClock::getClock().getTimed();
-        switch( op )
-        {
-        case OP_LOAD:
-            cumulativeCacheSize = previous.cumulativeCacheSize + cacheSize;
-            cumulativeNbNodes = previous.cumulativeNbNodes + 1;
-            break;
-        case OP_UNLOAD:
-            cumulativeCacheSize = previous.cumulativeCacheSize - cacheSize;
-            cumulativeNbNodes = previous.cumulativeNbNodes - 1;
-            break;
-        }
+        if( c == '"' || c == '\\' )
+            escaped += '\\';
+        if( c >= 0 && c < ' ' )
+            continue;
+        escaped += c;
     }
+    return escaped;
+}
 
-    friend std::ostream& operator<<( std::ostream& stream, const LoadInfo& loadInfo )
-    {
-        stream << "Time: " << loadInfo.time
-               << " Cumulative Nodes: " << loadInfo.cumulativeNbNodes
-               << " Cumulative Size: " << loadInfo.cumulativeCacheSize;
-        return stream;
-    }
+void _writeHistogram( std::ostream& stream,
+                      const lunchbox::a_int64_t* histogram, const size_t nBins )
+{
+    stream << "[";
+    for( size_t i = 0; i < nBins; ++i )
+        stream << ( i > 0 ? ", " : "" ) << int64_t( histogram[ i ] );
+    stream << "]";
+}
+}
+
+struct CacheStatistics::ThreadCounters
+{
+    ThreadCounters()
+        : cacheHit( 0 ),
+          cacheMiss( 0 )
+    {}
 
-    Operation op;
-    double time;
-    size_t cacheSize;
-    size_t cumulativeCacheSize;
-    size_t cumulativeNbNodes;
-    double loadTime;
+    // Only written by the owning thread
+    lunchbox::a_ssize_t cacheHit;
+    lunchbox::a_ssize_t cacheMiss;
 };
 
 CacheStatistics::CacheStatistics( const std::string& statisticsName,
-                                  const size_t queueSize )
+                                  const size_t logSize )
     : statisticsName_( statisticsName )
     , usedMemoryInBytes_( 0 )
     , maxMemoryInBytes_( 0 )
     , blockCount_( 0 )
-    , cacheHit_( 0 )
-    , cacheMiss_( 0 )
-    , queueSize_( queueSize )
+    , unloadCount_( 0 )
+    , admissionCount_( 0 )
+    , rejectionCount_( 0 )
+    , reclaimCount_( 0 )
+    , unloadedLoadTime_( 0.0 )
+    , loadCount_( 0 )
+    , loadedBytes_( 0 )
+    , unloadedBytes_( 0 )
+    , ioLog_( std::max( logSize, size_t( 1 )))
+    , ioLogNext_( 0 )
+    , ioLogCount_( 0 )
 {
 }
 
 void CacheStatistics::onLoaded_( const CacheObject& cacheObject )
 {
-   ++blockCount_;
-   usedMemoryInBytes_ += cacheObject.getCacheSize();
+    const size_t cacheSize = cacheObject.getCacheSize();
+    ++blockCount_;
+    usedMemoryInBytes_ += cacheSize;
+    ++loadCount_;
+    loadedBytes_ += cacheSize;
 
-   if( ioQueue_.empty() )
-       ioQueue_.push( LoadInfoPtr( new LoadInfo()) );
+    // getLoadTime() is in milliseconds, the histogram in microseconds
+    ++loadTimeHistogram_[ _getBin( cacheObject.getLoadTime() * 1000.0,
+                                   LOAD_TIME_BINS ) ];
+    ++sizeHistogram_[ _getBin( double( cacheSize ), SIZE_BINS ) ];
 
-   if( ioQueue_.getSize() == queueSize_ )
-       ioQueue_.pop( );
-
-   LoadInfoPtr previous;
-   ioQueue_.getBack( previous );
-   ioQueue_.push( LoadInfoPtr( new LoadInfo( *previous, LoadInfo::OP_LOAD,
-                                             cacheObject.getCacheSize(),
-                                             cacheObject.getLoadTime( ))));
+    log_( LoadInfo::OP_LOAD, cacheObject );
 }
 
 void CacheStatistics::onUnload_( const CacheObject& cacheObject )
 {
+    const size_t cacheSize = cacheObject.getCacheSize();
     --blockCount_;
-    usedMemoryInBytes_ -= cacheObject.getCacheSize();
+    usedMemoryInBytes_ -= cacheSize;
+    ++unloadCount_;
+    unloadedBytes_ += cacheSize;
+
+    {
+        lunchbox::ScopedWrite mutex( ioLock_ );
+        unloadedLoadTime_ += cacheObject.getLoadTime();
+    }
+    log_( LoadInfo::OP_UNLOAD, cacheObject );
+}
+
+void CacheStatistics::log_( const LoadInfo::Operation operation,
+                            const CacheObject& cacheObject )
+{
+    LoadInfo loadInfo;
+    loadInfo.op = operation;
+    loadInfo.time = ThreadClock::getClock().getTimed();
+    loadInfo.cacheSize = cacheObject.getCacheSize();
+    loadInfo.cumulativeCacheSize = getUsedMemory();
+    loadInfo.cumulativeNbNodes = getBlockCount();
+    loadInfo.loadTime = operation == LoadInfo::OP_LOAD ?
+                            cacheObject.getLoadTime() : 0.0;
+
+    lunchbox::ScopedWrite mutex( ioLock_ );
+    ioLog_[ ioLogNext_ ] = loadInfo;
+    ioLogNext_ = ( ioLogNext_ + 1 ) % ioLog_.size();
+    ioLogCount_ = std::min( ioLogCount_ + 1, ioLog_.size( ));
+}
 
-    if( ioQueue_.getSize() == queueSize_ )
-        ioQueue_.pop( );
+double CacheStatistics::getUnloadedLoadTime() const
+{
+    lunchbox::ScopedWrite mutex( ioLock_ );
+    return unloadedLoadTime_;
+}
 
-    LoadInfoPtr previous;
-    ioQueue_.getBack( previous );
-    ioQueue_.push( LoadInfoPtr( new LoadInfo( *previous, LoadInfo::OP_UNLOAD,
-                                              cacheObject.getCacheSize( ))));
+size_t CacheStatistics::getCacheHits() const
+{
+    lunchbox::ScopedWrite mutex( countersLock_ );
+    size_t cacheHit = 0;
+    BOOST_FOREACH( const ThreadCountersPtr& counters, threadCounters_ )
+        cacheHit += counters->cacheHit;
+    return cacheHit;
+}
+
+size_t CacheStatistics::getCacheMisses() const
+{
+    lunchbox::ScopedWrite mutex( countersLock_ );
+    size_t cacheMiss = 0;
+    BOOST_FOREACH( const ThreadCountersPtr& counters, threadCounters_ )
+        cacheMiss += counters->cacheMiss;
+    return cacheMiss;
+}
+
+CacheStatistics::ThreadCounters& CacheStatistics::getThreadCounters_()
+{
+    ThreadCounters* counters = perThreadCounters_.get();
+    if( counters )
+        return *counters;
+
+    // The counters outlive their thread, they are kept for the sums
+    ThreadCountersPtr newCounters( new ThreadCounters );
+    {
+        lunchbox::ScopedWrite mutex( countersLock_ );
+        threadCounters_.push_back( newCounters );
+    }
+    perThreadCounters_ = newCounters.get();
+    return *newCounters;
+}
+
+void CacheStatistics::countLookup_( const bool hit )
+{
+    ThreadCounters& counters = getThreadCounters_();
+    if( hit )
+        ++counters.cacheHit;
+    else
+        ++counters.cacheMiss;
+}
+
+void CacheStatistics::countAdmission_( const bool admitted )
+{
+    if( admitted )
+        ++admissionCount_;
+    else
+        ++rejectionCount_;
+}
+
+std::string CacheStatistics::toJSON() const
+{
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"name\": \"" << _escape( statisticsName_ ) << "\",\n"
+         << "  \"policy\": \"" << _escape( policyName_ ) << "\",\n"
+         << "  \"usedMemory\": " << getUsedMemory() << ",\n"
+         << "  \"maxMemory\": " << size_t( maxMemoryInBytes_ ) << ",\n"
+         << "  \"blockCount\": " << getBlockCount() << ",\n"
+         << "  \"cacheHits\": " << getCacheHits() << ",\n"
+         << "  \"cacheMisses\": " << getCacheMisses() << ",\n"
+         << "  \"loads\": " << int64_t( loadCount_ ) << ",\n"
+         << "  \"loadedBytes\": " << int64_t( loadedBytes_ ) << ",\n"
+         << "  \"unloads\": " << getUnloadCount() << ",\n"
+         << "  \"unloadedBytes\": " << int64_t( unloadedBytes_ ) << ",\n"
+         << "  \"unloadedLoadTime\": " << getUnloadedLoadTime() << ",\n"
+         << "  \"admitted\": " << getAdmissionCount() << ",\n"
+         << "  \"rejected\": " << getRejectionCount() << ",\n"
+         << "  \"reclaimed\": " << getReclaimCount() << ",\n"
+         << "  \"loadTime\": ";
+    _writeHistogram( json, loadTimeHistogram_, LOAD_TIME_BINS );
+    json << ",\n  \"size\": ";
+    _writeHistogram( json, sizeHistogram_, SIZE_BINS );
+    json << ",\n  \"log\": [";
+
+    lunchbox::ScopedWrite mutex( ioLock_ );
+    const size_t first = ( ioLogNext_ + ioLog_.size() - ioLogCount_ ) %
+                         ioLog_.size();
+    for( size_t i = 0; i < ioLogCount_; ++i )
+    {
+        const LoadInfo& loadInfo = ioLog_[ ( first + i ) % ioLog_.size() ];
+        json << ( i > 0 ? "," : "" ) << "\n    { \"op\": \""
+             << ( loadInfo.op == LoadInfo::OP_LOAD ? "load" : "unload" )
+             << "\", \"time\": " << loadInfo.time
+             << ", \"size\": " << loadInfo.cacheSize
+             << ", \"usedMemory\": " << loadInfo.cumulativeCacheSize
+             << ", \"blockCount\": " << loadInfo.cumulativeNbNodes
+             << ", \"loadTime\": " << loadInfo.loadTime << " }";
+    }
+    json << ( ioLogCount_ > 0 ? "\n  ]\n}" : "]\n}" );
+    return json.str();
 }
 
 std::ostream& operator<<( std::ostream& stream, const CacheStatistics& cacheStatistics )
 {
-    const int hits = int(
-        100.f * float( cacheStatistics.cacheHit_ ) /
-        float( cacheStatistics.cacheHit_ + cacheStatistics.cacheMiss_ ));
+    const size_t cacheHit = cacheStatistics.getCacheHits();
+    const size_t cacheMiss = cacheStatistics.getCacheMisses();
+    const int hits = int( 100.f * float( cacheHit ) /
+                          float( cacheHit + cacheMiss ));
     stream << cacheStatistics.statisticsName_ << std::endl;
+    if( !cacheStatistics.policyName_.empty( ))
+        stream << "  Policy: " << cacheStatistics.policyName_ << std::endl;
     stream << "  Used Memory: "
-           << (cacheStatistics.usedMemoryInBytes_ + LB_1MB - 1) / LB_1MB << "/"
-           << (cacheStatistics.maxMemoryInBytes_ + LB_1MB - 1) / LB_1MB << "MB"
+           << (cacheStatistics.getUsedMemory() + LB_1MB - 1) / LB_1MB << "/"
+           << (cacheStatistics.getMaximumMemory() + LB_1MB - 1) / LB_1MB << "MB"
            << std::endl;
     stream << "  Block Count: "
-           << cacheStatistics.blockCount_ << std::endl;
+           << cacheStatistics.getBlockCount() << std::endl;
     stream << "  Cache hits: "
-           << cacheStatistics.cacheHit_ << " (" << hits << "%)" << std::endl;
+           << cacheHit << " (" << hits << "%)" << std::endl;
     stream << "  Cache misses: "
-           << cacheStatistics.cacheMiss_ << std::endl;
+           << cacheMiss << std::endl;
+    stream << "  Unloads: " << cacheStatistics.getUnloadCount() << " ("
+           << int( cacheStatistics.getUnloadedLoadTime( )) << "ms reload cost)"
+           << std::endl;
+    const size_t admitted = cacheStatistics.getAdmissionCount();
+    const size_t rejected = cacheStatistics.getRejectionCount();
+    if( admitted + rejected > 0 )
+        stream << "  Admission: " << admitted << " admitted, " << rejected
+               << " rejected" << std::endl;
 
     return stream;
 }
@@ -23,12 +23,18 @@
 
 #include <livre/core/api.h>
 #include <livre/core/cache/CacheObjectObserver.h>
-#include <lunchbox/mtQueue.h>
+#include <livre/core/lunchboxTypes.h>
+#include <lunchbox/perThread.h>
 
 namespace livre
 {
 /**
  * The CacheStatistics struct keeps the statistics of the \see Cache.
+ *
+ * The loads and unloads are observed, the lookups are counted by each thread
+ * on its own and summed up when they are queried. The memory footprint is
+ * fixed: the last loads and unloads are kept in a ring buffer, and the load
+ * times and object sizes are counted in histograms with power of two bins.
  */
 class CacheStatistics : public CacheObjectObserver
 {
@@ -49,9 +55,62 @@ public:
     void setStatisticsName( const std::string& statisticsName )
         { statisticsName_ = statisticsName; }
 
+    /** @return The name of the statistics. */
+    const std::string& getStatisticsName() const { return statisticsName_; }
+
     /** @param Maximum memory in bytes used by the associated cache. */
     void setMaximumMemory( const size_t maxMemoryInBytes )
-        { maxMemoryInBytes_ = maxMemoryInBytes; }
+        { maxMemoryInBytes_ = ssize_t( maxMemoryInBytes ); }
+
+    /** @return Maximum memory in bytes used by the associated cache. */
+    size_t getMaximumMemory() const { return size_t( maxMemoryInBytes_ ); }
+
+    /** @param policyName The name of the unloading policy of the cache. */
+    void setPolicyName( const std::string& policyName )
+        { policyName_ = policyName; }
+
+    /** @return Number of objects unloaded from the \see Cache. */
+    size_t getUnloadCount() const { return unloadCount_; }
+
+    /**
+     * @return The sum of the load times in milliseconds of the unloaded
+     * objects, i.e. the cost to load them again.
+     */
+    LIVRECORE_API double getUnloadedLoadTime() const;
+
+    /** @return Number of lookups of loaded objects, over all threads. */
+    LIVRECORE_API size_t getCacheHits() const;
+
+    /** @return Number of lookups of objects not loaded, over all threads. */
+    LIVRECORE_API size_t getCacheMisses() const;
+
+    /**
+     * @return Number of loaded objects allowed to displace a resident by the
+     * admission filter of the \see Cache.
+     */
+    size_t getAdmissionCount() const { return size_t( admissionCount_ ); }
+
+    /**
+     * @return Number of loaded objects put on probation by the admission
+     * filter of the \see Cache.
+     */
+    size_t getRejectionCount() const { return size_t( rejectionCount_ ); }
+
+    /**
+     * @return Number of unused objects removed from the \see Cache to bound
+     * the memory of their metadata.
+     */
+    size_t getReclaimCount() const { return size_t( reclaimCount_ ); }
+
+    /**
+     * Snapshot of the statistics for monitoring tools, a JSON object with the
+     * counters, the "loadTime" (microseconds) and "size" (bytes) histograms
+     * and the "log" of the last loads and unloads. Bin i of a histogram
+     * counts the values in [2^i, 2^(i+1)), bin 0 includes the values below 1
+     * and the last bin the values above.
+     * @return The statistics as a JSON string.
+     */
+    LIVRECORE_API std::string toJSON() const;
 
     /**
      * @param stream Output stream.
@@ -66,29 +125,79 @@ public:
 private:
 
     friend class Cache;
+    friend class CacheObject;
 
     CacheStatistics( const std::string& statisticsName,
-                     const size_t queueSize );
+                     const size_t logSize );
 
     void onLoaded_( const CacheObject& cacheObject ) final;
     void onUnload_( const CacheObject& cacheObject ) final;
 
-    void onCacheMiss_( const CacheObject& ) final { ++cacheMiss_; }
-    void onCacheHit_( const CacheObject& ) final { ++cacheHit_; }
+    /** Counts a lookup in the counters of the calling thread. */
+    void countLookup_( bool hit );
+
+    /** Counts a decision of the admission filter. */
+    void countAdmission_( bool admitted );
+
+    /** Counts the objects removed from the cache. */
+    void countReclaim_( size_t count ) { reclaimCount_ += ssize_t( count ); }
+
+    struct ThreadCounters;
+    typedef boost::shared_ptr< ThreadCounters > ThreadCountersPtr;
+    typedef lunchbox::PerThread< ThreadCounters,
+        lunchbox::perThreadNoDelete< ThreadCounters > > PerThreadCounters;
+
+    ThreadCounters& getThreadCounters_();
 
     std::string statisticsName_;
-    size_t usedMemoryInBytes_;
-    size_t maxMemoryInBytes_;
-    size_t blockCount_;
-    size_t cacheHit_;
-    size_t cacheMiss_;
-
-    struct LoadInfo;
-    typedef boost::shared_ptr< LoadInfo > LoadInfoPtr;
-    typedef lunchbox::MTQueue< LoadInfoPtr > LoadInfoPtrQueue;
-
-    LoadInfoPtrQueue ioQueue_;
-    const size_t queueSize_;
+    std::string policyName_;
+    lunchbox::a_ssize_t usedMemoryInBytes_;
+    lunchbox::a_ssize_t maxMemoryInBytes_; //!< Changed by CacheBudgetManager
+    lunchbox::a_ssize_t blockCount_;
+    lunchbox::a_ssize_t unloadCount_;
+    lunchbox::a_ssize_t admissionCount_;
+    lunchbox::a_ssize_t rejectionCount_;
+    lunchbox::a_ssize_t reclaimCount_;
+    double unloadedLoadTime_;
+
+    mutable lunchbox::Lock countersLock_;
+    std::vector< ThreadCountersPtr > threadCounters_; //!< Of all threads
+    PerThreadCounters perThreadCounters_;
+
+    enum
+    {
+        LOAD_TIME_BINS = 24, //!< Up to 8s
+        SIZE_BINS = 40 //!< Up to 512GB
+    };
+
+    struct LoadInfo
+    {
+        enum Operation
+        {
+            OP_LOAD,
+            OP_UNLOAD
+        };
+
+        Operation op;
+        double time;
+        size_t cacheSize;
+        size_t cumulativeCacheSize;
+        size_t cumulativeNbNodes;
+        double loadTime;
+    };
+
+    void log_( LoadInfo::Operation operation, const CacheObject& cacheObject );
+
+    lunchbox::a_int64_t loadCount_;
+    lunchbox::a_int64_t loadedBytes_;
+    lunchbox::a_int64_t unloadedBytes_;
+    lunchbox::a_int64_t loadTimeHistogram_[ LOAD_TIME_BINS ];
+    lunchbox::a_int64_t sizeHistogram_[ SIZE_BINS ];
+
+    mutable lunchbox::Lock ioLock_; //!< Serializes loads and unloads
+    std::vector< LoadInfo > ioLog_; //!< Ring buffer of the last operations
+    size_t ioLogNext_; //!< Position of the next operation in ioLog_
+    size_t ioLogCount_; //!< Number of operations in ioLog_
 };
 
 }
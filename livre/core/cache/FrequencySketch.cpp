@@ -0,0 +1,125 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/cache/FrequencySketch.h>
+
+#include <algorithm>
+
+namespace livre
+{
+
+namespace
+{
+const uint64_t SEEDS[] = { 0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull,
+                           0x9ae16a3b2f90404full, 0xcbf29ce484222325ull };
+const uint64_t COUNTER_MASK = 0xf;
+const uint64_t HALVE_MASK = 0x7777777777777777ull;
+
+uint64_t _hash( const uint64_t value )
+{
+    // splitmix64 finalizer, the node ids are far from random
+    uint64_t hash = value;
+    hash = ( hash ^ ( hash >> 30 )) * 0xbf58476d1ce4e5b9ull;
+    hash = ( hash ^ ( hash >> 27 )) * 0x94d049bb133111ebull;
+    return hash ^ ( hash >> 31 );
+}
+}
+
+FrequencySketch::FrequencySketch( const size_t capacity )
+    : width_( COUNTERS_PER_WORD )
+    , sampleSize_( 10 * std::max( capacity, size_t( 1 )))
+    , additions_( 0 )
+{
+    while( width_ < capacity )
+        width_ <<= 1;
+
+    const size_t nWords = DEPTH * width_ / COUNTERS_PER_WORD;
+    table_.reset( new lunchbox::a_uint64_t[ nWords ] );
+}
+
+FrequencySketch::~FrequencySketch()
+{
+}
+
+size_t FrequencySketch::getCounter_( const CacheId cacheId,
+                                     const size_t row ) const
+{
+    const size_t column = _hash( cacheId ^ SEEDS[ row ] ) & ( width_ - 1 );
+    return row * width_ + column;
+}
+
+void FrequencySketch::increment( const CacheId cacheId )
+{
+    for( size_t row = 0; row < DEPTH; ++row )
+    {
+        const size_t counter = getCounter_( cacheId, row );
+        lunchbox::a_uint64_t& word = table_[ counter / COUNTERS_PER_WORD ];
+        const size_t shift = ( counter % COUNTERS_PER_WORD ) * 4;
+
+        for( ;; )
+        {
+            const uint64_t value = word;
+            if((( value >> shift ) & COUNTER_MASK ) == COUNTER_MASK ||
+               word.compareAndSwap( value, value + ( 1ull << shift )))
+            {
+                break;
+            }
+        }
+    }
+
+    // Only the thread completing the sample ages the counters
+    if( ++additions_ == ssize_t( sampleSize_ ))
+    {
+        age_();
+        additions_ -= sampleSize_ / 2;
+    }
+}
+
+uint32_t FrequencySketch::estimate( const CacheId cacheId ) const
+{
+    uint32_t frequency = COUNTER_MASK;
+    for( size_t row = 0; row < DEPTH; ++row )
+    {
+        const size_t counter = getCounter_( cacheId, row );
+        const uint64_t value = table_[ counter / COUNTERS_PER_WORD ];
+        const size_t shift = ( counter % COUNTERS_PER_WORD ) * 4;
+        frequency = std::min( frequency,
+                              uint32_t(( value >> shift ) & COUNTER_MASK ));
+    }
+    return frequency;
+}
+
+void FrequencySketch::age_()
+{
+    const size_t nWords = DEPTH * width_ / COUNTERS_PER_WORD;
+    for( size_t i = 0; i < nWords; ++i )
+    {
+        for( ;; )
+        {
+            const uint64_t value = table_[ i ];
+            if( table_[ i ].compareAndSwap( value,
+                                            ( value >> 1 ) & HALVE_MASK ))
+            {
+                break;
+            }
+        }
+    }
+}
+
+}
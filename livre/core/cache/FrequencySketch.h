@@ -0,0 +1,79 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _FrequencySketch_h_
+#define _FrequencySketch_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+#include <livre/core/lunchboxTypes.h>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+
+namespace livre
+{
+
+/**
+ * The FrequencySketch class estimates how often the cache ids are requested,
+ * in a fixed footprint of half a byte per counter. It is a count-min sketch
+ * with four rows of 4 bit counters, so the estimates saturate at 15.
+ *
+ * All counters are halved after a sample of ten times the capacity requests,
+ * so the estimates follow the recent history of the requests.
+ *
+ * All methods are thread safe and lock free.
+ */
+class FrequencySketch : public boost::noncopyable
+{
+public:
+    /**
+     * @param capacity The number of objects whose frequency is to be
+     *        told apart, usually the number of objects fitting in the cache.
+     */
+    LIVRECORE_API explicit FrequencySketch( size_t capacity );
+    LIVRECORE_API ~FrequencySketch();
+
+    /** Counts a request of the given id. */
+    LIVRECORE_API void increment( CacheId cacheId );
+
+    /** @return the estimated number of recent requests of the given id. */
+    LIVRECORE_API uint32_t estimate( CacheId cacheId ) const;
+
+    /** @return the number of requests after which the counters are halved. */
+    size_t getSampleSize() const { return sampleSize_; }
+
+private:
+    enum
+    {
+        DEPTH = 4, //!< Number of rows
+        COUNTERS_PER_WORD = 16
+    };
+
+    size_t getCounter_( CacheId cacheId, size_t row ) const;
+    void age_();
+
+    size_t width_; //!< Number of counters per row, a power of two
+    size_t sampleSize_;
+    boost::scoped_array< lunchbox::a_uint64_t > table_;
+    lunchbox::a_ssize_t additions_;
+};
+
+}
+
+#endif // _FrequencySketch_h_
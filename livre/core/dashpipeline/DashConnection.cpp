@@ -66,4 +66,9 @@ void DashConnection::setDestinationContext( DashContextPtr contextPtr )
     destinationContextPtr_= contextPtr;
 }
 
+size_t DashConnection::getPendingCommits() const
+{
+    return queue_.getSize();
+}
+
 }
@@ -53,6 +53,11 @@ public:
      */
     LIVRECORE_API void setDestinationContext( DashContextPtr contextPtr );
 
+    /**
+     * @return The number of commits pushed but not popped yet.
+     */
+    LIVRECORE_API size_t getPendingCommits( ) const;
+
 private:
     DashContextPtr sourceContextPtr_;
 
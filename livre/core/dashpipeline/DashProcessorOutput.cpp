@@ -85,4 +85,12 @@ CommitState DashProcessorOutput::commit_( const uint32_t outputConnection )
     return ret;
 }
 
+size_t DashProcessorOutput::getPendingCommits_(
+    const uint32_t outputConnection ) const
+{
+    DashConnectionPtrMap::const_iterator it =
+        connectionMap_.find( outputConnection );
+    return it == connectionMap_.end() ? 0 : it->second->getPendingCommits();
+}
+
 }
@@ -64,6 +64,7 @@ public:
 
 private:
     virtual CommitState commit_( const uint32_t outputConnection );
+    virtual size_t getPendingCommits_( const uint32_t outputConnection ) const;
 
     DashConnectionPtrMap connectionMap_;
     lunchbox::Lock connectionMapModificationLock_;
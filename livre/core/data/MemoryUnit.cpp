@@ -18,10 +18,20 @@
  */
 
 #include <livre/core/data/MemoryUnit.h>
+#include <livre/core/data/SlabAllocator.h>
+
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
 
 namespace livre
 {
 
+namespace
+{
+lunchbox::Lock _slabAllocatorLock;
+SlabAllocatorPtr _slabAllocator;
+}
+
 MemoryUnit::MemoryUnit()
 {}
 
@@ -47,37 +57,86 @@ const uint8_t* ConstMemoryUnit::getData_() const
 
 
 AllocMemoryUnit::AllocMemoryUnit()
+    : _slabData( 0 )
+    , _slabDataSize( 0 )
 {}
 
+AllocMemoryUnit::~AllocMemoryUnit()
+{
+    release();
+}
+
+void AllocMemoryUnit::setSlabAllocator( SlabAllocatorPtr allocator )
+{
+    lunchbox::ScopedWrite mutex( _slabAllocatorLock );
+    _slabAllocator = allocator;
+}
+
+SlabAllocatorPtr AllocMemoryUnit::getSlabAllocator()
+{
+    lunchbox::ScopedWrite mutex( _slabAllocatorLock );
+    return _slabAllocator;
+}
+
 size_t AllocMemoryUnit::getMemSize() const
 {
-    return _rawData.getSize();
+    return _slabData ? _slabDataSize : _rawData.getSize();
 }
 
 size_t AllocMemoryUnit::getAllocSize() const
 {
-    return _rawData.getMaxSize();
+    return _slabData ? _slabAllocator->getSlotSize() : _rawData.getMaxSize();
 }
 
 void AllocMemoryUnit::alloc( const size_t nBytes )
 {
     LB_TS_THREAD( thread_ );
+    if( _slabData && nBytes <= _slabAllocator->getSlotSize() &&
+        nBytes >= _slabAllocator->getMinimumSize( ))
+    {
+        _slabDataSize = nBytes;
+        return;
+    }
+    releaseSlot_();
+
+    SlabAllocatorPtr allocator = getSlabAllocator();
+    uint8_t* slot = allocator ? allocator->allocate( nBytes ) : 0;
+    if( slot )
+    {
+        _rawData.clear();
+        _slabAllocator = allocator;
+        _slabData = slot;
+        _slabDataSize = nBytes;
+        return;
+    }
     _rawData.reset( nBytes );
 }
 
 void AllocMemoryUnit::release()
 {
+    releaseSlot_();
     _rawData.clear();
 }
 
+void AllocMemoryUnit::releaseSlot_()
+{
+    if( !_slabData )
+        return;
+
+    _slabAllocator->deallocate( _slabData );
+    _slabAllocator.reset();
+    _slabData = 0;
+    _slabDataSize = 0;
+}
+
 const uint8_t* AllocMemoryUnit::getData_() const
 {
-    return _rawData.getData();
+    return _slabData ? _slabData : _rawData.getData();
 }
 
 uint8_t* AllocMemoryUnit::getData_()
 {
-    return _rawData.getData();
+    return _slabData ? _slabData : _rawData.getData();
 }
 
 }
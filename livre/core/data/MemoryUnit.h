@@ -102,11 +102,24 @@ protected:
 
 /**
  * The AllocMemoryUnit class shows an allocated memory pointer to keep track of memory consumption.
+ * The memory is taken from the slab allocator set with setSlabAllocator(), if it has a free slot
+ * and the size is within its minimum and slot sizes, and from the heap otherwise.
  */
 class AllocMemoryUnit : public MemoryUnit, public boost::noncopyable
 {
 public:
     LIVRECORE_API AllocMemoryUnit();
+    LIVRECORE_API ~AllocMemoryUnit();
+
+    /**
+     * Set the slab allocator used by the allocations of all AllocMemoryUnits, or unset it with an
+     * empty pointer. The units keep the allocator alive until they release their slot.
+     * @param allocator The slab allocator.
+     */
+    LIVRECORE_API static void setSlabAllocator( SlabAllocatorPtr allocator );
+
+    /** @return the slab allocator used by the allocations, may be empty. */
+    LIVRECORE_API static SlabAllocatorPtr getSlabAllocator();
 
     /**
      * Allocate and copy the data from the given source and size
@@ -117,7 +130,7 @@ public:
     void allocAndSetData( const T* sourceData, const size_t size )
     {
         alloc( sizeof( T ) * size );
-        ::memcpy( _rawData.getData(), sourceData, size * sizeof( T ) );
+        ::memcpy( getData_(), sourceData, size * sizeof( T ) );
     }
 
     /**
@@ -145,9 +158,13 @@ public:
 private:
     const uint8_t* getData_() const final;
     uint8_t* getData_() final;
+    void releaseSlot_();
 
     LB_TS_VAR( thread_ );
     lunchbox::Bufferb _rawData;
+    SlabAllocatorPtr _slabAllocator; //!< Set while a slab slot is used
+    uint8_t* _slabData;
+    size_t _slabDataSize;
 };
 
 }
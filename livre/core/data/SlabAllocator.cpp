@@ -0,0 +1,220 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/data/SlabAllocator.h>
+
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <cerrno>
+#include <cstring>
+#ifndef _WIN32
+#  include <sys/mman.h>
+#endif
+
+namespace livre
+{
+
+namespace
+{
+const size_t PAGE_SIZE = 4096;
+const size_t HUGE_PAGE_SIZE = 2 * LB_1MB;
+
+size_t _roundUp( const size_t size, const size_t alignment )
+{
+    return ( size + alignment - 1 ) / alignment * alignment;
+}
+}
+
+namespace detail
+{
+
+class SlabAllocator
+{
+public:
+    SlabAllocator( const size_t slotSize, const size_t slotCount,
+                   const uint32_t flags, const size_t minSize )
+        : _slotSize( _roundUp( std::max( slotSize, size_t( 1 )), PAGE_SIZE ))
+        , _minSize( minSize )
+        , _slotCount( slotCount )
+        , _size( _roundUp( _slotSize * slotCount, HUGE_PAGE_SIZE ))
+        , _data( 0 )
+        , _hugePages( false )
+    {
+        if( _slotCount == 0 )
+            LBTHROW( std::runtime_error( "Slab allocator needs slots" ));
+
+        _map( flags );
+        _freeSlots.reserve( _slotCount );
+        for( size_t i = _slotCount; i > 0; --i )
+            _freeSlots.push_back( _data + ( i - 1 ) * _slotSize );
+
+        LBINFO << "Slab allocator reserved " << _slotCount << " slots of "
+               << _slotSize << " bytes, " << _size / LB_1MB << " MB"
+               << ( _hugePages ? " in huge pages" : "" ) << std::endl;
+    }
+
+    ~SlabAllocator()
+    {
+        if( _freeSlots.size() != _slotCount )
+            LBWARN << _slotCount - _freeSlots.size() << " slab allocator "
+                   << "slots are still in use" << std::endl;
+#ifdef _WIN32
+        delete [] _data;
+#else
+        ::munmap( _data, _size );
+#endif
+    }
+
+    uint8_t* allocate( const size_t size )
+    {
+        if( size > _slotSize || size < _minSize )
+            return 0;
+
+        lunchbox::ScopedWrite mutex( _lock );
+        if( _freeSlots.empty( ))
+            return 0;
+        uint8_t* slot = _freeSlots.back();
+        _freeSlots.pop_back();
+        return slot;
+    }
+
+    void deallocate( uint8_t* ptr )
+    {
+        LBASSERT( ptr >= _data && ptr < _data + _slotSize * _slotCount );
+        LBASSERT( size_t( ptr - _data ) % _slotSize == 0 );
+
+        lunchbox::ScopedWrite mutex( _lock );
+        _freeSlots.push_back( ptr );
+    }
+
+    size_t getSlotSize() const { return _slotSize; }
+    size_t getMinimumSize() const { return _minSize; }
+    size_t getSlotCount() const { return _slotCount; }
+
+    size_t getUsedSlotCount() const
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        return _slotCount - _freeSlots.size();
+    }
+
+    bool hasHugePages() const { return _hugePages; }
+
+private:
+#ifdef _WIN32
+    void _map( const uint32_t )
+    {
+        _data = new uint8_t[ _size ];
+    }
+#else
+    void _map( const uint32_t flags )
+    {
+        int mapFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+        if( flags & livre::SlabAllocator::SLAB_POPULATE )
+            mapFlags |= MAP_POPULATE;
+#endif
+
+#ifdef MAP_HUGETLB
+        // reserved huge pages first, they fail if not configured in the system
+        if( flags & livre::SlabAllocator::SLAB_HUGE_PAGES )
+        {
+            void* data = ::mmap( 0, _size, PROT_READ | PROT_WRITE,
+                                 mapFlags | MAP_HUGETLB, -1, 0 );
+            if( data != MAP_FAILED )
+            {
+                _data = static_cast< uint8_t* >( data );
+                _hugePages = true;
+                return;
+            }
+        }
+#endif
+
+        void* data = ::mmap( 0, _size, PROT_READ | PROT_WRITE, mapFlags, -1, 0 );
+        if( data == MAP_FAILED )
+            LBTHROW( std::runtime_error( "Cannot map slab allocator memory: " +
+                                         std::string( ::strerror( errno ))));
+        _data = static_cast< uint8_t* >( data );
+
+#ifdef MADV_HUGEPAGE
+        if( flags & livre::SlabAllocator::SLAB_HUGE_PAGES )
+            _hugePages = ::madvise( _data, _size, MADV_HUGEPAGE ) == 0;
+#endif
+    }
+#endif
+
+    const size_t _slotSize;
+    const size_t _minSize;
+    const size_t _slotCount;
+    const size_t _size;
+    uint8_t* _data;
+    bool _hugePages;
+    std::vector< uint8_t* > _freeSlots;
+    mutable lunchbox::Lock _lock;
+};
+
+}
+
+SlabAllocator::SlabAllocator( const size_t slotSize, const size_t slotCount,
+                              const uint32_t flags, const size_t minSize )
+    : _impl( new detail::SlabAllocator( slotSize, slotCount, flags, minSize ))
+{
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    delete _impl;
+}
+
+uint8_t* SlabAllocator::allocate( const size_t size )
+{
+    return _impl->allocate( size );
+}
+
+void SlabAllocator::deallocate( uint8_t* ptr )
+{
+    _impl->deallocate( ptr );
+}
+
+size_t SlabAllocator::getSlotSize() const
+{
+    return _impl->getSlotSize();
+}
+
+size_t SlabAllocator::getMinimumSize() const
+{
+    return _impl->getMinimumSize();
+}
+
+size_t SlabAllocator::getSlotCount() const
+{
+    return _impl->getSlotCount();
+}
+
+size_t SlabAllocator::getUsedSlotCount() const
+{
+    return _impl->getUsedSlotCount();
+}
+
+bool SlabAllocator::hasHugePages() const
+{
+    return _impl->hasHugePages();
+}
+
+}
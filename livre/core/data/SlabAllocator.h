@@ -0,0 +1,108 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _SlabAllocator_h_
+#define _SlabAllocator_h_
+
+#include <livre/core/api.h>
+#include <livre/core/types.h>
+#include <boost/noncopyable.hpp>
+
+namespace livre
+{
+
+namespace detail
+{
+    class SlabAllocator;
+}
+
+/**
+ * The SlabAllocator class hands out fixed size slots of one memory mapping,
+ * reserved once for the whole cache budget. Bricks of a volume almost always
+ * have the same size, so their buffers are recycled without going through the
+ * heap, which avoids its fragmentation over long sessions.
+ *
+ * The mapping can be backed by huge pages, using MAP_HUGETLB if huge pages are
+ * reserved in the system, and transparent huge pages otherwise. It can also be
+ * populated up front, so the whole budget is resident from the start. Without
+ * mmap, on Windows, the slots are taken from one heap allocation.
+ *
+ * Allocations smaller than the minimum size are refused, so the slots are only
+ * used by brick-sized buffers and not wasted on small ones.
+ *
+ * All methods are thread safe.
+ */
+class SlabAllocator : public boost::noncopyable
+{
+public:
+    /** The backing of the mapping */
+    enum Flags
+    {
+        SLAB_DEFAULT = 0,
+        SLAB_HUGE_PAGES = 1 << 0, //!< Back the slots with huge pages
+        SLAB_POPULATE = 1 << 1 //!< Fault in the whole mapping on creation
+    };
+
+    /**
+     * @param slotSize The size of a slot in bytes, rounded up to a page.
+     * @param slotCount The number of slots.
+     * @param flags The backing of the mapping, a combination of Flags.
+     * @param minSize The size of the smallest allocation served by a slot.
+     * @throw std::runtime_error if the memory cannot be mapped.
+     */
+    LIVRECORE_API SlabAllocator( size_t slotSize, size_t slotCount,
+                                 uint32_t flags = SLAB_DEFAULT,
+                                 size_t minSize = 0 );
+    LIVRECORE_API ~SlabAllocator();
+
+    /**
+     * @param size The number of bytes to allocate.
+     * @return a free slot, or 0 if size exceeds the slot size, is below the
+     *         minimum size or all slots are in use.
+     */
+    LIVRECORE_API uint8_t* allocate( size_t size );
+
+    /**
+     * Return a slot to the allocator.
+     * @param ptr A slot returned by allocate().
+     */
+    LIVRECORE_API void deallocate( uint8_t* ptr );
+
+    /** @return the size of a slot in bytes. */
+    LIVRECORE_API size_t getSlotSize() const;
+
+    /** @return the size of the smallest allocation served by a slot. */
+    LIVRECORE_API size_t getMinimumSize() const;
+
+    /** @return the number of slots. */
+    LIVRECORE_API size_t getSlotCount() const;
+
+    /** @return the number of slots in use. */
+    LIVRECORE_API size_t getUsedSlotCount() const;
+
+    /** @return true if the mapping is backed by huge pages. */
+    LIVRECORE_API bool hasHugePages() const;
+
+private:
+    detail::SlabAllocator* _impl;
+};
+
+}
+
+#endif // _SlabAllocator_h_
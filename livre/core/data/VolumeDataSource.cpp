@@ -27,7 +27,11 @@
 #include <livre/core/data/LODNode.h>
 #include <livre/core/version.h>
 
+#include <lunchbox/lock.h>
 #include <lunchbox/pluginFactory.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <boost/unordered_map.hpp>
 
 namespace livre
 {
@@ -41,6 +45,9 @@ namespace detail
 class VolumeDataSource
 {
 public:
+    typedef std::shared_future< MemoryUnitPtr > ReadAheadFuture;
+    typedef boost::unordered_map< uint64_t, ReadAheadFuture > ReadAheadMap;
+
     typedef lunchbox::PluginFactory< VolumeDataSourcePlugin,
                                      VolumeDataSourcePluginData >
                 PluginFactory;
@@ -49,6 +56,7 @@ public:
                       const AccessMode accessMode )
         : plugin( PluginFactory::getInstance().create(
                       VolumeDataSourcePluginData( uri, accessMode )))
+        , lock( plugin->isThreadSafe() ? 0 : new lunchbox::Lock )
     {}
 
     ConstLODNodePtr getNode( const NodeId nodeId ) const
@@ -56,17 +64,84 @@ public:
         return plugin->getNode( nodeId );
     }
 
-    MemoryUnitPtr getData( const LODNode& node )
+    MemoryUnitPtr getData( const LODNode& node ) const
     {
+        ReadAheadFuture future;
+        if( takeReadAhead( node.getNodeId(), future ))
+            return future.get();
+
+        lunchbox::ScopedWrite mutex( lock.get( ));
         return plugin->getData( node );
     }
 
-    ConstMemoryUnitPtr getData( const LODNode& node ) const
+    MemoryUnitFutures getDataAsync( const LODNodes& nodes )
     {
-        return plugin->getData( node );
+        MemoryUnitFutures futures = plugin->getDataAsync( nodes );
+        if( !lock )
+            return futures;
+
+        // the futures may call getData() of the plugin when waited for
+        lunchbox::Lock* mutex = lock.get();
+        MemoryUnitFutures serialized;
+        serialized.reserve( futures.size( ));
+        BOOST_FOREACH( MemoryUnitFuture& future, futures )
+        {
+            const ReadAheadFuture shared = future.share();
+            serialized.push_back( std::async( std::launch::deferred,
+                [ shared, mutex ]() -> MemoryUnitPtr
+                {
+                    lunchbox::ScopedWrite scoped( mutex );
+                    return shared.get();
+                }));
+        }
+        return serialized;
+    }
+
+    void readAhead( const LODNodes& nodes )
+    {
+        if( !plugin->hasAsyncReads( ))
+            return;
+
+        lunchbox::ScopedWrite mutex( readAheadLock );
+        LODNodes newNodes;
+        BOOST_FOREACH( const LODNode& node, nodes )
+        {
+            if( !readAheads.count( node.getNodeId().getId( )))
+                newNodes.push_back( node );
+        }
+        if( newNodes.empty( ))
+            return;
+
+        MemoryUnitFutures futures = getDataAsync( newNodes );
+        for( size_t i = 0; i < newNodes.size(); ++i )
+            readAheads[ newNodes[i].getNodeId().getId() ] = futures[i].share();
+    }
+
+    void cancelReadAhead( const NodeId nodeId )
+    {
+        lunchbox::ScopedWrite mutex( readAheadLock );
+        readAheads.erase( nodeId.getId( ));
+    }
+
+    bool takeReadAhead( const NodeId nodeId, ReadAheadFuture& future ) const
+    {
+        lunchbox::ScopedWrite mutex( readAheadLock );
+        ReadAheadMap::iterator i = readAheads.find( nodeId.getId( ));
+        if( i == readAheads.end( ))
+            return false;
+        future = i->second;
+        readAheads.erase( i );
+        return true;
     }
 
     boost::scoped_ptr< VolumeDataSourcePlugin > plugin;
+
+    // serializes getData() unless the plugin is thread safe
+    boost::scoped_ptr< lunchbox::Lock > lock;
+
+    // the reads started by readAhead() and not taken by getData() yet
+    mutable lunchbox::Lock readAheadLock;
+    mutable ReadAheadMap readAheads;
 };
 
 }
@@ -120,6 +195,21 @@ ConstMemoryUnitPtr VolumeDataSource::getData( const LODNode& node ) const
     return _impl->getData( node );
 }
 
+MemoryUnitFutures VolumeDataSource::getDataAsync( const LODNodes& nodes )
+{
+    return _impl->getDataAsync( nodes );
+}
+
+void VolumeDataSource::readAhead( const LODNodes& nodes )
+{
+    _impl->readAhead( nodes );
+}
+
+void VolumeDataSource::cancelReadAhead( const NodeId nodeId )
+{
+    _impl->cancelReadAhead( nodeId );
+}
+
 livre::VolumeDataSource::~VolumeDataSource()
 {
     delete _impl;
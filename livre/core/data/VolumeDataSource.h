@@ -73,6 +73,24 @@ public:
     /** @copydoc getData( const LODNode& node ) */
     LIVRECORE_API ConstMemoryUnitPtr getData( const LODNode& node ) const;
 
+    /** @copydoc VolumeDataSourcePlugin::getDataAsync() */
+    LIVRECORE_API MemoryUnitFutures getDataAsync( const LODNodes& nodes );
+
+    /**
+     * Start reading the data of nodes with getDataAsync(). A later getData()
+     * for one of the nodes returns the data read ahead. The nodes already read
+     * ahead are skipped, and nothing is read ahead if the plugin has no
+     * asynchronous reads, \see VolumeDataSourcePlugin::hasAsyncReads().
+     * @param nodes LODNodes to be read.
+     */
+    LIVRECORE_API void readAhead( const LODNodes& nodes );
+
+    /**
+     * Drop the data read ahead for a node, unless getData() has taken it.
+     * @param nodeId The node id of the node.
+     */
+    LIVRECORE_API void cancelReadAhead( const NodeId nodeId );
+
     /**
      * @param nodeId The nodeId to get the node for.
      * @return The LODNode for the ID or 0 if not found.
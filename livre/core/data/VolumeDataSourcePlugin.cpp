@@ -28,15 +28,32 @@ VolumeDataSourcePlugin::VolumeDataSourcePlugin()
 
 ConstLODNodePtr VolumeDataSourcePlugin::getNode( const NodeId nodeId ) const
 {
-    NodeIDLODNodePtrMap::iterator it = _lodNodeMap.find( nodeId );
-    if( it == _lodNodeMap.end( ) || !it->second )
     {
-        LODNodePtr lodNodePtr( new LODNode( ));
+        ReadLock readLock( _lodNodeMutex );
+        NodeIDLODNodePtrMap::const_iterator it = _lodNodeMap.find( nodeId );
+        if( it != _lodNodeMap.end( ) && it->second )
+            return it->second;
+    }
+
+    WriteLock writeLock( _lodNodeMutex );
+    LODNodePtr& lodNodePtr = _lodNodeMap[ nodeId ];
+    if( !lodNodePtr )
+    {
+        lodNodePtr.reset( new LODNode( ));
         internalNodeToLODNode( nodeId, *lodNodePtr );
-        _lodNodeMap[ nodeId ] = lodNodePtr;
     }
+    return lodNodePtr;
+}
 
-    return _lodNodeMap[ nodeId ];
+MemoryUnitFutures VolumeDataSourcePlugin::getDataAsync( const LODNodes& nodes )
+{
+    MemoryUnitFutures futures;
+    futures.reserve( nodes.size( ));
+    BOOST_FOREACH( const LODNode& node, nodes )
+        futures.push_back( std::async( std::launch::deferred,
+                                       [ this, node ]()
+                                       { return getData( node ); }));
+    return futures;
 }
 
 const VolumeInformation& VolumeDataSourcePlugin::getVolumeInformation() const
@@ -84,6 +84,31 @@ public:
      */
     virtual MemoryUnitPtr getData( const LODNode& node ) = 0;
 
+    /**
+     * @return true if getData() may be called from several threads at once.
+     *         VolumeDataSource serializes the calls of the other plugins.
+     */
+    virtual bool isThreadSafe() const { return false; }
+
+    /**
+     * Read the data for a batch of nodes asynchronously.
+     *
+     * Plugins which can overlap, reorder or coalesce reads should override
+     * this method. The default implementation starts no read: the first get()
+     * of a future calls getData() on the waiting thread. The returned futures
+     * must not outlive the plugin.
+     *
+     * @param nodes LODNodes to be read.
+     * @return One future per node, in the order of the given nodes.
+     */
+    LIVRECORE_API virtual MemoryUnitFutures getDataAsync( const LODNodes& nodes );
+
+    /**
+     * @return true if getDataAsync() reads in the background. Reading ahead
+     *         is skipped for the other plugins, which would only read on get().
+     */
+    virtual bool hasAsyncReads() const { return false; }
+
     /**
      * Converts internal node to lod node.
      * @param internalNode Internal node.
@@ -114,6 +139,7 @@ protected:
     LODNodePtr _getNodeFromNodeID( uint32_t nodeId );
 
     mutable NodeIDLODNodePtrMap _lodNodeMap;
+    mutable ReadWriteMutex _lodNodeMutex; //!< Protects _lodNodeMap
     VolumeInformation _volumeInfo;
 };
 
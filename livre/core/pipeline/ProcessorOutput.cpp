@@ -25,6 +25,10 @@ namespace livre
 
 ProcessorOutput::ProcessorOutput( Processor& processor )
     : processor_( processor )
+    , maxBatchedChanges_( 1 )
+    , maxBatchLatency_( 0.f )
+    , maxPendingCommits_( 0 )
+    , batchedChanges_( 0 )
 {
 
 }
@@ -41,12 +45,55 @@ CommitState ProcessorOutput::commit( const uint32_t outputConnection )
     if( !processor_.onPreCommit_( outputConnection ) )
         return CS_NOCHANGE;
 
+    batchedChanges_ = 0;
     const CommitState ret = commit_( outputConnection );
     processor_.onPostCommit_( outputConnection, ret );
     return ret;
 
 }
 
+CommitState ProcessorOutput::commitBatched( const uint32_t outputConnection )
+{
+    if( batchedChanges_++ == 0 )
+        batchClock_.reset();
+
+    if( batchedChanges_ < maxBatchedChanges_ &&
+        batchClock_.getTimef() < maxBatchLatency_ )
+    {
+        return CS_NOCHANGE;
+    }
+
+    // The dash context keeps the changes, the next commit sends them all
+    if( maxPendingCommits_ > 0 &&
+        getPendingCommits_( outputConnection ) >= maxPendingCommits_ )
+    {
+        return CS_NOCHANGE;
+    }
+
+    return commit( outputConnection );
+}
+
+CommitState ProcessorOutput::commitPending( const uint32_t outputConnection )
+{
+    if( batchedChanges_ == 0 )
+        return CS_NOCHANGE;
+    return commit( outputConnection );
+}
+
+size_t ProcessorOutput::getBatchedChanges() const
+{
+    return batchedChanges_;
+}
+
+void ProcessorOutput::setCommitBatching( const size_t maxChanges,
+                                         const float maxLatency,
+                                         const size_t maxPendingCommits )
+{
+    maxBatchedChanges_ = std::max( maxChanges, size_t( 1 ));
+    maxBatchLatency_ = maxLatency;
+    maxPendingCommits_ = maxPendingCommits;
+}
+
 void ProcessorOutput::setBlocked( const bool block, const uint32_t outputConnection /* =0 */)
 {
     blockedMap_[ outputConnection ] = block;
@@ -23,6 +23,8 @@
 #include <livre/core/api.h>
 #include <livre/core/types.h>
 
+#include <lunchbox/clock.h>
+
 namespace livre
 {
 
@@ -53,6 +55,41 @@ public:
      */
     LIVRECORE_API CommitState commit( const uint32_t outputConnection );
 
+    /**
+     * Counts a change towards a batched commit, which is sent once the batch
+     * holds the maximum number of changes or its first change is older than
+     * the latency budget, \see setCommitBatching(). While the receiver has too
+     * many pending commits, the batch is held back and the changes coalesce
+     * into a later commit. commit() sends the batch unconditionally. The
+     * latency is only checked when a change is counted, so call
+     * commitPending() before blocking.
+     * @param outputConnection Output connection id.
+     * @return The state of the commit, CS_NOCHANGE if the batch is held.
+     */
+    LIVRECORE_API CommitState commitBatched( const uint32_t outputConnection );
+
+    /**
+     * Commits the changes counted by commitBatched() and not sent yet, e.g.
+     * before a blocking operation which would delay them past the latency
+     * budget.
+     * @param outputConnection Output connection id.
+     * @return The state of the commit, CS_NOCHANGE if no change is batched.
+     */
+    LIVRECORE_API CommitState commitPending( const uint32_t outputConnection );
+
+    /** @return the number of changes counted since the last commit. */
+    LIVRECORE_API size_t getBatchedChanges() const;
+
+    /**
+     * Sets the batching of commitBatched(). The default commits every change.
+     * @param maxChanges The number of changes per commit, at least 1.
+     * @param maxLatency The time in ms a change may wait for its commit.
+     * @param maxPendingCommits The number of pending commits of the receiver
+     *        above which batches are held back, 0 for no limit.
+     */
+    LIVRECORE_API void setCommitBatching( size_t maxChanges, float maxLatency,
+                                          size_t maxPendingCommits );
+
     /**
      * Blocks the connection, no operation is allowed after the blocking.
      * @param block Blocking flag, if true connection is blocked.
@@ -90,12 +127,25 @@ protected:
      */
     void removeConnection_(  const uint32_t outputConnection );
 
+    /**
+     * @param outputConnection Connection id.
+     * @return The number of commits the receiver has not applied yet.
+     */
+    virtual size_t getPendingCommits_(
+        const uint32_t outputConnection LB_UNUSED ) const { return 0; }
+
 private:
 
     Processor& processor_;
 
     BoolMap blockedMap_;
 
+    size_t maxBatchedChanges_;
+    float maxBatchLatency_;
+    size_t maxPendingCommits_;
+    size_t batchedChanges_;
+    lunchbox::Clock batchClock_;
+
 };
 
 }
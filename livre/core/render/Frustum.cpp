@@ -19,6 +19,9 @@
 
 #include <livre/core/render/Frustum.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace livre
 {
 
@@ -52,6 +55,26 @@ bool Frustum::boxInFrustum( const Boxf &worldBox ) const
     return vis != vmml::VISIBILITY_NONE;
 }
 
+float Frustum::getProjectedHeight( const Boxf& worldBox ) const
+{
+    if( !isInitialized_ )
+        return 0.0f;
+
+    // The viewport height in world space at the distance of the box, as in
+    // ScreenSpaceLODEvaluator
+    const float t = getFrustumLimits( PL_TOP );
+    const float b = getFrustumLimits( PL_BOTTOM );
+    const float n = getFrustumLimits( PL_NEAR );
+    if( !( n > 0.0f ) || !( t > b ))
+        return 0.0f;
+
+    const float distance = std::max( n, std::abs(
+        getWPlane( PL_NEAR ).distance( worldBox.getCenter( ))));
+    const float height = worldBox.getDimension().y() * n /
+                         (( t - b ) * distance );
+    return std::isfinite( height ) ? height : 0.0f;
+}
+
 bool Frustum::isInitialized( ) const
 {
     return isInitialized_;
@@ -70,6 +70,14 @@ public:
      */
     LIVRECORE_API bool boxInFrustum( const Boxf &worldBox ) const;
 
+    /**
+     * @param worldBox AABB box.
+     * @return The height of the box relative to the height of the viewport
+     * at the distance of its center, clamped to the near plane. 0 if the
+     * frustum is not initialized or degenerate.
+     */
+    LIVRECORE_API float getProjectedHeight( const Boxf& worldBox ) const;
+
     /**
      * @return True if Frustum is initialized
      */
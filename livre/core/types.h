@@ -42,6 +42,7 @@
 #include <map>
 #include <deque>
 #include <algorithm>
+#include <future>
 #include <utility>
 
 namespace livre
@@ -66,6 +67,7 @@ class EventHandler;
 class EventHandlerFactory;
 class EventInfo;
 class EventMapper;
+class FrequencySketch;
 class Frustum;
 class GLContext;
 class GLSLShaders;
@@ -82,6 +84,7 @@ class ProcessorOutput;
 class RenderBrick;
 class Renderer;
 class RootNode;
+class SlabAllocator;
 class TexturePool;
 class TexturePoolFactory;
 class View;
@@ -105,8 +108,10 @@ typedef std::array< float, 2 > Range;
  */
 typedef boost::scoped_ptr< GLSLShaders > GLSLShadersPtr;
 typedef boost::scoped_ptr< CacheStatistics > CacheStatisticsPtr;
+typedef boost::scoped_ptr< FrequencySketch > FrequencySketchPtr;
 
 typedef boost::shared_ptr< AllocMemoryUnit > AllocMemoryUnitPtr;
+typedef boost::shared_ptr< SlabAllocator > SlabAllocatorPtr;
 typedef boost::shared_ptr< RenderBrick > RenderBrickPtr;
 typedef boost::shared_ptr< LODNode > LODNodePtr;
 typedef boost::shared_ptr< const LODNode > ConstLODNodePtr;
@@ -181,6 +186,7 @@ typedef std::vector< uint64_t > UInt64Vector;
 
 typedef std::vector< bool > BoolVector;
 typedef std::vector< NodeId > NodeIds;
+typedef std::vector< CacheId > CacheIds;
 
 /**
  * Vector definitions for complex types
@@ -189,6 +195,13 @@ typedef std::vector< CacheObjectPtr > CacheObjects;
 typedef std::vector< ConstCacheObjectPtr > ConstCacheObjects;
 typedef std::vector< RenderBrickPtr > RenderBricks;
 typedef std::vector< TexturePoolPtr > TexturePools;
+typedef std::vector< LODNode > LODNodes;
+
+/**
+ * Future definitions
+ */
+typedef std::future< MemoryUnitPtr > MemoryUnitFuture;
+typedef std::vector< MemoryUnitFuture > MemoryUnitFutures;
 
 /**
  * Map definitions
@@ -29,21 +29,37 @@
 #include <livre/eq/Pipe.h>
 #include <livre/eq/Event.h>
 
+#include <livre/eq/settings/FrameSettings.h>
 #include <livre/eq/settings/VolumeSettings.h>
+#include <livre/lib/cache/CacheBudgetManager.h>
+#include <livre/lib/cache/CacheSnapshot.h>
+#include <livre/lib/cache/CompressedCache.h>
+#include <livre/lib/cache/DiskCache.h>
+#include <livre/lib/cache/TextureCache.h>
 #include <livre/lib/cache/TextureDataCache.h>
 #include <livre/lib/configuration/VolumeRendererParameters.h>
 #include <livre/lib/uploaders/DataUploadProcessor.h>
 #include <livre/core/dash/DashRenderStatus.h>
 #include <livre/core/dash/DashTree.h>
 #include <livre/core/dashpipeline/DashProcessorOutput.h>
+#include <livre/core/data/MemoryUnit.h>
+#include <livre/core/data/SlabAllocator.h>
 #include <livre/core/data/VolumeDataSource.h>
 
 #include <eq/eq.h>
 #include <eq/gl.h>
 
+#include <lunchbox/clock.h>
+#include <lunchbox/scopedMutex.h>
+
 namespace livre
 {
 
+namespace
+{
+const float REBALANCE_INTERVAL = 1000.f; //!< Between rebalancing in ms
+}
+
 namespace detail
 {
 
@@ -53,6 +69,7 @@ public:
     explicit Node( livre::Node* node )
        : _node( node )
        , _config( static_cast< livre::Config* >( node->getConfig( )))
+       , _cacheSnapshotNumber( 0 )
     {}
 
     void initializeCache()
@@ -62,8 +79,196 @@ public:
 
         ConstVolumeRendererParametersPtr vrRenderParametersPtr =
                 _config->getFrameData().getVRParameters();
-        _textureDataCachePtr->setMaximumMemory(
-                    vrRenderParametersPtr->maxCPUCacheMemoryMB * LB_1MB );
+        const size_t budget = vrRenderParametersPtr->maxCPUCacheMemoryMB;
+        const size_t minBudget = vrRenderParametersPtr->cpuCacheMinMemoryMB;
+        const size_t maxBudget = vrRenderParametersPtr->cpuCacheMaxMemoryMB;
+        _cacheBudgetManager.addCache( *_textureDataCachePtr, budget * LB_1MB,
+                                      ( minBudget ? minBudget : budget ) *
+                                          LB_1MB,
+                                      ( maxBudget ? maxBudget : budget ) *
+                                          LB_1MB );
+        _textureDataCachePtr->setPolicy( LRUCache::getPolicyType(
+                    vrRenderParametersPtr->cpuCachePolicy ));
+        _textureDataCachePtr->setMaximumObjectCount(
+            vrRenderParametersPtr->maxCacheObjects );
+
+        // the sketch tells apart the bricks of the largest CPU cache budget
+        if( vrRenderParametersPtr->cpuCacheAdmission )
+            _textureDataCachePtr->setAdmissionFilter( std::max(
+                std::max( budget, maxBudget ) * LB_1MB / getBrickSize(),
+                size_t( 1 )));
+
+        initializeCompressedCache();
+        initializeSlabAllocator();
+        loadCacheSnapshot();
+        if( vrRenderParametersPtr->diskCache.empty( ))
+            return;
+        try
+        {
+            VolumeSettingsPtr volumeSettingsPtr =
+                    _config->getFrameData().getVolumeSettings();
+            _textureDataCachePtr->setDiskCache( DiskCachePtr(
+                new DiskCache( vrRenderParametersPtr->diskCache,
+                               volumeSettingsPtr->getURI(),
+                               vrRenderParametersPtr->maxDiskCacheMemoryMB *
+                                   LB_1MB )));
+        }
+        catch( const std::runtime_error& err )
+        {
+            LBWARN << "Disk cache initialization failed: " << err.what()
+                   << std::endl;
+        }
+    }
+
+    void initializeCompressedCache()
+    {
+        ConstVolumeRendererParametersPtr vrRenderParametersPtr =
+                _config->getFrameData().getVRParameters();
+        const size_t maxMemory = vrRenderParametersPtr->compressedCacheMemoryMB;
+        if( maxMemory == 0 )
+            return;
+        if( !CompressedCache::isSupported( ))
+        {
+            LBWARN << "Compressed cache disabled, LZ4 is not available"
+                   << std::endl;
+            return;
+        }
+        _textureDataCachePtr->setCompressedCache( CompressedCachePtr(
+            new CompressedCache( maxMemory * LB_1MB )));
+    }
+
+    /** @return the size in bytes of the largest brick of the volume */
+    size_t getBrickSize() const
+    {
+        const VolumeInformation& info = _dataSourcePtr->getVolumeInformation();
+        return size_t( info.maximumBlockSize.product( )) * info.compCount *
+               info.getBytesPerVoxel();
+    }
+
+    void initializeSlabAllocator()
+    {
+        ConstVolumeRendererParametersPtr vrRenderParametersPtr =
+                _config->getFrameData().getVRParameters();
+        const std::string& allocator = vrRenderParametersPtr->cpuCacheAllocator;
+        if( allocator != "slab" && allocator != "hugepages" )
+        {
+            if( allocator != "heap" )
+                LBWARN << "Unknown CPU cache allocator " << allocator
+                       << ", using heap" << std::endl;
+            return;
+        }
+
+        // one slot per brick of the largest CPU cache budget, smaller buffers
+        // stay on the heap
+        const size_t brickSize = getBrickSize();
+        const size_t budget = std::max(
+            vrRenderParametersPtr->maxCPUCacheMemoryMB,
+            vrRenderParametersPtr->cpuCacheMaxMemoryMB ) * LB_1MB;
+        const uint32_t flags = SlabAllocator::SLAB_POPULATE |
+            ( allocator == "hugepages" ? SlabAllocator::SLAB_HUGE_PAGES : 0 );
+        try
+        {
+            AllocMemoryUnit::setSlabAllocator( SlabAllocatorPtr(
+                new SlabAllocator( brickSize,
+                                   std::max( budget / brickSize, size_t( 1 )),
+                                   flags, brickSize / 2 )));
+        }
+        catch( const std::runtime_error& err )
+        {
+            LBWARN << "Slab allocator initialization failed: " << err.what()
+                   << std::endl;
+        }
+    }
+
+    void loadCacheSnapshot()
+    {
+        ConstVolumeRendererParametersPtr vrRenderParametersPtr =
+                _config->getFrameData().getVRParameters();
+        if( vrRenderParametersPtr->cacheSnapshot.empty( ))
+            return;
+
+        VolumeSettingsPtr volumeSettingsPtr =
+                _config->getFrameData().getVolumeSettings();
+        _cacheSnapshot = livre::loadCacheSnapshot(
+            vrRenderParametersPtr->cacheSnapshot, volumeSettingsPtr->getURI( ));
+        LBINFO << "Cache snapshot " << vrRenderParametersPtr->cacheSnapshot
+               << " has " << _cacheSnapshot.size() << " bricks" << std::endl;
+    }
+
+    /** Write the bricks of the texture caches first, as they are the hottest */
+    void saveCacheSnapshot()
+    {
+        ConstVolumeRendererParametersPtr vrRenderParametersPtr =
+                _config->getFrameData().getVRParameters();
+        if( vrRenderParametersPtr->cacheSnapshot.empty() ||
+            !_textureDataCachePtr )
+        {
+            return;
+        }
+
+        CacheIds cacheIds;
+        {
+            lunchbox::ScopedWrite mutex( _textureCacheLock );
+            if( _textureCaches.empty( ))
+                cacheIds = _textureCacheIds;
+            BOOST_FOREACH( const TextureCache* textureCache, _textureCaches )
+            {
+                const CacheIds ids = textureCache->getLoadedCacheIds();
+                cacheIds.insert( cacheIds.end(), ids.begin(), ids.end( ));
+            }
+        }
+        const CacheIds dataIds = _textureDataCachePtr->getLoadedCacheIds();
+        cacheIds.insert( cacheIds.end(), dataIds.begin(), dataIds.end( ));
+
+        CacheIdSet written;
+        CacheIds snapshot;
+        BOOST_FOREACH( const CacheId cacheId, cacheIds )
+        {
+            if( written.insert( cacheId ).second )
+                snapshot.push_back( cacheId );
+        }
+
+        VolumeSettingsPtr volumeSettingsPtr =
+                _config->getFrameData().getVolumeSettings();
+        if( livre::saveCacheSnapshot( vrRenderParametersPtr->cacheSnapshot,
+                                      volumeSettingsPtr->getURI(), snapshot ))
+        {
+            LBINFO << "Wrote " << snapshot.size() << " bricks to cache "
+                   << "snapshot " << vrRenderParametersPtr->cacheSnapshot
+                   << std::endl;
+        }
+    }
+
+    void addTextureCache( TextureCache& textureCache )
+    {
+        ConstVolumeRendererParametersPtr vrRenderParametersPtr =
+                _config->getFrameData().getVRParameters();
+        const size_t budget = vrRenderParametersPtr->maxGPUCacheMemoryMB;
+        const size_t minBudget = vrRenderParametersPtr->gpuCacheMinMemoryMB;
+        const size_t maxBudget = vrRenderParametersPtr->gpuCacheMaxMemoryMB;
+        _cacheBudgetManager.addCache( textureCache, budget * LB_1MB,
+                                      ( minBudget ? minBudget : budget ) *
+                                          LB_1MB,
+                                      ( maxBudget ? maxBudget : budget ) *
+                                          LB_1MB );
+        textureCache.setMaximumObjectCount(
+            vrRenderParametersPtr->maxCacheObjects );
+
+        lunchbox::ScopedWrite mutex( _textureCacheLock );
+        _textureCaches.push_back( &textureCache );
+    }
+
+    void removeTextureCache( const TextureCache& textureCache )
+    {
+        _cacheBudgetManager.removeCache( textureCache );
+
+        // keep the bricks of the last texture cache for the exit snapshot
+        lunchbox::ScopedWrite mutex( _textureCacheLock );
+        _textureCacheIds = textureCache.getLoadedCacheIds();
+        _textureCaches.erase( std::remove( _textureCaches.begin(),
+                                           _textureCaches.end(),
+                                           &textureCache ),
+                              _textureCaches.end( ));
     }
 
     bool initializeVolume()
@@ -98,6 +303,7 @@ public:
 
     void configExit()
     {
+        saveCacheSnapshot();
         releaseCache();
         releaseVolume();
     }
@@ -106,6 +312,20 @@ public:
     {
         if( !_node->isApplicationNode( ))
             _config->getFrameData().sync( frameId );
+
+        if( _rebalanceClock.getTimef() >= REBALANCE_INTERVAL )
+        {
+            _cacheBudgetManager.rebalance();
+            _rebalanceClock.reset();
+        }
+
+        const uint32_t cacheSnapshotNumber =
+            _config->getFrameData().getFrameSettings()->getCacheSnapshotNumber();
+        if( cacheSnapshotNumber != _cacheSnapshotNumber )
+        {
+            _cacheSnapshotNumber = cacheSnapshotNumber;
+            saveCacheSnapshot();
+        }
     }
 
     void releaseVolume()
@@ -116,7 +336,10 @@ public:
 
     void releaseCache()
     {
+        if( _textureDataCachePtr )
+            _cacheBudgetManager.removeCache( *_textureDataCachePtr );
         _textureDataCachePtr.reset();
+        AllocMemoryUnit::setSlabAllocator( SlabAllocatorPtr( ));
     }
 
     void updateAndSendFrameRange()
@@ -134,6 +357,13 @@ public:
     TextureDataCachePtr _textureDataCachePtr;
     VolumeDataSourcePtr _dataSourcePtr;
     DashTreePtr _dashTreePtr;
+    CacheBudgetManager _cacheBudgetManager;
+    lunchbox::Clock _rebalanceClock;
+    CacheIds _cacheSnapshot;
+    uint32_t _cacheSnapshotNumber;
+    lunchbox::Lock _textureCacheLock;
+    std::vector< const TextureCache* > _textureCaches;
+    CacheIds _textureCacheIds; //!< Of the last removed texture cache
 };
 
 }
@@ -189,6 +419,21 @@ TextureDataCache& Node::getTextureDataCache()
     return *_impl->_textureDataCachePtr;
 }
 
+void Node::addTextureCache( TextureCache& textureCache )
+{
+    _impl->addTextureCache( textureCache );
+}
+
+void Node::removeTextureCache( const TextureCache& textureCache )
+{
+    _impl->removeTextureCache( textureCache );
+}
+
+const CacheIds& Node::getCacheSnapshot() const
+{
+    return _impl->_cacheSnapshot;
+}
+
 DashTreePtr Node::getDashTree()
 {
     return _impl->_dashTreePtr;
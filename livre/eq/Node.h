@@ -53,6 +53,25 @@ public:
      */
     TextureDataCache& getTextureDataCache();
 
+    /**
+     * Adds a texture cache of the node. The memory is moved between the data
+     * cache and the texture caches within the bounds of each cache, and their
+     * bricks are written to the cache snapshot.
+     * @param textureCache The texture cache, until removeTextureCache().
+     */
+    void addTextureCache( TextureCache& textureCache );
+
+    /**
+     * Removes a texture cache added with addTextureCache().
+     * @param textureCache The texture cache.
+     */
+    void removeTextureCache( const TextureCache& textureCache );
+
+    /**
+     * @return The bricks of the cache snapshot read on startup, to prefetch.
+     */
+    const CacheIds& getCacheSnapshot() const;
+
     /**
      * @return The dash tree.
      */
@@ -195,11 +195,17 @@ public:
             new EqTextureUploadProcessor( *config, dashTree, _windowContext,
                                           textureUploadContext,
                                      pipe->getFrameData()->getVRParameters( )));
+        node->addTextureCache( _textureUploader->getTextureCache( ));
+        _dataUploader->setPrefetchList( node->getCacheSnapshot( ));
+        _dataUploader->setLoaderThreadCount(
+            pipe->getFrameData()->getVRParameters()->loaderThreads );
     }
 
     void releasePipelineProcessors()
     {
         stopUploadProcessors();
+        Node* node = static_cast< Node* >( _window->getNode( ));
+        node->removeTextureCache( _textureUploader->getTextureCache( ));
         _textureUploader->setDashContext( DashContextPtr( ));
         _dataUploader->setDashContext( DashContextPtr( ));
         _textureUploader.reset();
@@ -229,6 +235,17 @@ public:
                 ->addConnection( CONNECTION_ID, pipeOutputConnectionPtr );
         _dashProcessor->getProcessorOutput_< DashProcessorOutput >()
                 ->addConnection( CONNECTION_ID, pipeOutputConnectionPtr );
+
+        // Batches the bricks sent by the uploaders
+        Pipe* pipe = static_cast< Pipe* >( _window->getPipe( ));
+        ConstVolumeRendererParametersPtr vrParameters =
+            pipe->getFrameData()->getVRParameters();
+        _dataUploader->getProcessorOutput_()->setCommitBatching(
+            vrParameters->commitBatchSize, vrParameters->commitBatchLatency,
+            vrParameters->commitMaxPending );
+        _textureUploader->getProcessorOutput_()->setCommitBatching(
+            vrParameters->commitBatchSize, vrParameters->commitBatchLatency,
+            vrParameters->commitMaxPending );
     }
 
     void releasePipelineConnections( )
@@ -102,6 +102,11 @@ bool KeyboardHandler::operator ()( EqEventInfo& eqEventInfo )
             frameSettings->makeScreenshot();
             return true;
 
+        case 'w':
+        case 'W':
+            frameSettings->saveCacheSnapshot();
+            return true;
+
         case 'c':
         case 'C':
         {
@@ -37,6 +37,7 @@ void FrameSettings::reset()
     currentViewId_ = lunchbox::uint128_t( 0 );
     frameNumber_ = INVALID_FRAME;
     screenShot_ = 0;
+    cacheSnapshot_ = 0;
     recording_ = false;
     statistics_ = false;
     help_ = false;
@@ -47,14 +48,14 @@ void FrameSettings::reset()
 void FrameSettings::serialize( co::DataOStream& os, const uint64_t dirtyBits )
 {
     co::Serializable::serialize( os, dirtyBits );
-    os << currentViewId_ << frameNumber_ << screenShot_
+    os << currentViewId_ << frameNumber_ << screenShot_ << cacheSnapshot_
        << recording_ << statistics_ << help_ << grabFrame_;
 }
 
 void FrameSettings::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
 {
     co::Serializable::deserialize( is, dirtyBits );
-    is >> currentViewId_ >> frameNumber_ >> screenShot_
+    is >> currentViewId_ >> frameNumber_ >> screenShot_ >> cacheSnapshot_
        >> recording_ >> statistics_ >> help_ >> grabFrame_;
 }
 
@@ -73,6 +74,12 @@ void FrameSettings::makeScreenshot()
     setDirty( DIRTY_ALL );
 }
 
+void FrameSettings::saveCacheSnapshot()
+{
+    cacheSnapshot_++;
+    setDirty( DIRTY_ALL );
+}
+
 void FrameSettings::toggleRecording()
 {
     recording_ = !recording_;
@@ -111,6 +118,11 @@ uint32_t FrameSettings::getScreenshotNumber() const
     return screenShot_;
 }
 
+uint32_t FrameSettings::getCacheSnapshotNumber() const
+{
+    return cacheSnapshot_;
+}
+
 void FrameSettings::setCurrentViewId( const eq::uint128_t &id )
 {
     currentViewId_ = id;
@@ -81,6 +81,16 @@ public:
      */
     uint32_t getScreenshotNumber() const;
 
+    /**
+     * Writes the resident bricks to the cache snapshot.
+     */
+    void saveCacheSnapshot();
+
+    /**
+     * @return Returns the cache snapshot number.
+     */
+    uint32_t getCacheSnapshotNumber() const;
+
     /**
      * Set the current view id.
      * @param id The view id.
@@ -126,6 +136,7 @@ private:
     eq::uint128_t currentViewId_;
     uint32_t frameNumber_;
     uint32_t screenShot_;
+    uint32_t cacheSnapshot_;
     bool recording_;
     bool statistics_;
     bool help_;
@@ -0,0 +1,196 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/cache/CacheBudgetManager.h>
+#include <livre/lib/cache/LRUCache.h>
+#include <livre/core/cache/CacheStatistics.h>
+
+#include <lunchbox/scopedMutex.h>
+
+namespace livre
+{
+
+namespace
+{
+/** Minimal reload cost of an unloaded object, in milliseconds */
+const double MIN_RELOAD_COST = 0.001;
+
+/** Fraction of the two budgets moved by one rebalancing step */
+const double STEP_RATIO = 0.1;
+
+/** The receiver needs that much more gain than the donor to move memory */
+const double GAIN_RATIO = 2.0;
+}
+
+struct CacheBudgetManager::Entry
+{
+    Entry( LRUCache& cache_, const size_t budget_, const size_t minBudget_,
+           const size_t maxBudget_ )
+        : cache( &cache_ )
+        , budget( budget_ )
+        , minBudget( minBudget_ )
+        , maxBudget( maxBudget_ )
+        , hits( 0 )
+        , misses( 0 )
+        , unloads( 0 )
+        , unloadedLoadTime( 0.0 )
+        , gain( 0.0 )
+    {
+        sample();
+    }
+
+    /**
+     * Reads the statistics of the cache, and computes the load time in
+     * milliseconds saved per MB of budget since the previous sample.
+     */
+    void sample()
+    {
+        const CacheStatistics& statistics = cache->getStatistics();
+        const size_t newHits = statistics.getCacheHits();
+        const size_t newMisses = statistics.getCacheMisses();
+        const size_t newUnloads = statistics.getUnloadCount();
+        const double newUnloadedLoadTime = statistics.getUnloadedLoadTime();
+
+        const double deltaHits = double( newHits - hits );
+        const double deltaMisses = double( newMisses - misses );
+        const double cost = newUnloadedLoadTime - unloadedLoadTime +
+                            double( newUnloads - unloads ) * MIN_RELOAD_COST;
+        const double lookups = deltaHits + deltaMisses;
+        const double missRate = lookups > 0.0 ? deltaMisses / lookups : 0.0;
+        const double budgetMB = double( std::max( budget, size_t( LB_1MB )))
+                                / LB_1MB;
+        gain = cost * missRate / budgetMB;
+
+        hits = newHits;
+        misses = newMisses;
+        unloads = newUnloads;
+        unloadedLoadTime = newUnloadedLoadTime;
+    }
+
+    LRUCache* cache;
+    size_t budget;
+    size_t minBudget;
+    size_t maxBudget;
+    size_t hits;
+    size_t misses;
+    size_t unloads;
+    double unloadedLoadTime;
+    double gain;
+};
+
+CacheBudgetManager::CacheBudgetManager()
+{
+}
+
+CacheBudgetManager::~CacheBudgetManager()
+{
+}
+
+void CacheBudgetManager::addCache( LRUCache& cache, const size_t budget,
+                                   const size_t minBudget,
+                                   const size_t maxBudget )
+{
+    const size_t lower = std::min( minBudget, budget );
+    const size_t upper = std::max( maxBudget, budget );
+
+    lunchbox::ScopedWrite mutex( lock_ );
+    removeCache_( cache );
+    cache.setMaximumMemory( budget );
+    entries_.push_back( Entry( cache, budget, lower, upper ));
+}
+
+void CacheBudgetManager::removeCache( const LRUCache& cache )
+{
+    lunchbox::ScopedWrite mutex( lock_ );
+    removeCache_( cache );
+}
+
+void CacheBudgetManager::removeCache_( const LRUCache& cache )
+{
+    for( Entries::iterator i = entries_.begin(); i != entries_.end(); ++i )
+    {
+        if( i->cache == &cache )
+        {
+            entries_.erase( i );
+            return;
+        }
+    }
+}
+
+size_t CacheBudgetManager::getBudget( const LRUCache& cache ) const
+{
+    lunchbox::ScopedWrite mutex( lock_ );
+    BOOST_FOREACH( const Entry& entry, entries_ )
+    {
+        if( entry.cache == &cache )
+            return entry.budget;
+    }
+    return 0;
+}
+
+bool CacheBudgetManager::rebalance()
+{
+    lunchbox::ScopedWrite mutex( lock_ );
+    BOOST_FOREACH( Entry& entry, entries_ )
+        entry.sample();
+
+    Entry* receiver = 0;
+    BOOST_FOREACH( Entry& entry, entries_ )
+    {
+        if( entry.gain > 0.0 && entry.budget < entry.maxBudget &&
+            ( !receiver || entry.gain > receiver->gain ))
+        {
+            receiver = &entry;
+        }
+    }
+    if( !receiver )
+        return false;
+
+    Entry* donor = 0;
+    BOOST_FOREACH( Entry& entry, entries_ )
+    {
+        if( &entry != receiver && entry.budget > entry.minBudget &&
+            ( !donor || entry.gain < donor->gain ))
+        {
+            donor = &entry;
+        }
+    }
+    if( !donor || receiver->gain <= donor->gain * GAIN_RATIO )
+        return false;
+
+    size_t step = size_t( double( receiver->budget + donor->budget ) *
+                          STEP_RATIO );
+    step = std::min( step, receiver->maxBudget - receiver->budget );
+    step = std::min( step, donor->budget - donor->minBudget );
+    if( step == 0 )
+        return false;
+
+    // shrink first, the sum of the budgets never exceeds the total
+    donor->budget -= step;
+    donor->cache->setMaximumMemory( donor->budget );
+    receiver->budget += step;
+    receiver->cache->setMaximumMemory( receiver->budget );
+
+    LBINFO << "Moved " << step / LB_1MB << " MB from "
+           << donor->cache->getStatistics().getStatisticsName() << " to "
+           << receiver->cache->getStatistics().getStatisticsName() << std::endl;
+    return true;
+}
+
+}
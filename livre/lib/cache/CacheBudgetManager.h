@@ -0,0 +1,90 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _CacheBudgetManager_h_
+#define _CacheBudgetManager_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+
+#include <lunchbox/lock.h>
+
+namespace livre
+{
+
+/**
+ * The CacheBudgetManager class shares a memory budget between caches, e.g.
+ * the CPU \see TextureDataCache and the GPU \see TextureCache.
+ *
+ * Each call to rebalance() compares the caches by the load time which more
+ * memory would have saved since the previous call: the reload cost of the
+ * unloaded objects, weighted by the miss rate and divided by the budget. A
+ * step of memory moves from the cache with the least gain to the cache with
+ * the most, within the bounds of each cache, and is applied at once with
+ * \see LRUCache::setMaximumMemory. The sum of the budgets does not change.
+ */
+class CacheBudgetManager : public boost::noncopyable
+{
+public:
+    LIVRE_API CacheBudgetManager();
+    LIVRE_API ~CacheBudgetManager();
+
+    /**
+     * Adds a cache to the managed caches, and sets its maximum memory.
+     * @param cache The cache, which has to outlive its registration.
+     * @param budget The initial maximum memory in bytes.
+     * @param minBudget The lower bound of the maximum memory in bytes.
+     * @param maxBudget The upper bound of the maximum memory in bytes.
+     */
+    LIVRE_API void addCache( LRUCache& cache, size_t budget, size_t minBudget,
+                             size_t maxBudget );
+
+    /**
+     * Removes a cache from the managed caches, its budget is not shared.
+     * @param cache The cache.
+     */
+    LIVRE_API void removeCache( const LRUCache& cache );
+
+    /**
+     * @param cache The cache.
+     * @return The current budget in bytes of the cache, 0 if it is not managed.
+     */
+    LIVRE_API size_t getBudget( const LRUCache& cache ) const;
+
+    /**
+     * Moves memory between the caches, according to their statistics since the
+     * previous call.
+     * @return True if the budgets have changed.
+     */
+    LIVRE_API bool rebalance();
+
+private:
+
+    struct Entry;
+    typedef std::vector< Entry > Entries;
+
+    void removeCache_( const LRUCache& cache );
+
+    mutable lunchbox::Lock lock_;
+    Entries entries_;
+};
+
+}
+
+#endif // _CacheBudgetManager_h_
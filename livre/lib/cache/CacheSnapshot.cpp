@@ -0,0 +1,95 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/cache/CacheSnapshot.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace fs = boost::filesystem;
+
+namespace livre
+{
+
+namespace
+{
+const std::string SNAPSHOT_HEADER = "livre-cache-snapshot 1";
+}
+
+bool saveCacheSnapshot( const std::string& filename, const std::string& volume,
+                        const CacheIds& cacheIds )
+{
+    const std::string tmpFilename = filename + ".tmp";
+    {
+        std::ofstream file( tmpFilename.c_str( ));
+        file << SNAPSHOT_HEADER << "\n" << volume << "\n" << std::hex;
+        BOOST_FOREACH( const CacheId cacheId, cacheIds )
+            file << cacheId << "\n";
+        file.close(); // flushes, a full disk fails here
+        if( !file )
+        {
+            LBWARN << "Cannot write cache snapshot " << filename << std::endl;
+            boost::system::error_code error;
+            fs::remove( tmpFilename, error );
+            return false;
+        }
+    }
+
+    boost::system::error_code error;
+    fs::rename( tmpFilename, filename, error );
+    if( error )
+    {
+        LBWARN << "Cannot write cache snapshot " << filename << ": "
+               << error.message() << std::endl;
+        fs::remove( tmpFilename, error );
+        return false;
+    }
+    return true;
+}
+
+CacheIds loadCacheSnapshot( const std::string& filename,
+                            const std::string& volume )
+{
+    CacheIds cacheIds;
+    std::ifstream file( filename.c_str( ));
+    if( !file )
+        return cacheIds;
+
+    std::string header, snapshotVolume;
+    if( !std::getline( file, header ) || header != SNAPSHOT_HEADER ||
+        !std::getline( file, snapshotVolume ))
+    {
+        LBWARN << filename << " is not a cache snapshot" << std::endl;
+        return cacheIds;
+    }
+    if( snapshotVolume != volume )
+    {
+        LBINFO << "Ignoring cache snapshot " << filename << " of "
+               << snapshotVolume << std::endl;
+        return cacheIds;
+    }
+
+    CacheId cacheId;
+    while( file >> std::hex >> cacheId )
+        cacheIds.push_back( cacheId );
+    return cacheIds;
+}
+
+}
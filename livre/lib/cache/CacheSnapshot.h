@@ -0,0 +1,55 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _CacheSnapshot_h_
+#define _CacheSnapshot_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+
+namespace livre
+{
+
+/**
+ * Write the ids of the resident bricks of a volume to a snapshot file, to warm
+ * up the caches of the next session. The file is a text file, with a header
+ * naming the volume and one hexadecimal cache id per line, hottest first. It is
+ * replaced atomically.
+ * @param filename The snapshot file.
+ * @param volume The unique name of the volume, e.g. its URI.
+ * @param cacheIds The ids of the resident bricks, the most recently used first.
+ * @return true if the snapshot was written.
+ */
+LIVRE_API bool saveCacheSnapshot( const std::string& filename,
+                                  const std::string& volume,
+                                  const CacheIds& cacheIds );
+
+/**
+ * Read the ids of the bricks of a snapshot file written by saveCacheSnapshot().
+ * @param filename The snapshot file.
+ * @param volume The unique name of the volume, e.g. its URI.
+ * @return the ids in snapshot order, empty if the file does not exist or
+ *         belongs to another volume.
+ */
+LIVRE_API CacheIds loadCacheSnapshot( const std::string& filename,
+                                      const std::string& volume );
+
+}
+
+#endif // _CacheSnapshot_h_
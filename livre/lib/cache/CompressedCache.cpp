@@ -0,0 +1,195 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/cache/CompressedCache.h>
+#include <livre/lib/data/BrickCompression.h>
+
+#include <livre/core/data/MemoryUnit.h>
+
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <list>
+
+namespace livre
+{
+
+namespace detail
+{
+
+class CompressedCache
+{
+    struct Entry
+    {
+        std::vector< uint8_t > data;
+        size_t size; // uncompressed
+        std::list< CacheId >::iterator lru;
+    };
+    typedef boost::unordered_map< CacheId, Entry > EntryMap;
+
+public:
+    explicit CompressedCache( const size_t maxMemory )
+        : _maxMemory( maxMemory )
+        , _usedMemory( 0 )
+        , _uncompressedMemory( 0 )
+    {}
+
+    bool load( const CacheId cacheId, const size_t size,
+               AllocMemoryUnit& memory )
+    {
+        // take the brick out of the cache, decompress it without the lock
+        std::vector< uint8_t > data;
+        {
+            lunchbox::ScopedWrite mutex( _lock );
+            EntryMap::iterator i = _entries.find( cacheId );
+            if( i == _entries.end( ))
+                return false;
+            if( i->second.size != size )
+            {
+                LBWARN << "Compressed brick " << cacheId << " has "
+                       << i->second.size << " instead of " << size << " bytes"
+                       << std::endl;
+                _remove( i );
+                return false;
+            }
+            data.swap( i->second.data );
+            _remove( i );
+        }
+
+        memory.alloc( size );
+        return decompressBrick( BRICK_COMPRESSION_LZ4, &data[0], data.size(),
+                                memory.getData< uint8_t >(), size );
+    }
+
+    void store( const CacheId cacheId, const MemoryUnit& memory )
+    {
+        const size_t size = memory.getMemSize();
+        if( size == 0 || contains( cacheId ))
+            return;
+
+        std::vector< uint8_t > data;
+        if( !compressBrick( BRICK_COMPRESSION_LZ4, memory.getData< uint8_t >(),
+                            size, data ) || data.size() > _maxMemory )
+        {
+            return;
+        }
+        std::vector< uint8_t >( data ).swap( data ); // trim the capacity
+
+        lunchbox::ScopedWrite mutex( _lock );
+        if( _entries.count( cacheId ))
+            return;
+
+        _lru.push_front( cacheId );
+        Entry& entry = _entries[ cacheId ];
+        entry.data.swap( data );
+        entry.size = size;
+        entry.lru = _lru.begin();
+        _usedMemory += entry.data.size();
+        _uncompressedMemory += size;
+
+        while( _usedMemory > _maxMemory && !_lru.empty( ))
+            _remove( _entries.find( _lru.back( )));
+    }
+
+    bool contains( const CacheId cacheId ) const
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        return _entries.count( cacheId );
+    }
+
+    size_t getUsedMemory() const
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        return _usedMemory;
+    }
+
+    size_t getUncompressedMemory() const
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        return _uncompressedMemory;
+    }
+
+    size_t getMaximumMemory() const { return _maxMemory; }
+
+private:
+    void _remove( EntryMap::iterator i )
+    {
+        _usedMemory -= i->second.data.size();
+        _uncompressedMemory -= i->second.size;
+        _lru.erase( i->second.lru );
+        _entries.erase( i );
+    }
+
+    const size_t _maxMemory;
+    size_t _usedMemory;
+    size_t _uncompressedMemory;
+    EntryMap _entries;
+    std::list< CacheId > _lru; // most recently stored first
+    mutable lunchbox::Lock _lock;
+};
+
+}
+
+CompressedCache::CompressedCache( const size_t maxMemory )
+    : _impl( new detail::CompressedCache( maxMemory ))
+{
+}
+
+CompressedCache::~CompressedCache()
+{
+    delete _impl;
+}
+
+bool CompressedCache::isSupported()
+{
+    return isBrickCompressionSupported( BRICK_COMPRESSION_LZ4 );
+}
+
+bool CompressedCache::load( const CacheId cacheId, const size_t size,
+                            AllocMemoryUnit& memory )
+{
+    return _impl->load( cacheId, size, memory );
+}
+
+void CompressedCache::store( const CacheId cacheId, const MemoryUnit& memory )
+{
+    _impl->store( cacheId, memory );
+}
+
+bool CompressedCache::contains( const CacheId cacheId ) const
+{
+    return _impl->contains( cacheId );
+}
+
+size_t CompressedCache::getUsedMemory() const
+{
+    return _impl->getUsedMemory();
+}
+
+size_t CompressedCache::getUncompressedMemory() const
+{
+    return _impl->getUncompressedMemory();
+}
+
+size_t CompressedCache::getMaximumMemory() const
+{
+    return _impl->getMaximumMemory();
+}
+
+}
@@ -0,0 +1,93 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _CompressedCache_h_
+#define _CompressedCache_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+
+namespace livre
+{
+
+namespace detail
+{
+    class CompressedCache;
+}
+
+/**
+ * Cache tier between the TextureDataCache and the disk cache or data source,
+ * keeping the bricks evicted from the TextureDataCache LZ4 compressed in
+ * memory.
+ *
+ * The tier is exclusive: a brick is removed from it when it is loaded back into
+ * the TextureDataCache. Bricks which do not compress are not stored, as they
+ * would not save any memory. The least recently stored bricks are removed when
+ * the compressed bricks exceed the maximum memory.
+ *
+ * All methods are thread safe.
+ */
+class CompressedCache
+{
+public:
+    /**
+     * @param maxMemory The maximum memory of the compressed bricks in bytes.
+     */
+    LIVRE_API explicit CompressedCache( size_t maxMemory );
+    LIVRE_API ~CompressedCache();
+
+    /** @return true if the compression is supported by this build. */
+    LIVRE_API static bool isSupported();
+
+    /**
+     * Decompress a brick from the cache, and remove it from the cache.
+     * @param cacheId The cache id of the brick.
+     * @param size The uncompressed size of the brick in bytes.
+     * @param memory The memory unit to decompress the brick into.
+     * @return true if the brick was read, false if it is not cached.
+     */
+    LIVRE_API bool load( CacheId cacheId, size_t size,
+                         AllocMemoryUnit& memory );
+
+    /**
+     * Compress a brick into the cache, if it is not already cached.
+     * @param cacheId The cache id of the brick.
+     * @param memory The brick data.
+     */
+    LIVRE_API void store( CacheId cacheId, const MemoryUnit& memory );
+
+    /** @return true if the brick is cached. */
+    LIVRE_API bool contains( CacheId cacheId ) const;
+
+    /** @return the size of the compressed bricks in bytes. */
+    LIVRE_API size_t getUsedMemory() const;
+
+    /** @return the uncompressed size of the cached bricks in bytes. */
+    LIVRE_API size_t getUncompressedMemory() const;
+
+    /** @return the maximum memory of the compressed bricks in bytes. */
+    LIVRE_API size_t getMaximumMemory() const;
+
+private:
+    detail::CompressedCache* _impl;
+};
+
+}
+
+#endif // _CompressedCache_h_
@@ -0,0 +1,299 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/cache/DiskCache.h>
+
+#include <livre/core/data/MemoryUnit.h>
+
+#include <lunchbox/lock.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/uint128_t.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <list>
+
+namespace fs = boost::filesystem;
+
+namespace livre
+{
+
+namespace
+{
+const std::string BRICK_EXTENSION = ".brick";
+const std::string TEMP_EXTENSION = ".tmp";
+const char FORMAT_SEPARATOR = '-';
+}
+
+namespace detail
+{
+
+class DiskCache
+{
+    /** A brick is identified by its cache id and its format */
+    typedef std::pair< CacheId, uint32_t > Key;
+    typedef std::list< Key > KeyList;
+
+    struct Entry
+    {
+        size_t size;
+        KeyList::iterator lru;
+    };
+    typedef boost::unordered_map< Key, Entry > EntryMap;
+
+public:
+    DiskCache( const std::string& directory, const std::string& name,
+               const size_t maxMemory )
+        : _directory( fs::path( directory ) /
+                      lunchbox::make_uint128( name ).getString( ))
+        , _maxMemory( maxMemory )
+        , _usedMemory( 0 )
+    {
+        boost::system::error_code error;
+        fs::create_directories( _directory, error );
+        if( !fs::is_directory( _directory ))
+            LBTHROW( std::runtime_error( "Cannot create disk cache directory " +
+                                         _directory.string( )));
+        _scan();
+        LBINFO << "Disk cache " << _directory.string() << " holds "
+               << _entries.size() << " bricks, " << _usedMemory / LB_1MB
+               << "/" << _maxMemory / LB_1MB << " MB" << std::endl;
+    }
+
+    bool load( const CacheId cacheId, const uint32_t format,
+               const size_t size, AllocMemoryUnit& memory )
+    {
+        const Key key( cacheId, format );
+        {
+            lunchbox::ScopedWrite mutex( _lock );
+            EntryMap::iterator i = _entries.find( key );
+            if( i == _entries.end( ))
+                return false;
+            if( i->second.size < size )
+            {
+                LBWARN << "Disk cache brick " << cacheId << " has only "
+                       << i->second.size << " of " << size << " bytes"
+                       << std::endl;
+                _remove( i );
+                return false;
+            }
+            _lru.splice( _lru.begin(), _lru, i->second.lru );
+        }
+
+        const fs::path path = _getPath( key );
+        memory.alloc( size );
+        std::ifstream file( path.string().c_str(), std::ios::binary );
+        if( !file.read( memory.getData< char >(), size ))
+        {
+            lunchbox::ScopedWrite mutex( _lock );
+            EntryMap::iterator i = _entries.find( key );
+            if( i != _entries.end( ))
+                _remove( i );
+            return false;
+        }
+
+        // keep the usage order for the next session
+        boost::system::error_code error;
+        fs::last_write_time( path, std::time( 0 ), error );
+        return true;
+    }
+
+    void store( const CacheId cacheId, const uint32_t format,
+                const MemoryUnit& memory )
+    {
+        const Key key( cacheId, format );
+        const size_t size = memory.getMemSize();
+        if( size == 0 || size > _maxMemory || contains( cacheId, format ))
+            return;
+
+        // write to a unique temporary file and rename it, so a concurrent or
+        // interrupted write never leaves a partial brick behind
+        const fs::path tmpPath = _directory /
+                                 fs::unique_path( "%%%%%%%%" + TEMP_EXTENSION );
+        {
+            std::ofstream file( tmpPath.string().c_str(), std::ios::binary );
+            if( !file.write( memory.getData< char >(), size ))
+            {
+                LBWARN << "Cannot write disk cache brick " << tmpPath.string()
+                       << std::endl;
+                file.close();
+                boost::system::error_code error;
+                fs::remove( tmpPath, error );
+                return;
+            }
+        }
+
+        lunchbox::ScopedWrite mutex( _lock );
+        boost::system::error_code error;
+        fs::rename( tmpPath, _getPath( key ), error );
+        if( error )
+        {
+            fs::remove( tmpPath, error );
+            return;
+        }
+        if( _entries.count( key ))
+            return;
+        _add( key, size );
+        _evict();
+    }
+
+    bool contains( const CacheId cacheId, const uint32_t format ) const
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        return _entries.count( Key( cacheId, format ));
+    }
+
+    size_t getUsedMemory() const
+    {
+        lunchbox::ScopedWrite mutex( _lock );
+        return _usedMemory;
+    }
+
+    size_t getMaximumMemory() const { return _maxMemory; }
+
+private:
+    fs::path _getPath( const Key& key ) const
+    {
+        std::ostringstream name;
+        name << std::hex << key.first << FORMAT_SEPARATOR << key.second
+             << BRICK_EXTENSION;
+        return _directory / name.str();
+    }
+
+    /** Rebuild the index from the bricks of a previous session */
+    void _scan()
+    {
+        typedef std::pair< std::time_t, Key > Brick;
+        std::vector< Brick > bricks;
+
+        boost::system::error_code error;
+        for( fs::directory_iterator i( _directory, error ), end;
+             !error && i != end; i.increment( error ))
+        {
+            const fs::path& path = i->path();
+            if( path.extension() == TEMP_EXTENSION )
+            {
+                fs::remove( path, error );
+                continue;
+            }
+            if( path.extension() != BRICK_EXTENSION )
+                continue;
+
+            std::istringstream name( path.stem().string( ));
+            Key key;
+            char separator = 0;
+            if( !( name >> std::hex >> key.first >> separator >> key.second ) ||
+                separator != FORMAT_SEPARATOR )
+            {
+                continue;
+            }
+
+            const std::time_t time = fs::last_write_time( path, error );
+            const uintmax_t size = fs::file_size( path, error );
+            if( error )
+                continue;
+            _add( key, size );
+            bricks.push_back( Brick( time, key ));
+        }
+
+        // oldest first, so the most recent brick ends up in front of the LRU
+        std::sort( bricks.begin(), bricks.end( ));
+        BOOST_FOREACH( const Brick& brick, bricks )
+        {
+            Entry& entry = _entries[ brick.second ];
+            _lru.splice( _lru.begin(), _lru, entry.lru );
+        }
+        _evict();
+    }
+
+    void _add( const Key& key, const size_t size )
+    {
+        _lru.push_front( key );
+        Entry& entry = _entries[ key ];
+        entry.size = size;
+        entry.lru = _lru.begin();
+        _usedMemory += size;
+    }
+
+    void _remove( EntryMap::iterator i )
+    {
+        boost::system::error_code error;
+        fs::remove( _getPath( i->first ), error );
+        _usedMemory -= i->second.size;
+        _lru.erase( i->second.lru );
+        _entries.erase( i );
+    }
+
+    void _evict()
+    {
+        while( _usedMemory > _maxMemory && !_lru.empty( ))
+            _remove( _entries.find( _lru.back( )));
+    }
+
+    const fs::path _directory;
+    const size_t _maxMemory;
+    size_t _usedMemory;
+    EntryMap _entries;
+    KeyList _lru; // most recently used first
+    mutable lunchbox::Lock _lock;
+};
+
+}
+
+DiskCache::DiskCache( const std::string& directory, const std::string& name,
+                      const size_t maxMemory )
+    : _impl( new detail::DiskCache( directory, name, maxMemory ))
+{
+}
+
+DiskCache::~DiskCache()
+{
+    delete _impl;
+}
+
+bool DiskCache::load( const CacheId cacheId, const uint32_t format,
+                      const size_t size, AllocMemoryUnit& memory )
+{
+    return _impl->load( cacheId, format, size, memory );
+}
+
+void DiskCache::store( const CacheId cacheId, const uint32_t format,
+                       const MemoryUnit& memory )
+{
+    _impl->store( cacheId, format, memory );
+}
+
+bool DiskCache::contains( const CacheId cacheId, const uint32_t format ) const
+{
+    return _impl->contains( cacheId, format );
+}
+
+size_t DiskCache::getUsedMemory() const
+{
+    return _impl->getUsedMemory();
+}
+
+size_t DiskCache::getMaximumMemory() const
+{
+    return _impl->getMaximumMemory();
+}
+
+}
@@ -0,0 +1,97 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _DiskCache_h_
+#define _DiskCache_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+
+namespace livre
+{
+
+namespace detail
+{
+    class DiskCache;
+}
+
+/**
+ * Second cache tier storing the bricks evicted from the TextureDataCache on
+ * disk.
+ *
+ * The bricks of a volume are stored as one file per brick in a subdirectory of
+ * the cache directory, named after a hash of the volume name (typically the
+ * data source URI). A brick is identified by its cache id and its format, so
+ * the bricks written with other settings, e.g. another GPU data type, are not
+ * read back. The directory is scanned on construction, so bricks
+ * written by a previous session are found again. The least recently used
+ * bricks are removed when the cache exceeds its maximum size.
+ *
+ * All methods are thread safe.
+ */
+class DiskCache
+{
+public:
+    /**
+     * @param directory The cache directory, created if needed.
+     * @param name The unique name of the volume, e.g. its URI.
+     * @param maxMemory The maximum size of the cache on disk in bytes.
+     * @throw std::runtime_error if the cache directory cannot be created.
+     */
+    LIVRE_API DiskCache( const std::string& directory, const std::string& name,
+                         size_t maxMemory );
+    LIVRE_API ~DiskCache();
+
+    /**
+     * Read a brick from the cache.
+     * @param cacheId The cache id of the brick.
+     * @param format The format of the brick data.
+     * @param size The number of bytes to read, at most the stored size.
+     * @param memory The memory unit to read the brick into.
+     * @return true if the brick was read, false if it is not cached.
+     */
+    LIVRE_API bool load( CacheId cacheId, uint32_t format, size_t size,
+                         AllocMemoryUnit& memory );
+
+    /**
+     * Write a brick into the cache, if it is not already cached.
+     * @param cacheId The cache id of the brick.
+     * @param format The format of the brick data, e.g. a combination of its
+     *        data type and quantization.
+     * @param memory The brick data.
+     */
+    LIVRE_API void store( CacheId cacheId, uint32_t format,
+                          const MemoryUnit& memory );
+
+    /** @return true if the brick is cached in the given format. */
+    LIVRE_API bool contains( CacheId cacheId, uint32_t format ) const;
+
+    /** @return the size of the cached bricks in bytes. */
+    LIVRE_API size_t getUsedMemory() const;
+
+    /** @return the maximum size of the cache in bytes. */
+    LIVRE_API size_t getMaximumMemory() const;
+
+private:
+    detail::DiskCache* _impl;
+};
+
+}
+
+#endif // _DiskCache_h_
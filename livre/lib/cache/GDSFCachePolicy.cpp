@@ -0,0 +1,129 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/cache/Cache.h>
+#include <livre/core/cache/CacheObject.h>
+
+#include <livre/lib/cache/GDSFCachePolicy.h>
+
+#include <lunchbox/scopedMutex.h>
+
+namespace livre
+{
+
+namespace
+{
+typedef std::pair< double, CacheObject* > Candidate;
+
+bool _lowerPriority( const Candidate& candidate1, const Candidate& candidate2 )
+{
+    return candidate1.first < candidate2.first;
+}
+}
+
+GDSFCachePolicy::GDSFCachePolicy()
+    : maxMemoryInBytes_( 0 ),
+      cleanUpRatio_( 1.0 ),
+      inflation_( 0.0 ),
+      generation_( 0 )
+{}
+
+void GDSFCachePolicy::setMaximumMemory( const size_t maxMemoryInBytes )
+{
+    maxMemoryInBytes_ = ssize_t( maxMemoryInBytes );
+}
+
+void GDSFCachePolicy::setCleanupRatio( float cleanUpRatio )
+{
+   cleanUpRatio_ = cleanUpRatio;
+}
+
+bool GDSFCachePolicy::willPolicyBeActivated( const Cache& cache ) const
+{
+    const size_t usedMemoryInBytes = cache.getStatistics().getUsedMemory();
+    return usedMemoryInBytes >= size_t( maxMemoryInBytes_ );
+}
+
+bool GDSFCachePolicy::isPolicySatisfied( const Cache& cache ) const
+{
+    const size_t usedMemoryInBytes = cache.getStatistics().getUsedMemory();
+    return usedMemoryInBytes < ( 1.0f - cleanUpRatio_ ) *
+           size_t( maxMemoryInBytes_ );
+}
+
+void GDSFCachePolicy::apply_( const Cache& cache LB_UNUSED,
+                              const std::vector< CacheObject * >& cacheObjectList,
+                              std::vector< CacheObject * >& modifiedObjectList )
+{
+    lunchbox::ScopedWrite mutex( lock_ );
+    ++generation_;
+
+    std::vector< CacheObject* > changedObjects;
+    BOOST_FOREACH( CacheObject* cacheObject, cacheObjectList )
+    {
+        Priority& priority = priorities_[ cacheObject->getCacheID() ];
+        if( priority.generation == 0 ||
+            priority.lastUsed != cacheObject->getLastUsed( ))
+        {
+            changedObjects.push_back( cacheObject );
+        }
+        priority.generation = generation_;
+    }
+
+    // Objects not loaded anymore were unloaded since the last run: L becomes
+    // the highest of their priorities
+    for( PriorityMap::iterator it = priorities_.begin();
+         it != priorities_.end(); )
+    {
+        if( it->second.generation == generation_ )
+        {
+            ++it;
+            continue;
+        }
+        inflation_ = std::max( inflation_, it->second.value );
+        it = priorities_.erase( it );
+    }
+
+    BOOST_FOREACH( CacheObject* cacheObject, changedObjects )
+    {
+        Priority& priority = priorities_[ cacheObject->getCacheID() ];
+        const double uses = std::max( cacheObject->getUseCount(), 1u );
+        const double cost = std::max( cacheObject->getLoadTime(), 0.001 );
+        const double sizeMB = double( std::max( cacheObject->getCacheSize(),
+                                                size_t( 1 ))) / LB_1MB;
+        priority.value = inflation_ + uses * cost / sizeMB;
+        priority.lastUsed = cacheObject->getLastUsed();
+    }
+
+    std::vector< Candidate > candidates;
+    candidates.reserve( cacheObjectList.size() );
+    BOOST_FOREACH( CacheObject* cacheObject, cacheObjectList )
+    {
+        if( !cacheObject->isPinned() )
+            candidates.push_back( Candidate(
+                priorities_[ cacheObject->getCacheID() ].value, cacheObject ));
+    }
+    std::sort( candidates.begin(), candidates.end(), _lowerPriority );
+
+    modifiedObjectList.reserve( candidates.size() );
+    BOOST_FOREACH( const Candidate& candidate, candidates )
+        modifiedObjectList.push_back( candidate.second );
+}
+
+}
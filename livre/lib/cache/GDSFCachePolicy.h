@@ -0,0 +1,98 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _GDSFCachePolicy_h_
+#define _GDSFCachePolicy_h_
+
+#include <livre/core/cache/CachePolicy.h>
+
+#include <lunchbox/atomic.h>
+#include <lunchbox/lock.h>
+
+namespace livre
+{
+
+/**
+ * The GDSFCachePolicy class provides \see Cache class, Greedy Dual Size
+ * Frequency unloading policy.
+ *
+ * Each object has the priority L + uses * loadTime / size, computed when it was
+ * last used, where L is the highest priority of the unloaded objects. Objects
+ * with the lowest priority are unloaded first, so objects which are cheap to
+ * load again, large or rarely used go before expensive ones. L ages the
+ * priorities of objects which are not used anymore.
+ */
+class GDSFCachePolicy : public CachePolicy
+{
+public:
+
+    GDSFCachePolicy( );
+
+    /**
+     * Checks whether the policy will be activated for current state of \see Cache.
+     * @param cache The \see Cache to check for the policy.
+     * @return True if the limitations are passed.
+     */
+    virtual bool willPolicyBeActivated( const Cache& cache ) const;
+
+    /**
+     * Checks whether the policy satisfied after each unload.
+     * @param cache The \see Cache to check for the policy.
+     * @return True if the limitations are satisfied.
+     */
+    virtual bool isPolicySatisfied( const Cache& cache ) const;
+
+    /**
+     * Sets the maximum memory.
+     * @param maxMemoryInBytes Maximum memory in bytes.
+     */
+    void setMaximumMemory( const size_t maxMemoryInBytes );
+
+    /**
+     * Sets the clean up ratio.
+     * @param cleanUpRatio Once the policy is activated, ( 1.0 - cleanUpRatio ) can be cleaned.
+     */
+    void setCleanupRatio( float cleanUpRatio );
+
+private:
+
+    virtual void apply_( const Cache& cache,
+                         const std::vector< CacheObject * >& cacheObjectList,
+                         std::vector< CacheObject * >& modifiedObjectList );
+
+    struct Priority
+    {
+        double value;
+        double lastUsed; //!< CacheObject::getLastUsed() when computed
+        uint32_t generation; //!< Last apply_() seeing the object loaded
+    };
+    typedef boost::unordered_map< CacheId, Priority > PriorityMap;
+
+    lunchbox::a_ssize_t maxMemoryInBytes_;
+    float cleanUpRatio_;
+
+    lunchbox::Lock lock_;
+    PriorityMap priorities_;
+    double inflation_; //!< The L value
+    uint32_t generation_;
+};
+
+}
+
+#endif // _GDSFCachePolicy_h_
@@ -0,0 +1,216 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/cache/Cache.h>
+#include <livre/core/cache/CacheObject.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/LODNodeTrait.h>
+
+#include <livre/lib/cache/ImportanceCachePolicy.h>
+
+#include <lunchbox/scopedMutex.h>
+
+namespace livre
+{
+
+namespace
+{
+const double OUT_OF_VIEW_WEIGHT = 0.1;
+const double COVERED_WEIGHT = 0.25;
+const double UNUSED_CHILD_WEIGHT = 0.5;
+
+struct Candidate
+{
+    double score;
+    double lastUsed;
+    uint32_t level;
+    CacheObject* cacheObject;
+};
+
+bool _lowerScore( const Candidate& candidate1, const Candidate& candidate2 )
+{
+    if( candidate1.score != candidate2.score )
+        return candidate1.score < candidate2.score;
+    return candidate1.lastUsed < candidate2.lastUsed;
+}
+
+typedef boost::unordered_map< CacheId, const CacheObject* > LoadedObjectMap;
+
+ConstLODNodePtr _getLODNode( const CacheObject& cacheObject )
+{
+    const LODNodeTrait* lodNodeTrait =
+        dynamic_cast< const LODNodeTrait* >( &cacheObject );
+    if( !lodNodeTrait )
+        return ConstLODNodePtr();
+
+    ConstLODNodePtr lodNode = lodNodeTrait->getLODNode();
+    return lodNode && lodNode->isValid() ? lodNode : ConstLODNodePtr();
+}
+
+double _getRedundancy( const CacheObject& cacheObject, const NodeId& nodeId,
+                       const LoadedObjectMap& loadedObjects )
+{
+    const double lastUsed = cacheObject.getLastUsed();
+
+    // Covered by children which are rendered instead of this node
+    bool covered = true;
+    BOOST_FOREACH( const NodeId& childId, nodeId.getChildren( ))
+    {
+        LoadedObjectMap::const_iterator it =
+            loadedObjects.find( childId.getId( ));
+        if( it == loadedObjects.end() || it->second->getLastUsed() < lastUsed )
+        {
+            covered = false;
+            break;
+        }
+    }
+    if( covered )
+        return COVERED_WEIGHT;
+
+    // Unused since the parent is rendered instead of this node
+    if( !nodeId.isRoot( ))
+    {
+        LoadedObjectMap::const_iterator it =
+            loadedObjects.find( nodeId.getParent().getId( ));
+        if( it != loadedObjects.end() && it->second->getLastUsed() > lastUsed )
+            return UNUSED_CHILD_WEIGHT;
+    }
+    return 1.0;
+}
+}
+
+ImportanceCachePolicy::ImportanceCachePolicy()
+    : maxMemoryInBytes_( 0 ),
+      cleanUpRatio_( 1.0 )
+{}
+
+void ImportanceCachePolicy::setMaximumMemory( const size_t maxMemoryInBytes )
+{
+    maxMemoryInBytes_ = ssize_t( maxMemoryInBytes );
+}
+
+void ImportanceCachePolicy::setCleanupRatio( float cleanUpRatio )
+{
+   cleanUpRatio_ = cleanUpRatio;
+}
+
+void ImportanceCachePolicy::setFrustum( const Frustum& frustum )
+{
+    lunchbox::ScopedWrite mutex( lock_ );
+    frustum_ = frustum;
+}
+
+void ImportanceCachePolicy::setLevelReservation( const uint32_t level,
+                                                 const size_t reservedBytes )
+{
+    lunchbox::ScopedWrite mutex( lock_ );
+    if( level >= levelReservations_.size( ))
+        levelReservations_.resize( level + 1, 0 );
+    levelReservations_[ level ] = reservedBytes;
+}
+
+void ImportanceCachePolicy::clearLevelReservations()
+{
+    lunchbox::ScopedWrite mutex( lock_ );
+    levelReservations_.clear();
+}
+
+bool ImportanceCachePolicy::willPolicyBeActivated( const Cache& cache ) const
+{
+    const size_t usedMemoryInBytes = cache.getStatistics().getUsedMemory();
+    return usedMemoryInBytes >= size_t( maxMemoryInBytes_ );
+}
+
+bool ImportanceCachePolicy::isPolicySatisfied( const Cache& cache ) const
+{
+    const size_t usedMemoryInBytes = cache.getStatistics().getUsedMemory();
+    return usedMemoryInBytes < ( 1.0f - cleanUpRatio_ ) *
+           size_t( maxMemoryInBytes_ );
+}
+
+double ImportanceCachePolicy::getImportance_( const LODNode& lodNode ) const
+{
+    if( !frustum_.isInitialized( ))
+        return 1.0;
+
+    // The on-screen size of the voxels of the node
+    const Boxf& worldBox = lodNode.getWorldBox();
+    const double importance = frustum_.getProjectedHeight( worldBox ) /
+                              lodNode.getBlockSize().y();
+    return frustum_.boxInFrustum( worldBox ) ? importance
+                                             : importance * OUT_OF_VIEW_WEIGHT;
+}
+
+void ImportanceCachePolicy::apply_(
+    const Cache& cache LB_UNUSED,
+    const std::vector< CacheObject * >& cacheObjectList,
+    std::vector< CacheObject * >& modifiedObjectList )
+{
+    lunchbox::ScopedWrite mutex( lock_ );
+
+    LoadedObjectMap loadedObjects;
+    std::vector< size_t > levelMemory( levelReservations_.size(), 0 );
+    BOOST_FOREACH( const CacheObject* cacheObject, cacheObjectList )
+    {
+        loadedObjects[ cacheObject->getCacheID() ] = cacheObject;
+        ConstLODNodePtr lodNode = _getLODNode( *cacheObject );
+        const uint32_t level = lodNode ? lodNode->getRefLevel() : INVALID_LEVEL;
+        if( level < levelMemory.size( ))
+            levelMemory[ level ] += cacheObject->getCacheSize();
+    }
+
+    std::vector< Candidate > candidates;
+    candidates.reserve( cacheObjectList.size() );
+    BOOST_FOREACH( CacheObject* cacheObject, cacheObjectList )
+    {
+        if( cacheObject->isPinned() )
+            continue;
+
+        Candidate candidate = { 1.0, cacheObject->getLastUsed(), INVALID_LEVEL,
+                                cacheObject };
+        ConstLODNodePtr lodNode = _getLODNode( *cacheObject );
+        if( lodNode )
+        {
+            const NodeId nodeId = lodNode->getNodeId();
+            candidate.level = nodeId.getLevel();
+            candidate.score = getImportance_( *lodNode ) *
+                              _getRedundancy( *cacheObject, nodeId,
+                                              loadedObjects );
+        }
+        candidates.push_back( candidate );
+    }
+    std::sort( candidates.begin(), candidates.end(), _lowerScore );
+
+    modifiedObjectList.reserve( candidates.size() );
+    BOOST_FOREACH( const Candidate& candidate, candidates )
+    {
+        if( candidate.level < levelMemory.size( ))
+        {
+            // Keep the level within its reservation
+            size_t& memory = levelMemory[ candidate.level ];
+            const size_t size = candidate.cacheObject->getCacheSize();
+            if( memory - size < levelReservations_[ candidate.level ] )
+                continue;
+            memory -= size;
+        }
+        modifiedObjectList.push_back( candidate.cacheObject );
+    }
+}
+
+}
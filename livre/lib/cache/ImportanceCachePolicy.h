@@ -0,0 +1,124 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ImportanceCachePolicy_h_
+#define _ImportanceCachePolicy_h_
+
+#include <livre/lib/api.h>
+#include <livre/core/cache/CachePolicy.h>
+#include <livre/core/render/Frustum.h>
+
+#include <lunchbox/atomic.h>
+#include <lunchbox/lock.h>
+
+namespace livre
+{
+
+/**
+ * The ImportanceCachePolicy class provides \see Cache class, an unloading
+ * policy for the objects of an octree, e.g. \see TextureObject.
+ *
+ * Objects are unloaded by increasing score, the product of:
+ * - the view importance: the projected size of a voxel of the node as a
+ *   fraction of the viewport height, from the distance to the near plane and
+ *   the frustum limits as in \see ScreenSpaceLODEvaluator. Nodes outside of
+ *   the frustum are weighted down.
+ * - the hierarchy redundancy: a node whose children are all loaded and used
+ *   since the node is covered by them, and a node unused since its parent was
+ *   used is not rendered anymore. Both are weighted down.
+ * Objects with the same score are unloaded least recently used first. Objects
+ * which are not \see LODNodeTrait have a neutral score.
+ *
+ * Levels can reserve a part of the memory, their objects are not unloaded
+ * while the level uses less than its reservation, which keeps the coarse
+ * levels resident as fallback.
+ */
+class ImportanceCachePolicy : public CachePolicy
+{
+public:
+
+    LIVRE_API ImportanceCachePolicy( );
+
+    /**
+     * Checks whether the policy will be activated for current state of
+     * \see Cache.
+     * @param cache The \see Cache to check for the policy.
+     * @return True if the limitations are passed.
+     */
+    virtual bool willPolicyBeActivated( const Cache& cache ) const;
+
+    /**
+     * Checks whether the policy satisfied after each unload.
+     * @param cache The \see Cache to check for the policy.
+     * @return True if the limitations are satisfied.
+     */
+    virtual bool isPolicySatisfied( const Cache& cache ) const;
+
+    /**
+     * Sets the maximum memory.
+     * @param maxMemoryInBytes Maximum memory in bytes.
+     */
+    LIVRE_API void setMaximumMemory( const size_t maxMemoryInBytes );
+
+    /**
+     * Sets the clean up ratio.
+     * @param cleanUpRatio Once the policy is activated, ( 1.0 - cleanUpRatio )
+     *                     can be cleaned.
+     */
+    LIVRE_API void setCleanupRatio( float cleanUpRatio );
+
+    /**
+     * Sets the view to compute the importance of the nodes for. Until a view
+     * is set, only the hierarchy and the recency are taken into account.
+     * @param frustum The current rendering frustum.
+     */
+    LIVRE_API void setFrustum( const Frustum& frustum );
+
+    /**
+     * Reserves memory for the objects of a tree level.
+     * @param level The tree level.
+     * @param reservedBytes The memory in bytes the level keeps, 0 to release.
+     */
+    LIVRE_API void setLevelReservation( const uint32_t level,
+                                        const size_t reservedBytes );
+
+    /**
+     * Releases the reservations of all levels.
+     */
+    LIVRE_API void clearLevelReservations( );
+
+private:
+
+    virtual void apply_( const Cache& cache,
+                         const std::vector< CacheObject * >& cacheObjectList,
+                         std::vector< CacheObject * >& modifiedObjectList );
+
+    double getImportance_( const LODNode& lodNode ) const;
+
+    lunchbox::a_ssize_t maxMemoryInBytes_;
+    float cleanUpRatio_;
+
+    lunchbox::Lock lock_;
+    Frustum frustum_;
+    std::vector< size_t > levelReservations_;
+};
+
+}
+
+#endif // _ImportanceCachePolicy_h_
@@ -18,38 +18,105 @@
  */
 
 #include <livre/lib/cache/LRUCache.h>
+#include <livre/core/cache/CacheObject.h>
+
+#include <lunchbox/scopedMutex.h>
 
 namespace livre
 {
 
 LRUCache::LRUCache()
+    : cachePolicy_( &lruPolicy_ )
+{
+    getStatistics().setPolicyName( "LRU" );
+}
+
+void LRUCache::setPolicy( const PolicyType policy )
+{
+    switch( policy )
+    {
+    case POLICY_LRU:
+        setPolicy_( lruPolicy_, "LRU" );
+        break;
+    case POLICY_GDSF:
+        setPolicy_( gdsfPolicy_, "GDSF" );
+        break;
+    case POLICY_IMPORTANCE:
+        LBWARN << "Importance policy is not supported by this cache, using lru"
+               << std::endl;
+        setPolicy_( lruPolicy_, "LRU" );
+        break;
+    }
+}
+
+void LRUCache::setPolicy_( CachePolicy& cachePolicy, const std::string& name )
 {
+    cachePolicy_ = &cachePolicy;
+    getStatistics().setPolicyName( name );
 }
 
-void LRUCache::onLoaded_( const CacheObject &cacheObject LB_UNUSED )
+LRUCache::PolicyType LRUCache::getPolicyType( const std::string& name )
 {
-    applyPolicy( cachePolicy_ );
+    if( name == "gdsf" )
+        return POLICY_GDSF;
+    if( name == "importance" )
+        return POLICY_IMPORTANCE;
+    if( name != "lru" )
+        LBWARN << "Unknown cache policy " << name << ", using lru" << std::endl;
+    return POLICY_LRU;
+}
+
+void LRUCache::onLoaded_( const CacheObject &cacheObject )
+{
+    Cache::onLoaded_( cacheObject );
+    {
+        lunchbox::ScopedWrite mutex( protectLock_ );
+        if( protectUnloadingList_.count( cacheObject.getCacheID( )))
+            const_cast< CacheObject& >( cacheObject ).setPinned( true );
+    }
+    applyPolicyOnLoad_( *cachePolicy_, cacheObject );
+}
+
+void LRUCache::setPinned_( const CacheId cacheId, const bool pinned ) const
+{
+    if( cacheId == INVALID_CACHE_ID )
+        return;
+
+    // Objects created later are pinned when loaded, see onLoaded_()
+    CacheObjectPtr cacheObject = getObjectFromCache_( cacheId );
+    if( cacheObject )
+        cacheObject->setPinned( pinned );
 }
 
 void LRUCache::setProtectList( const CacheIdSet& protectUnloadingList )
 {
-    cachePolicy_.setProtectList( protectUnloadingList );
+    lunchbox::ScopedWrite mutex( protectLock_ );
+    BOOST_FOREACH( const CacheId cacheId, protectUnloadingList_ )
+    {
+        if( !protectUnloadingList.count( cacheId ))
+            setPinned_( cacheId, false );
+    }
+    BOOST_FOREACH( const CacheId cacheId, protectUnloadingList )
+        setPinned_( cacheId, true );
+    protectUnloadingList_ = protectUnloadingList;
 }
 
 void LRUCache::clearProtectList( )
 {
-    cachePolicy_.setProtectList( CacheIdSet() );
+    setProtectList( CacheIdSet() );
 }
 
 void LRUCache::setMaximumMemory( const size_t maxMemoryInBytes )
 {
-    cachePolicy_.setMaximumMemory( maxMemoryInBytes );
+    lruPolicy_.setMaximumMemory( maxMemoryInBytes );
+    gdsfPolicy_.setMaximumMemory( maxMemoryInBytes );
     getStatistics().setMaximumMemory( maxMemoryInBytes );
 }
 
 void LRUCache::setCleanupRatio( float cleanUpRatio )
 {
-   cachePolicy_.setCleanupRatio( cleanUpRatio );
+   lruPolicy_.setCleanupRatio( cleanUpRatio );
+   gdsfPolicy_.setCleanupRatio( cleanUpRatio );
 }
 
 }
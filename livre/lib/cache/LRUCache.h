@@ -22,6 +22,7 @@
 
 #include <livre/lib/api.h>
 #include <livre/core/cache/Cache.h>
+#include <livre/lib/cache/GDSFCachePolicy.h>
 #include <livre/lib/cache/LRUCachePolicy.h>
 
 namespace livre
@@ -30,12 +31,36 @@ namespace livre
 /**
  * The LRUCache class, implementation of the \see Cache with Least Recently Used policy to unload nodes. The
  * derived class should implement the abstract method(s) of \see Cache.
+ * Alternatively, the cost-aware \see GDSFCachePolicy can be selected.
  */
 class LRUCache : public Cache
 {
 public:
+    /** The policies to unload nodes */
+    enum PolicyType
+    {
+        POLICY_LRU, //!< Least recently used, @sa LRUCachePolicy
+        POLICY_GDSF, //!< Greedy dual size frequency, @sa GDSFCachePolicy
+        POLICY_IMPORTANCE //!< View importance, @sa ImportanceCachePolicy
+    };
+
+    /**
+     * Selects the policy to unload nodes, LRU by default. POLICY_IMPORTANCE is
+     * only supported by the caches providing it, e.g. \see TextureCache, the
+     * others fall back to LRU.
+     * @param policy The policy type.
+     */
+    LIVRE_API virtual void setPolicy( PolicyType policy );
+
     /**
-     * Sets a list of node ids to be protected from unloading.
+     * @param name The name of a policy, "lru", "gdsf" or "importance".
+     * @return The policy type, POLICY_LRU for unknown names.
+     */
+    LIVRE_API static PolicyType getPolicyType( const std::string& name );
+
+    /**
+     * Sets a list of node ids to be protected from unloading. The objects are
+     * pinned, and the objects of the previous list are unpinned.
      * @param protectUnloadingList The set of node ids.
      */
     LIVRE_API void setProtectList( const CacheIdSet& protectUnloadingList );
@@ -49,20 +74,34 @@ public:
      * Sets the maximum memory.
      * @param maxMemoryInBytes Maximum memory in bytes.
      */
-    LIVRE_API void setMaximumMemory( const size_t maxMemoryInBytes );
+    LIVRE_API virtual void setMaximumMemory( const size_t maxMemoryInBytes );
 
     /**
      * Sets the clean up ratio.
      * @param cleanUpRatio Once the policy is activated, ( 1.0 - cleanUpRatio ) can be cleaned.
      */
-    LIVRE_API void setCleanupRatio( float cleanUpRatio );
+    LIVRE_API virtual void setCleanupRatio( float cleanUpRatio );
 
 protected:
     LIVRE_API LRUCache();
 
+    /**
+     * Selects a policy provided by the derived class to unload nodes.
+     * @param cachePolicy The policy, kept by the derived class.
+     * @param name The name of the policy for the statistics.
+     */
+    LIVRE_API void setPolicy_( CachePolicy& cachePolicy,
+                               const std::string& name );
+
 private:
     LIVRE_API void onLoaded_( const CacheObject &cacheObject );
-    LRUCachePolicy cachePolicy_;
+    void setPinned_( const CacheId cacheId, const bool pinned ) const;
+
+    LRUCachePolicy lruPolicy_;
+    GDSFCachePolicy gdsfPolicy_;
+    CachePolicy* cachePolicy_;
+    CacheIdSet protectUnloadingList_;
+    lunchbox::Lock protectLock_;
 };
 
 }
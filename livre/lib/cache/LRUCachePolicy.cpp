@@ -25,27 +25,14 @@
 namespace livre
 {
 
-struct LastUsedOrderOperator
-{
-    bool operator()( const CacheObject* object1, const CacheObject* object2 )
-    {
-        return  object1->getLastUsed( ) < object2->getLastUsed( );
-    }
-};
-
 LRUCachePolicy::LRUCachePolicy()
     : maxMemoryInBytes_( 0 ),
       cleanUpRatio_( 1.0 )
 {}
 
-void LRUCachePolicy::setProtectList( const CacheIdSet& protectUnloadingList )
-{
-    protectUnloadingList_ = protectUnloadingList;
-}
-
 void LRUCachePolicy::setMaximumMemory( const size_t maxMemoryInBytes )
 {
-    maxMemoryInBytes_ = maxMemoryInBytes;
+    maxMemoryInBytes_ = ssize_t( maxMemoryInBytes );
 }
 
 void LRUCachePolicy::setCleanupRatio( float cleanUpRatio )
@@ -56,34 +43,21 @@ void LRUCachePolicy::setCleanupRatio( float cleanUpRatio )
 bool LRUCachePolicy::willPolicyBeActivated( const Cache& cache ) const
 {
     const size_t usedMemoryInBytes = cache.getStatistics().getUsedMemory();
-    return usedMemoryInBytes >= maxMemoryInBytes_;
+    return usedMemoryInBytes >= size_t( maxMemoryInBytes_ );
 }
 
 bool LRUCachePolicy::isPolicySatisfied( const Cache& cache ) const
 {
     const size_t usedMemoryInBytes = cache.getStatistics().getUsedMemory();
-    return usedMemoryInBytes < ( 1.0f - cleanUpRatio_ ) * maxMemoryInBytes_;
+    return usedMemoryInBytes < ( 1.0f - cleanUpRatio_ ) *
+           size_t( maxMemoryInBytes_ );
 }
 
-void LRUCachePolicy::apply_( const Cache& cache LB_UNUSED,
-                             const std::vector< CacheObject * >& cacheObjectList,
-                             std::vector< CacheObject * >& modifiedObjectList )
+void LRUCachePolicy::apply_( const Cache&, const std::vector< CacheObject * >&,
+                             std::vector< CacheObject * >& )
 {
-    modifiedObjectList.reserve( cacheObjectList.size() );
-
-    for( std::vector< CacheObject *>::const_iterator it = cacheObjectList.begin();
-         it != cacheObjectList.end(); ++it )
-    {
-        CacheObject* cacheObject = *it;
-        const CacheIdSet::const_iterator& itCacheObject =
-                protectUnloadingList_.find( cacheObject->getCacheID() );
-        if( itCacheObject == protectUnloadingList_.end() )
-            modifiedObjectList.push_back( cacheObject );
-    }
-
-    std::sort( modifiedObjectList.begin( ), modifiedObjectList.end( ), LastUsedOrderOperator() );
-
+    // the cache selects the objects with its CLOCK, see isRecencyOrdered_()
+    LBDONTCALL;
 }
 
-
 }
@@ -22,6 +22,7 @@
 
 #include <livre/core/cache/CachePolicy.h>
 
+#include <lunchbox/atomic.h>
 
 namespace livre
 {
@@ -49,12 +50,6 @@ public:
      */
     virtual bool isPolicySatisfied( const Cache& cache ) const;
 
-    /**
-     * Sets a list of node ids to be protected from unloading.
-     * @param protectUnloadingList The set of node ids.
-     */
-    void setProtectList( const CacheIdSet& protectUnloadingList );
-
     /**
      * Sets the maximum memory.
      * @param maxMemoryInBytes Maximum memory in bytes.
@@ -69,14 +64,15 @@ public:
 
 private:
 
+    /** Not called, as the objects are unloaded in recency order. */
     virtual void apply_( const Cache& cache,
                          const std::vector< CacheObject * >& cacheObjectList,
                          std::vector< CacheObject * >& modifiedObjectList );
 
-    size_t maxMemoryInBytes_;
-    float cleanUpRatio_;
+    bool isRecencyOrdered_() const final { return true; }
 
-    CacheIdSet protectUnloadingList_;
+    lunchbox::a_ssize_t maxMemoryInBytes_; //!< Read by the upload threads
+    float cleanUpRatio_;
 };
 
 }
@@ -31,7 +31,8 @@ namespace livre
 {
 
 TextureCache::TextureCache( const GLint internalTextureFormat )
-    : texturePoolFactory_( internalTextureFormat )
+    : internalTextureFormat_( internalTextureFormat )
+    , texturePoolFactory_( internalTextureFormat )
 {
     statisticsPtr_->setStatisticsName( "Texture cache GPU");
 }
@@ -70,4 +71,79 @@ TexturePoolPtr TextureCache::getTexturePool( const Vector3i& maxBlockSize,
     return texturePoolFactory_.findTexturePool( maxBlockSize, format, gpuDataType );
 }
 
+size_t TextureCache::getTextureSize( const Vector3i& maxBlockSize ) const
+{
+    size_t bytesPerVoxel = 4;
+    switch( internalTextureFormat_ )
+    {
+    case GL_LUMINANCE8:
+    case GL_INTENSITY8:
+    case GL_ALPHA8:
+    case GL_R8:
+        bytesPerVoxel = 1;
+        break;
+    case GL_LUMINANCE16:
+    case GL_LUMINANCE8_ALPHA8:
+    case GL_R16:
+    case GL_R16F:
+    case GL_RG8:
+        bytesPerVoxel = 2;
+        break;
+    case GL_RGB8:
+        bytesPerVoxel = 3;
+        break;
+    case GL_R32F:
+    case GL_RGBA8:
+        bytesPerVoxel = 4;
+        break;
+    case GL_RGB16F:
+        bytesPerVoxel = 6;
+        break;
+    case GL_RGBA16F:
+        bytesPerVoxel = 8;
+        break;
+    case GL_RGB32F:
+        bytesPerVoxel = 12;
+        break;
+    case GL_RGBA32F:
+        bytesPerVoxel = 16;
+        break;
+    default: // other formats are assumed to be of 4 bytes per voxel
+        break;
+    }
+    return size_t( maxBlockSize[ 0 ] ) * maxBlockSize[ 1 ] * maxBlockSize[ 2 ] *
+           bytesPerVoxel;
+}
+
+void TextureCache::setPolicy( const PolicyType policy )
+{
+    if( policy == POLICY_IMPORTANCE )
+        setPolicy_( importancePolicy_, "Importance" );
+    else
+        LRUCache::setPolicy( policy );
+}
+
+void TextureCache::setMaximumMemory( const size_t maxMemoryInBytes )
+{
+    LRUCache::setMaximumMemory( maxMemoryInBytes );
+    importancePolicy_.setMaximumMemory( maxMemoryInBytes );
+}
+
+void TextureCache::setCleanupRatio( const float cleanUpRatio )
+{
+    LRUCache::setCleanupRatio( cleanUpRatio );
+    importancePolicy_.setCleanupRatio( cleanUpRatio );
+}
+
+void TextureCache::setFrustum( const Frustum& frustum )
+{
+    importancePolicy_.setFrustum( frustum );
+}
+
+void TextureCache::setLevelReservation( const uint32_t level,
+                                        const size_t reservedBytes )
+{
+    importancePolicy_.setLevelReservation( level, reservedBytes );
+}
+
 }
@@ -21,6 +21,7 @@
 #define _TextureCache_h_
 
 #include <livre/lib/types.h>
+#include <livre/lib/cache/ImportanceCachePolicy.h>
 #include <livre/lib/cache/LRUCache.h>
 #include <livre/core/render/TexturePoolFactory.h>
 
@@ -63,10 +64,51 @@ public:
                                    const uint32_t format,
                                    const uint32_t gpuDataType );
 
+    /**
+     * @param maxBlockSize Max block size of the texture.
+     * @return The GPU memory of a texture in bytes, in the internal format.
+     */
+    size_t getTextureSize( const Vector3i& maxBlockSize ) const;
+
+    /**
+     * Selects the policy to unload nodes, including POLICY_IMPORTANCE.
+     * @param policy The policy type.
+     */
+    void setPolicy( PolicyType policy ) override;
+
+    /**
+     * Sets the maximum memory.
+     * @param maxMemoryInBytes Maximum memory in bytes.
+     */
+    void setMaximumMemory( const size_t maxMemoryInBytes ) override;
+
+    /**
+     * Sets the clean up ratio.
+     * @param cleanUpRatio Once the policy is activated, ( 1.0 - cleanUpRatio )
+     *                     can be cleaned.
+     */
+    void setCleanupRatio( float cleanUpRatio ) override;
+
+    /**
+     * Sets the view the importance of the textures is computed for.
+     * @param frustum The current rendering frustum.
+     */
+    void setFrustum( const Frustum& frustum );
+
+    /**
+     * Reserves memory for the textures of a tree level, which are not unloaded
+     * by the importance policy while the level uses less.
+     * @param level The tree level.
+     * @param reservedBytes The memory in bytes the level keeps, 0 to release.
+     */
+    void setLevelReservation( uint32_t level, size_t reservedBytes );
+
 private:
 
     CacheObject *generateCacheObjectFromID_(const CacheId cacheID );
+    const int internalTextureFormat_;
     TexturePoolFactory texturePoolFactory_;
+    ImportanceCachePolicy importancePolicy_;
 };
 
 }
@@ -20,6 +20,7 @@
 
 #include <livre/lib/cache/TextureDataCache.h>
 #include <livre/lib/cache/TextureDataObject.h>
+#include <livre/lib/cache/TierWriter.h>
 
 #include <livre/core/data/LODNode.h>
 #include <livre/core/data/VolumeDataSource.h>
@@ -29,6 +30,11 @@
 
 namespace livre
 {
+namespace
+{
+// bricks evicted faster than written are dropped above this
+const size_t MAX_TIER_WRITER_MEMORY = 256 * LB_1MB;
+}
 
 TextureDataCache::TextureDataCache( VolumeDataSourcePtr volumeDataSourcePtr,
                                     const uint32_t type )
@@ -46,7 +52,11 @@ CacheObject* TextureDataCache::generateCacheObjectFromID_( const CacheId cacheID
     if( !lodNodePtr->isValid() )
         return static_cast< CacheObject* >( TextureDataObject::getEmptyPtr( ));
 
-    return new TextureDataObject( volumeDataSourcePtr_, lodNodePtr, type_ );
+    const CompressedCachePtr compressedCache =
+        type_ == GL_FLOAT ? CompressedCachePtr() : compressedCachePtr_;
+    return new TextureDataObject( volumeDataSourcePtr_, diskCachePtr_,
+                                  compressedCache, tierWriterPtr_, lodNodePtr,
+                                  type_ );
 }
 
 TextureDataObject& TextureDataCache::getNodeTextureData( const CacheId cacheId )
@@ -76,4 +86,22 @@ VolumeDataSourcePtr TextureDataCache::getDataSource()
     return volumeDataSourcePtr_;
 }
 
+void TextureDataCache::setDiskCache( DiskCachePtr diskCache )
+{
+    diskCachePtr_ = diskCache;
+    createTierWriter_();
+}
+
+void TextureDataCache::setCompressedCache( CompressedCachePtr compressedCache )
+{
+    compressedCachePtr_ = compressedCache;
+    createTierWriter_();
+}
+
+void TextureDataCache::createTierWriter_()
+{
+    if( !tierWriterPtr_ && ( diskCachePtr_ || compressedCachePtr_ ))
+        tierWriterPtr_.reset( new TierWriter( MAX_TIER_WRITER_MEMORY ));
+}
+
 }
@@ -58,6 +58,36 @@ public:
     /** @return the data source. */
     VolumeDataSourcePtr getDataSource();
 
+    /**
+     * Set the disk cache holding the evicted bricks, or unset it with an empty
+     * pointer. Only affects the objects created after the call. The bricks are
+     * written by the tier writer of this cache.
+     * @param diskCache The disk cache.
+     */
+    LIVRE_API void setDiskCache( DiskCachePtr diskCache );
+
+    /** @return the disk cache, may be empty. */
+    LIVRE_API DiskCachePtr getDiskCache() const { return diskCachePtr_; }
+
+    /**
+     * Set the compressed in-memory cache holding the evicted bricks, or unset
+     * it with an empty pointer. It is only used for 8 and 16 bit textures, and
+     * only affects the objects created after the call. The bricks are
+     * compressed by the tier writer of this cache.
+     * @param compressedCache The compressed cache.
+     */
+    LIVRE_API void setCompressedCache( CompressedCachePtr compressedCache );
+
+    /** @return the compressed cache, may be empty. */
+    LIVRE_API CompressedCachePtr getCompressedCache() const
+        { return compressedCachePtr_; }
+
+    /**
+     * @return the writer of the evicted bricks into the compressed and disk
+     *         caches, empty until one of them is set.
+     */
+    LIVRE_API TierWriterPtr getTierWriter() const { return tierWriterPtr_; }
+
     /**
      * @return The GPU data type.
      */
@@ -65,8 +95,12 @@ public:
 
 private:
     CacheObject *generateCacheObjectFromID_( const CacheId cacheID );
+    void createTierWriter_();
 
     VolumeDataSourcePtr volumeDataSourcePtr_;
+    DiskCachePtr diskCachePtr_;
+    CompressedCachePtr compressedCachePtr_;
+    TierWriterPtr tierWriterPtr_;
     const uint32_t type_;
 };
 
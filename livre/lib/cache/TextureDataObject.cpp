@@ -18,7 +18,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <livre/lib/cache/CompressedCache.h>
+#include <livre/lib/cache/DiskCache.h>
 #include <livre/lib/cache/TextureDataObject.h>
+#include <livre/lib/cache/TierWriter.h>
 
 #include <livre/core/data/LODNode.h>
 #include <livre/core/data/MemoryUnit.h>
@@ -32,19 +35,28 @@ namespace livre
 TextureDataObject::TextureDataObject()
     : CacheObject()
     , LODNodeTrait()
-    , data_( new AllocMemoryUnit( ))
+    , data_( new NoMemoryUnit( ))
     , dataSourcePtr_()
+    , diskCachePtr_()
+    , compressedCachePtr_()
+    , tierWriterPtr_()
     , gpuDataType_( 0 )
 {
 }
 
 TextureDataObject::TextureDataObject( VolumeDataSourcePtr dataSourcePtr,
+                                      DiskCachePtr diskCachePtr,
+                                      CompressedCachePtr compressedCachePtr,
+                                      TierWriterPtr tierWriterPtr,
                                       ConstLODNodePtr lodNodePtr,
                                       const uint32_t gpuDataType )
     : CacheObject()
     , LODNodeTrait( lodNodePtr )
-    , data_( new AllocMemoryUnit( ))
+    , data_( new NoMemoryUnit( ))
     , dataSourcePtr_( dataSourcePtr )
+    , diskCachePtr_( diskCachePtr )
+    , compressedCachePtr_( compressedCachePtr )
+    , tierWriterPtr_( tierWriterPtr )
     , gpuDataType_( gpuDataType )
 {
     if( lodNodePtr_->getRefLevel() ==  0 )
@@ -111,7 +123,7 @@ GLenum TextureDataObject::getGPUDataType() const
 const void* TextureDataObject::getDataPtr() const
 {
     getUnconst_()->updateLastUsedWithCurrentTime_();
-    return data_->getData< void >();
+    return data_->getMemSize() ? data_->getData< void >() : 0;
 }
 
 template< class T >
@@ -119,40 +131,100 @@ bool TextureDataObject::setTextureData_( const bool quantize )
 {
     getUnconst_()->updateLastUsedWithCurrentTime_();
 
+    const size_t dataSize = getRawDataSize_();
+    const size_t textureSize = quantize ? dataSize * sizeof( T ) : dataSize;
+    if( loadFromTierWriter_( textureSize ) ||
+        loadFromCompressedCache_( textureSize ) ||
+        loadFromDiskCache_( textureSize ))
+    {
+        return true;
+    }
+
     ConstMemoryUnitPtr data = dataSourcePtr_->getData( *lodNodePtr_ );
     if( !data )
         return false;
+    if( !quantize && data->getMemSize() >= dataSize )
+    {
+        // The source data is already in the GPU format: keep the memory unit
+        // of the data source instead of copying it. For memory mapped sources
+        // this is a view into the mapping, which is kept alive by the data
+        // source referenced from this object.
+        data_ = data;
+        return true;
+    }
 
     const T* rawData = data->getData< T >();
+    AllocMemoryUnitPtr textureData( new AllocMemoryUnit( ));
     if( quantize )
     {
-        std::vector< T > textureData;
-        getQuantizedData_< T >( rawData, textureData );
-        data_->allocAndSetData( textureData );
+        textureData->alloc( dataSize * sizeof( T ));
+        getQuantizedData_< T >( rawData, textureData->getData< T >( ));
     }
     else
-        data_->allocAndSetData( rawData, getRawDataSize_( ));
+        textureData->allocAndSetData( reinterpret_cast< const uint8_t* >(
+                                          rawData ), dataSize );
+    data_ = textureData;
+    return true;
+}
+
+bool TextureDataObject::loadFromTierWriter_( const size_t size )
+{
+    if( !tierWriterPtr_ )
+        return false;
+
+    const ConstMemoryUnitPtr data = tierWriterPtr_->take( getCacheID( ));
+    if( !data || data->getMemSize() < size )
+        return false;
+
+    data_ = data;
+    return true;
+}
+
+bool TextureDataObject::loadFromDiskCache_( const size_t size )
+{
+    if( !diskCachePtr_ )
+        return false;
+
+    AllocMemoryUnitPtr textureData( new AllocMemoryUnit( ));
+    if( !diskCachePtr_->load( getCacheID(), getDiskFormat_(), size,
+                              *textureData ))
+    {
+        return false;
+    }
+
+    data_ = textureData;
+    return true;
+}
+
+bool TextureDataObject::loadFromCompressedCache_( const size_t size )
+{
+    if( !compressedCachePtr_ )
+        return false;
+
+    AllocMemoryUnitPtr textureData( new AllocMemoryUnit( ));
+    if( !compressedCachePtr_->load( getCacheID(), size, *textureData ))
+        return false;
+
+    data_ = textureData;
     return true;
 }
 
 template< class T >
 void TextureDataObject::getQuantizedData_( const T* rawData,
-                                         std::vector< T >& formattedData ) const
+                                           T* formattedData ) const
 {
     const VolumeInformation& volumeInfo = dataSourcePtr_->getVolumeInformation();
     const uint32_t compCount = volumeInfo.compCount;
     const DataType dataType = volumeInfo.dataType;
     const size_t dataSize = getRawDataSize_();
 
-    formattedData.resize( dataSize );
-
     switch( dataType )
     {
        case DT_UINT8:
        {
             const Vector3f min( std::numeric_limits< uint8_t >::min( ));
             const Vector3f max( std::numeric_limits< uint8_t >::max( ));
-            unsignedQuantize( rawData, &formattedData[ 0 ], dataSize,
+            unsignedQuantize( rawData, formattedData, dataSize,
                               compCount, min, max );
             break;
        }
@@ -160,7 +232,7 @@ void TextureDataObject::getQuantizedData_( const T* rawData,
        {
             const Vector3f min( std::numeric_limits< uint16_t >::min( ));
             const Vector3f max( std::numeric_limits< uint16_t >::max( ));
-            unsignedQuantize( rawData, &formattedData[ 0 ], dataSize,
+            unsignedQuantize( rawData, formattedData, dataSize,
                               compCount, min, max );
             break;
        }
@@ -168,7 +240,7 @@ void TextureDataObject::getQuantizedData_( const T* rawData,
        {
             const Vector3f min( std::numeric_limits< uint32_t >::min( ));
             const Vector3f max( std::numeric_limits< uint32_t >::max( ));
-            unsignedQuantize( rawData, &formattedData[ 0 ], dataSize,
+            unsignedQuantize( rawData, formattedData, dataSize,
                               compCount, min, max );
             break;
        }
@@ -176,7 +248,7 @@ void TextureDataObject::getQuantizedData_( const T* rawData,
        {
             const Vector3f min( std::numeric_limits< int8_t >::min( ));
             const Vector3f max( std::numeric_limits< int8_t >::max( ));
-            signedQuantize( rawData, &formattedData[ 0 ], dataSize,
+            signedQuantize( rawData, formattedData, dataSize,
                             compCount, min, max );
             break;
        }
@@ -184,7 +256,7 @@ void TextureDataObject::getQuantizedData_( const T* rawData,
        {
             const Vector3f min( std::numeric_limits< int16_t >::min( ));
             const Vector3f max( std::numeric_limits< int16_t >::max( ));
-            signedQuantize( rawData, &formattedData[ 0 ], dataSize,
+            signedQuantize( rawData, formattedData, dataSize,
                             compCount, min, max);
             break;
        }
@@ -192,7 +264,7 @@ void TextureDataObject::getQuantizedData_( const T* rawData,
        {
             const Vector3f min( std::numeric_limits< int32_t >::min( ));
             const Vector3f max( std::numeric_limits< int32_t >::max( ));
-            signedQuantize( rawData, &formattedData[ 0 ], dataSize,
+            signedQuantize( rawData, formattedData, dataSize,
                             compCount, min, max );
             break;
        }
@@ -211,24 +283,46 @@ size_t TextureDataObject::getRawDataSize_() const
     return getDataSize_() * volumeInfo.compCount * volumeInfo.getBytesPerVoxel();
 }
 
-bool TextureDataObject::load_( )
+bool TextureDataObject::isQuantized_() const
 {
     const DataType dataType = dataSourcePtr_->getVolumeInformation().dataType;
     switch( gpuDataType_ )
     {
         case GL_UNSIGNED_BYTE:
-            return setTextureData_< uint8_t >( dataType != DT_UINT8 );
+            return dataType != DT_UINT8;
+        case GL_FLOAT:
+            return dataType != DT_FLOAT32;
+        case GL_UNSIGNED_SHORT:
+            return dataType != DT_UINT16;
+    }
+    return false;
+}
+
+uint32_t TextureDataObject::getDiskFormat_() const
+{
+    return ( gpuDataType_ << 1 ) | ( isQuantized_() ? 1u : 0u );
+}
+
+bool TextureDataObject::load_( )
+{
+    switch( gpuDataType_ )
+    {
+        case GL_UNSIGNED_BYTE:
+            return setTextureData_< uint8_t >( isQuantized_( ));
         case GL_FLOAT:
-            return setTextureData_< float >( dataType != DT_FLOAT32 );
+            return setTextureData_< float >( isQuantized_( ));
         case GL_UNSIGNED_SHORT:
-            return setTextureData_< uint16_t >( dataType != DT_UINT16 );
+            return setTextureData_< uint16_t >( isQuantized_( ));
     }
     return false;
 }
 
 void TextureDataObject::unload_( )
 {
-    data_->release();
+    if( tierWriterPtr_ )
+        tierWriterPtr_->write( getCacheID(), data_, compressedCachePtr_,
+                               diskCachePtr_, getDiskFormat_( ));
+    data_.reset( new NoMemoryUnit( ));
     LBVERB << "Texture Data released: " << lodNodePtr_->getNodeId()
            << std::endl;
 }
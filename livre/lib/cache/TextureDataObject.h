@@ -31,7 +31,13 @@ namespace livre
 
 /**
  * The TextureDataObject class gets raw data from the volume data source and
- * stores the quantized/formatted data for the GPU.
+ * stores the quantized/formatted data for the GPU. If the data source already
+ * delivers the GPU format, its memory unit is kept without a copy. With a disk
+ * cache, the formatted data is written to it when unloaded, and read back from
+ * it instead of the data source when loaded again. A compressed cache is tried
+ * first in the same way, keeping the unloaded data compressed in memory. Both
+ * are written by a TierWriter, from which the data not written yet is taken
+ * back when loaded again.
  */
 class TextureDataObject : public CacheObject, public LODNodeTrait
 {
@@ -57,6 +63,9 @@ private:
     friend class TextureDataCache;
     TextureDataObject();
     TextureDataObject( VolumeDataSourcePtr dataSourcePtr,
+                       DiskCachePtr diskCachePtr,
+                       CompressedCachePtr compressedCachePtr,
+                       TierWriterPtr tierWriterPtr,
                        ConstLODNodePtr lodNodePtr, uint32_t gpuDataType );
 
     bool load_() final;
@@ -69,20 +78,32 @@ private:
     template< class T >
     bool setTextureData_( bool quantize );
 
+    bool loadFromTierWriter_( size_t size );
+    bool loadFromDiskCache_( size_t size );
+    bool loadFromCompressedCache_( size_t size );
+
+    /** @return true if the source data is quantized to the GPU data type */
+    bool isQuantized_() const;
+
+    /** @return the format of the data in the disk cache */
+    uint32_t getDiskFormat_() const;
+
     size_t getDataSize_() const;
     size_t getRawDataSize_() const;
 
     /**
      * Quantizes data into the given format with T.
      * @param rawData The raw data from the data source to quantize
-     * @param formattedData The quantized data is dumped into the vector.
+     * @param formattedData The destination buffer for the quantized data.
      */
     template< class T >
-    void getQuantizedData_( const T* rawData,
-                            std::vector< T >& formattedData ) const;
+    void getQuantizedData_( const T* rawData, T* formattedData ) const;
 
-    AllocMemoryUnitPtr data_;
+    ConstMemoryUnitPtr data_;
     ConstVolumeDataSourcePtr dataSourcePtr_;
+    DiskCachePtr diskCachePtr_;
+    CompressedCachePtr compressedCachePtr_;
+    TierWriterPtr tierWriterPtr_;
     uint32_t gpuDataType_;
 };
 
@@ -184,28 +184,9 @@ size_t TextureObject::getCacheSize( ) const
     if( !isValid() )
         return 0;
 
-    // L (luminance, e.g. greyscale): width * height * type size.
-    // LA (luminance and alpha, common for fonts): width * height * type size bytes.
-    // RGB (color, no alpha): width * height * type size bytes.
-    // RGBA (color with alpha): width * height * type size bytes.
-
-    uint32_t elementSize = 0;
-    switch( textureState_->texturePoolPtr->getGPUDataType() )
-    {
-        case GL_UNSIGNED_BYTE:
-            elementSize = sizeof( char );
-            break;
-        case GL_FLOAT:
-            elementSize = sizeof( float );
-            break;
-        case GL_UNSIGNED_SHORT:
-            elementSize = sizeof( short );
-            break;
-    }
-
-    const Vector3i textureSize = textureState_->texturePoolPtr->getMaxBlockSize();
-    const uint32_t cacheSize = textureSize[ 0 ] * textureSize[ 1 ] * textureSize[ 2 ] * elementSize;
-    return cacheSize;
+    // The GL internal format defines the memory, not the uploaded data type
+    return textureCachePtr_->getTextureSize(
+                textureState_->texturePoolPtr->getMaxBlockSize( ));
 }
 
 const TextureDataObject& TextureObject::getTextureDataObject_( ) const
@@ -0,0 +1,201 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/cache/TierWriter.h>
+#include <livre/lib/cache/CompressedCache.h>
+#include <livre/lib/cache/DiskCache.h>
+
+#include <livre/core/data/MemoryUnit.h>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <deque>
+
+namespace livre
+{
+
+namespace detail
+{
+
+class TierWriter
+{
+    struct Write
+    {
+        ConstMemoryUnitPtr data;
+        CompressedCachePtr compressedCache;
+        DiskCachePtr diskCache;
+        uint32_t diskFormat;
+    };
+    typedef boost::unordered_map< CacheId, Write > WriteMap;
+
+public:
+    explicit TierWriter( const size_t maxMemory )
+        : _maxMemory( maxMemory )
+        , _usedMemory( 0 )
+        , _writing( false )
+        , _stopping( false )
+        , _thread( [this]() { _run(); } )
+    {}
+
+    ~TierWriter()
+    {
+        {
+            boost::unique_lock< boost::mutex > lock( _mutex );
+            _stopping = true;
+        }
+        _workCondition.notify_all();
+        _thread.join();
+    }
+
+    void write( const CacheId cacheId, const ConstMemoryUnitPtr& data,
+                const CompressedCachePtr& compressedCache,
+                const DiskCachePtr& diskCache, const uint32_t diskFormat )
+    {
+        const size_t size = data->getMemSize();
+        if( size == 0 || ( !compressedCache && !diskCache ))
+            return;
+        {
+            boost::unique_lock< boost::mutex > lock( _mutex );
+            if( _writes.count( cacheId ) || _usedMemory + size > _maxMemory )
+                return;
+
+            Write& write = _writes[ cacheId ];
+            write.data = data;
+            write.compressedCache = compressedCache;
+            write.diskCache = diskCache;
+            write.diskFormat = diskFormat;
+            _queue.push_back( cacheId );
+            _usedMemory += size;
+        }
+        _workCondition.notify_one();
+    }
+
+    ConstMemoryUnitPtr take( const CacheId cacheId )
+    {
+        boost::unique_lock< boost::mutex > lock( _mutex );
+        WriteMap::iterator i = _writes.find( cacheId );
+        if( i == _writes.end( ))
+            return ConstMemoryUnitPtr();
+
+        // the id stays in _queue, where the writer thread skips it
+        const ConstMemoryUnitPtr data = i->second.data;
+        _usedMemory -= data->getMemSize();
+        _writes.erase( i );
+        return data;
+    }
+
+    void flush()
+    {
+        boost::unique_lock< boost::mutex > lock( _mutex );
+        while( !_queue.empty() || _writing )
+            _doneCondition.wait( lock );
+    }
+
+    size_t getUsedMemory() const
+    {
+        boost::unique_lock< boost::mutex > lock( _mutex );
+        return _usedMemory;
+    }
+
+private:
+    void _run()
+    {
+        boost::unique_lock< boost::mutex > lock( _mutex );
+        for( ;; )
+        {
+            while( !_stopping && _queue.empty( ))
+                _workCondition.wait( lock );
+            if( _queue.empty( )) // stopping, all bricks are written
+                return;
+
+            const CacheId cacheId = _queue.front();
+            _queue.pop_front();
+            WriteMap::iterator i = _writes.find( cacheId );
+            if( i != _writes.end( ))
+            {
+                const Write write = i->second;
+                _writes.erase( i );
+                _writing = true;
+
+                lock.unlock();
+                if( write.compressedCache )
+                    write.compressedCache->store( cacheId, *write.data );
+                if( write.diskCache )
+                    write.diskCache->store( cacheId, write.diskFormat,
+                                            *write.data );
+                lock.lock();
+
+                _usedMemory -= write.data->getMemSize();
+                _writing = false;
+            }
+            if( _queue.empty( ))
+                _doneCondition.notify_all();
+        }
+    }
+
+    const size_t _maxMemory;
+
+    mutable boost::mutex _mutex;
+    boost::condition_variable _workCondition; //!< Bricks were queued
+    boost::condition_variable _doneCondition; //!< The queue was written
+    std::deque< CacheId > _queue; //!< In write order, may hold taken ids
+    WriteMap _writes; //!< The waiting bricks of _queue
+    size_t _usedMemory;
+    bool _writing;
+    bool _stopping;
+
+    boost::thread _thread;
+};
+
+}
+
+TierWriter::TierWriter( const size_t maxMemory )
+    : _impl( new detail::TierWriter( maxMemory ))
+{
+}
+
+TierWriter::~TierWriter()
+{
+    delete _impl;
+}
+
+void TierWriter::write( const CacheId cacheId, ConstMemoryUnitPtr data,
+                        CompressedCachePtr compressedCache,
+                        DiskCachePtr diskCache, const uint32_t diskFormat )
+{
+    _impl->write( cacheId, data, compressedCache, diskCache, diskFormat );
+}
+
+ConstMemoryUnitPtr TierWriter::take( const CacheId cacheId )
+{
+    return _impl->take( cacheId );
+}
+
+void TierWriter::flush()
+{
+    _impl->flush();
+}
+
+size_t TierWriter::getUsedMemory() const
+{
+    return _impl->getUsedMemory();
+}
+
+}
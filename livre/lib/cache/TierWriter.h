@@ -0,0 +1,88 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _TierWriter_h_
+#define _TierWriter_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+#include <boost/noncopyable.hpp>
+
+namespace livre
+{
+
+namespace detail
+{
+    class TierWriter;
+}
+
+/**
+ * Writes the bricks evicted from the TextureDataCache into the compressed and
+ * disk cache tiers on a background thread, so the LZ4 compression and the file
+ * writes are not done while the cache evicts.
+ *
+ * A brick waiting to be written can be taken back, which cancels its writes.
+ * Bricks are dropped instead of queued while the waiting bricks exceed the
+ * maximum memory.
+ *
+ * All methods are thread safe.
+ */
+class TierWriter : public boost::noncopyable
+{
+public:
+    /**
+     * @param maxMemory The maximum memory of the waiting bricks in bytes.
+     */
+    LIVRE_API explicit TierWriter( size_t maxMemory );
+
+    /** Writes the waiting bricks and stops the thread. */
+    LIVRE_API ~TierWriter();
+
+    /**
+     * Queue a brick for writing, unless it is already waiting.
+     * @param cacheId The cache id of the brick.
+     * @param data The brick data, kept until it is written.
+     * @param compressedCache The compressed cache to write to, may be empty.
+     * @param diskCache The disk cache to write to, may be empty.
+     * @param diskFormat The format of the brick in the disk cache.
+     */
+    LIVRE_API void write( CacheId cacheId, ConstMemoryUnitPtr data,
+                          CompressedCachePtr compressedCache,
+                          DiskCachePtr diskCache, uint32_t diskFormat );
+
+    /**
+     * Take back a brick waiting to be written, and cancel its writes.
+     * @param cacheId The cache id of the brick.
+     * @return The brick data, empty if the brick is not waiting.
+     */
+    LIVRE_API ConstMemoryUnitPtr take( CacheId cacheId );
+
+    /** Wait until the queued bricks are written. */
+    LIVRE_API void flush();
+
+    /** @return the memory of the waiting bricks in bytes. */
+    LIVRE_API size_t getUsedMemory() const;
+
+private:
+    detail::TierWriter* _impl;
+};
+
+}
+
+#endif // _TierWriter_h_
@@ -27,6 +27,24 @@ const std::string SCREENSPACEERROR_PARAM = "sse";
 const std::string SYNCHRONOUSMODE_PARAM = "synchronous";
 const std::string GPUCACHEMEM_PARAM = "gpu-cache-mem";
 const std::string CPUCACHEMEM_PARAM = "cpu-cache-mem";
+const std::string GPUCACHEPOLICY_PARAM = "gpu-cache-policy";
+const std::string CPUCACHEPOLICY_PARAM = "cpu-cache-policy";
+const std::string CPUCACHEADMISSION_PARAM = "cpu-cache-admission";
+const std::string CACHEMAXOBJECTS_PARAM = "cache-max-objects";
+const std::string LOADERTHREADS_PARAM = "loader-threads";
+const std::string COMMITBATCHSIZE_PARAM = "commit-batch-size";
+const std::string COMMITBATCHLATENCY_PARAM = "commit-batch-latency";
+const std::string COMMITMAXPENDING_PARAM = "commit-max-pending";
+const std::string GPUCACHERESERVEDMEM_PARAM = "gpu-cache-reserved-mem";
+const std::string GPUCACHEMINMEM_PARAM = "gpu-cache-mem-min";
+const std::string GPUCACHEMAXMEM_PARAM = "gpu-cache-mem-max";
+const std::string CPUCACHEMINMEM_PARAM = "cpu-cache-mem-min";
+const std::string CPUCACHEMAXMEM_PARAM = "cpu-cache-mem-max";
+const std::string COMPRESSEDCACHEMEM_PARAM = "compressed-cache-mem";
+const std::string CPUCACHEALLOCATOR_PARAM = "cpu-cache-allocator";
+const std::string CACHESNAPSHOT_PARAM = "cache-snapshot";
+const std::string DISKCACHE_PARAM = "disk-cache";
+const std::string DISKCACHEMEM_PARAM = "disk-cache-mem";
 const std::string MINLOD_PARAM = "min-lod";
 const std::string MAXLOD_PARAM = "max-lod";
 const std::string SAMPLESPERRAY_PARAM = "samples-per-ray";
@@ -40,11 +58,30 @@ VolumeRendererParameters::VolumeRendererParameters()
     , screenSpaceError( 8.0f )
     , maxGPUCacheMemoryMB( 384u )
     , maxCPUCacheMemoryMB( 768u )
+    , maxDiskCacheMemoryMB( 2048u )
+    , gpuCacheReservedMB( 16u )
 #else
     , screenSpaceError( 4.0f )
     , maxGPUCacheMemoryMB( 3072u )
     , maxCPUCacheMemoryMB( 8192u )
+    , maxDiskCacheMemoryMB( 65536u )
+    , gpuCacheReservedMB( 128u )
 #endif
+    , gpuCacheMinMemoryMB( 0u )
+    , gpuCacheMaxMemoryMB( 0u )
+    , cpuCacheMinMemoryMB( 0u )
+    , cpuCacheMaxMemoryMB( 0u )
+    , compressedCacheMemoryMB( 0u )
+    , cpuCacheAllocator( "heap" )
+    , cacheSnapshot()
+    , gpuCachePolicy( "lru" )
+    , cpuCachePolicy( "lru" )
+    , cpuCacheAdmission( false )
+    , maxCacheObjects( 1u << 20 )
+    , loaderThreads( 1u )
+    , commitBatchSize( 16u )
+    , commitBatchLatency( 10.f )
+    , commitMaxPending( 4u )
     , minLOD( 0 )
     , maxLOD( ( NODEID_LEVEL_BITS << 1 ) + 1 )
     , samplesPerRay( 0 )
@@ -59,6 +96,89 @@ VolumeRendererParameters::VolumeRendererParameters()
                                    "Maximum CPU cache memory (MB) - "
                                    "caches the volume data in CPU memory",
                                    maxCPUCacheMemoryMB );
+    configuration_.addDescription( configGroupName_, GPUCACHEPOLICY_PARAM,
+                                   "GPU cache unload policy - lru, gdsf to "
+                                   "keep the textures which are expensive to "
+                                   "load, or importance to keep the textures "
+                                   "which are close, large on screen or needed "
+                                   "as fallback", gpuCachePolicy );
+    configuration_.addDescription( configGroupName_, CPUCACHEPOLICY_PARAM,
+                                   "CPU cache unload policy - lru, or gdsf to "
+                                   "keep the data which is expensive to load",
+                                   cpuCachePolicy );
+    configuration_.addDescription( configGroupName_, CPUCACHEADMISSION_PARAM,
+                                   "CPU cache admission filter - new data "
+                                   "only displaces the data requested less "
+                                   "often (lru policy only)",
+                                   cpuCacheAdmission );
+    configuration_.addDescription( configGroupName_, CACHEMAXOBJECTS_PARAM,
+                                   "Maximum number of bricks known by each "
+                                   "cache - the unused ones are forgotten "
+                                   "above it (0: no limit)", maxCacheObjects );
+    configuration_.addDescription( configGroupName_, LOADERTHREADS_PARAM,
+                                   "Number of threads loading the bricks "
+                                   "into the CPU cache (0: one per core)",
+                                   loaderThreads );
+    configuration_.addDescription( configGroupName_, COMMITBATCHSIZE_PARAM,
+                                   "Number of bricks sent at once between the "
+                                   "loading stages", commitBatchSize );
+    configuration_.addDescription( configGroupName_, COMMITBATCHLATENCY_PARAM,
+                                   "Maximum time (ms) a loaded brick waits to "
+                                   "be sent to the next loading stage",
+                                   commitBatchLatency );
+    configuration_.addDescription( configGroupName_, COMMITMAXPENDING_PARAM,
+                                   "Number of updates pending in a loading "
+                                   "stage above which new bricks are sent "
+                                   "together (0: no limit)", commitMaxPending );
+    configuration_.addDescription( configGroupName_, GPUCACHERESERVEDMEM_PARAM,
+                                   "GPU cache memory (MB) reserved for the "
+                                   "coarsest levels by the importance policy",
+                                   gpuCacheReservedMB );
+    configuration_.addDescription( configGroupName_, GPUCACHEMINMEM_PARAM,
+                                   "Minimum GPU cache memory (MB) when the "
+                                   "memory is moved between the CPU and GPU "
+                                   "caches (default: gpu-cache-mem)",
+                                   gpuCacheMinMemoryMB );
+    configuration_.addDescription( configGroupName_, GPUCACHEMAXMEM_PARAM,
+                                   "Maximum GPU cache memory (MB) when the "
+                                   "memory is moved between the CPU and GPU "
+                                   "caches (default: gpu-cache-mem)",
+                                   gpuCacheMaxMemoryMB );
+    configuration_.addDescription( configGroupName_, CPUCACHEMINMEM_PARAM,
+                                   "Minimum CPU cache memory (MB) when the "
+                                   "memory is moved between the CPU and GPU "
+                                   "caches (default: cpu-cache-mem)",
+                                   cpuCacheMinMemoryMB );
+    configuration_.addDescription( configGroupName_, CPUCACHEMAXMEM_PARAM,
+                                   "Maximum CPU cache memory (MB) when the "
+                                   "memory is moved between the CPU and GPU "
+                                   "caches (default: cpu-cache-mem)",
+                                   cpuCacheMaxMemoryMB );
+    configuration_.addDescription( configGroupName_, COMPRESSEDCACHEMEM_PARAM,
+                                   "Compressed cache memory (MB) - keeps the "
+                                   "8 and 16 bit data evicted from the CPU "
+                                   "cache LZ4 compressed in CPU memory "
+                                   "(default: disabled)",
+                                   compressedCacheMemoryMB );
+    configuration_.addDescription( configGroupName_, CPUCACHEALLOCATOR_PARAM,
+                                   "CPU cache brick allocator - heap, slab to "
+                                   "reserve the CPU cache memory up front in "
+                                   "brick sized slots, or hugepages to back "
+                                   "the slots with huge pages",
+                                   cpuCacheAllocator );
+    configuration_.addDescription( configGroupName_, CACHESNAPSHOT_PARAM,
+                                   "Cache snapshot file - the resident bricks "
+                                   "are written to it on exit or with 'w', and "
+                                   "prefetched from it on startup (default: "
+                                   "disabled)", cacheSnapshot );
+    configuration_.addDescription( configGroupName_, DISKCACHE_PARAM,
+                                   "Disk cache directory - keeps the data "
+                                   "evicted from the CPU cache on disk, "
+                                   "across sessions (default: disabled)",
+                                   diskCache );
+    configuration_.addDescription( configGroupName_, DISKCACHEMEM_PARAM,
+                                   "Maximum disk cache size (MB)",
+                                   maxDiskCacheMemoryMB );
     configuration_.addDescription( configGroupName_, SCREENSPACEERROR_PARAM,
                                    "Screen space error", screenSpaceError );
     configuration_.addDescription( configGroupName_, SYNCHRONOUSMODE_PARAM,
@@ -84,6 +204,24 @@ void VolumeRendererParameters::deserialize( co::DataIStream& is, const uint64_t
        >> synchronousMode
        >> maxGPUCacheMemoryMB
        >> maxCPUCacheMemoryMB
+       >> gpuCachePolicy
+       >> cpuCachePolicy
+       >> cpuCacheAdmission
+       >> maxCacheObjects
+       >> loaderThreads
+       >> commitBatchSize
+       >> commitBatchLatency
+       >> commitMaxPending
+       >> gpuCacheReservedMB
+       >> gpuCacheMinMemoryMB
+       >> gpuCacheMaxMemoryMB
+       >> cpuCacheMinMemoryMB
+       >> cpuCacheMaxMemoryMB
+       >> compressedCacheMemoryMB
+       >> cpuCacheAllocator
+       >> cacheSnapshot
+       >> diskCache
+       >> maxDiskCacheMemoryMB
        >> minLOD
        >> maxLOD
        >> samplesPerRay
@@ -97,6 +235,24 @@ void VolumeRendererParameters::serialize( co::DataOStream& os, const uint64_t )
        << synchronousMode
        << maxGPUCacheMemoryMB
        << maxCPUCacheMemoryMB
+       << gpuCachePolicy
+       << cpuCachePolicy
+       << cpuCacheAdmission
+       << maxCacheObjects
+       << loaderThreads
+       << commitBatchSize
+       << commitBatchLatency
+       << commitMaxPending
+       << gpuCacheReservedMB
+       << gpuCacheMinMemoryMB
+       << gpuCacheMaxMemoryMB
+       << cpuCacheMinMemoryMB
+       << cpuCacheMaxMemoryMB
+       << compressedCacheMemoryMB
+       << cpuCacheAllocator
+       << cacheSnapshot
+       << diskCache
+       << maxDiskCacheMemoryMB
        << minLOD
        << maxLOD
        << samplesPerRay
@@ -114,6 +270,24 @@ VolumeRendererParameters& VolumeRendererParameters::operator=(
     synchronousMode = rhs.synchronousMode;
     maxGPUCacheMemoryMB = rhs.maxGPUCacheMemoryMB;
     maxCPUCacheMemoryMB = rhs.maxCPUCacheMemoryMB;
+    gpuCachePolicy = rhs.gpuCachePolicy;
+    cpuCachePolicy = rhs.cpuCachePolicy;
+    cpuCacheAdmission = rhs.cpuCacheAdmission;
+    maxCacheObjects = rhs.maxCacheObjects;
+    loaderThreads = rhs.loaderThreads;
+    commitBatchSize = rhs.commitBatchSize;
+    commitBatchLatency = rhs.commitBatchLatency;
+    commitMaxPending = rhs.commitMaxPending;
+    gpuCacheReservedMB = rhs.gpuCacheReservedMB;
+    gpuCacheMinMemoryMB = rhs.gpuCacheMinMemoryMB;
+    gpuCacheMaxMemoryMB = rhs.gpuCacheMaxMemoryMB;
+    cpuCacheMinMemoryMB = rhs.cpuCacheMinMemoryMB;
+    cpuCacheMaxMemoryMB = rhs.cpuCacheMaxMemoryMB;
+    compressedCacheMemoryMB = rhs.compressedCacheMemoryMB;
+    cpuCacheAllocator = rhs.cpuCacheAllocator;
+    cacheSnapshot = rhs.cacheSnapshot;
+    diskCache = rhs.diskCache;
+    maxDiskCacheMemoryMB = rhs.maxDiskCacheMemoryMB;
     minLOD = rhs.minLOD;
     maxLOD = rhs.maxLOD;
     samplesPerRay = rhs.samplesPerRay;
@@ -130,6 +304,25 @@ void VolumeRendererParameters::initialize_()
     configuration_.getValue( SCREENSPACEERROR_PARAM, screenSpaceError );
     configuration_.getValue( GPUCACHEMEM_PARAM, maxGPUCacheMemoryMB );
     configuration_.getValue( CPUCACHEMEM_PARAM, maxCPUCacheMemoryMB);
+    configuration_.getValue( GPUCACHEPOLICY_PARAM, gpuCachePolicy );
+    configuration_.getValue( CPUCACHEPOLICY_PARAM, cpuCachePolicy );
+    configuration_.getValue( CPUCACHEADMISSION_PARAM, cpuCacheAdmission );
+    configuration_.getValue( CACHEMAXOBJECTS_PARAM, maxCacheObjects );
+    configuration_.getValue( LOADERTHREADS_PARAM, loaderThreads );
+    configuration_.getValue( COMMITBATCHSIZE_PARAM, commitBatchSize );
+    configuration_.getValue( COMMITBATCHLATENCY_PARAM, commitBatchLatency );
+    configuration_.getValue( COMMITMAXPENDING_PARAM, commitMaxPending );
+    configuration_.getValue( GPUCACHERESERVEDMEM_PARAM, gpuCacheReservedMB );
+    configuration_.getValue( GPUCACHEMINMEM_PARAM, gpuCacheMinMemoryMB );
+    configuration_.getValue( GPUCACHEMAXMEM_PARAM, gpuCacheMaxMemoryMB );
+    configuration_.getValue( CPUCACHEMINMEM_PARAM, cpuCacheMinMemoryMB );
+    configuration_.getValue( CPUCACHEMAXMEM_PARAM, cpuCacheMaxMemoryMB );
+    configuration_.getValue( COMPRESSEDCACHEMEM_PARAM,
+                             compressedCacheMemoryMB );
+    configuration_.getValue( CPUCACHEALLOCATOR_PARAM, cpuCacheAllocator );
+    configuration_.getValue( CACHESNAPSHOT_PARAM, cacheSnapshot );
+    configuration_.getValue( DISKCACHE_PARAM, diskCache );
+    configuration_.getValue( DISKCACHEMEM_PARAM, maxDiskCacheMemoryMB );
     configuration_.getValue( MINLOD_PARAM, minLOD );
     configuration_.getValue( MAXLOD_PARAM, maxLOD );
     configuration_.getValue( SAMPLESPERRAY_PARAM, samplesPerRay );
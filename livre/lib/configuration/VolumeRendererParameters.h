@@ -35,6 +35,24 @@ struct VolumeRendererParameters : public Parameters
     float screenSpaceError;  //!< Screen space error
     size_t maxGPUCacheMemoryMB; //!< Max memory for texture cache
     size_t maxCPUCacheMemoryMB; //!< Max memory for data cache
+    size_t maxDiskCacheMemoryMB; //!< Max disk space for the disk cache
+    size_t gpuCacheReservedMB; //!< Texture cache memory kept by coarse levels
+    size_t gpuCacheMinMemoryMB; //!< Lower bound of the rebalanced GPU cache
+    size_t gpuCacheMaxMemoryMB; //!< Upper bound of the rebalanced GPU cache
+    size_t cpuCacheMinMemoryMB; //!< Lower bound of the rebalanced CPU cache
+    size_t cpuCacheMaxMemoryMB; //!< Upper bound of the rebalanced CPU cache
+    size_t compressedCacheMemoryMB; //!< Max memory for the compressed cache
+    std::string cpuCacheAllocator; //!< Allocator of the data cache bricks
+    std::string cacheSnapshot; //!< File of the resident bricks, empty to disable
+    std::string gpuCachePolicy; //!< Unload policy of the texture cache
+    std::string cpuCachePolicy; //!< Unload policy of the data cache
+    bool cpuCacheAdmission; //!< Admission filter of the data cache
+    size_t maxCacheObjects; //!< Max number of objects per cache, 0 for any
+    uint32_t loaderThreads; //!< Number of brick loading threads, 0 for any
+    uint32_t commitBatchSize; //!< Bricks per commit between loading stages
+    float commitBatchLatency; //!< Max delay of a brick commit in ms
+    uint32_t commitMaxPending; //!< Pending commits to hold back batches at
+    std::string diskCache; //!< Directory of the disk cache, empty to disable
     uint32_t minLOD; //!< Minimum level of detail
     uint32_t maxLOD; //!< Maximum level of detail
     uint32_t samplesPerRay; //!< Number of samples per ray
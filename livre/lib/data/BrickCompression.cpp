@@ -0,0 +1,141 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/defines.h>
+#include <livre/lib/data/BrickCompression.h>
+
+#ifdef LIVRE_USE_LZ4
+#  include <lz4.h>
+#endif
+#ifdef LIVRE_USE_ZSTD
+#  include <zstd.h>
+#endif
+
+namespace livre
+{
+
+bool isBrickCompressionSupported( const BrickCompression compression )
+{
+    switch( compression )
+    {
+    case BRICK_COMPRESSION_NONE:
+        return true;
+    case BRICK_COMPRESSION_LZ4:
+#ifdef LIVRE_USE_LZ4
+        return true;
+#else
+        return false;
+#endif
+    case BRICK_COMPRESSION_ZSTD:
+#ifdef LIVRE_USE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+uint32_t getSupportedBrickCompressions()
+{
+    uint32_t compressions = 1u << BRICK_COMPRESSION_NONE;
+    if( isBrickCompressionSupported( BRICK_COMPRESSION_LZ4 ))
+        compressions |= 1u << BRICK_COMPRESSION_LZ4;
+    if( isBrickCompressionSupported( BRICK_COMPRESSION_ZSTD ))
+        compressions |= 1u << BRICK_COMPRESSION_ZSTD;
+    return compressions;
+}
+
+bool compressBrick( const BrickCompression compression, const uint8_t* data,
+                    const size_t size, std::vector< uint8_t >& output )
+{
+    switch( compression )
+    {
+    case BRICK_COMPRESSION_NONE:
+        return false;
+
+    case BRICK_COMPRESSION_LZ4:
+    {
+#ifdef LIVRE_USE_LZ4
+        output.resize( LZ4_compressBound( size ));
+        const int compressed =
+            LZ4_compress_default( reinterpret_cast< const char* >( data ),
+                                  reinterpret_cast< char* >( &output[0] ),
+                                  size, output.size( ));
+        if( compressed <= 0 || size_t( compressed ) >= size )
+            return false;
+        output.resize( compressed );
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    case BRICK_COMPRESSION_ZSTD:
+    {
+#ifdef LIVRE_USE_ZSTD
+        output.resize( ZSTD_compressBound( size ));
+        const size_t compressed = ZSTD_compress( &output[0], output.size(),
+                                                 data, size, 3 );
+        if( ZSTD_isError( compressed ) || compressed >= size )
+            return false;
+        output.resize( compressed );
+        return true;
+#else
+        return false;
+#endif
+    }
+    }
+    return false;
+}
+
+bool decompressBrick( const BrickCompression compression, const uint8_t* data,
+                      const size_t size, uint8_t* output,
+                      const size_t outputSize )
+{
+    switch( compression )
+    {
+    case BRICK_COMPRESSION_NONE:
+        if( size != outputSize )
+            return false;
+        ::memcpy( output, data, size );
+        return true;
+
+    case BRICK_COMPRESSION_LZ4:
+#ifdef LIVRE_USE_LZ4
+        return LZ4_decompress_safe( reinterpret_cast< const char* >( data ),
+                                    reinterpret_cast< char* >( output ),
+                                    size, outputSize ) == int( outputSize );
+#else
+        LBERROR << "LZ4 compressed bricks are not supported" << std::endl;
+        return false;
+#endif
+
+    case BRICK_COMPRESSION_ZSTD:
+#ifdef LIVRE_USE_ZSTD
+        return ZSTD_decompress( output, outputSize, data, size ) == outputSize;
+#else
+        LBERROR << "zstd compressed bricks are not supported" << std::endl;
+        return false;
+#endif
+    }
+    return false;
+}
+
+}
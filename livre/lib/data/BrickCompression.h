@@ -0,0 +1,76 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _BrickCompression_h_
+#define _BrickCompression_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+
+namespace livre
+{
+
+/** Compression of a single brick payload, on disk or on the wire */
+enum BrickCompression
+{
+    BRICK_COMPRESSION_NONE = 0,
+    BRICK_COMPRESSION_LZ4 = 1,
+    BRICK_COMPRESSION_ZSTD = 2
+};
+
+/**
+ * @return a bit mask with ( 1 << BrickCompression ) set for all compressions
+ *         supported by this build.
+ */
+LIVRE_API uint32_t getSupportedBrickCompressions();
+
+/**
+ * @param compression the compression to check.
+ * @return true if the given brick compression is supported by this build.
+ */
+LIVRE_API bool isBrickCompressionSupported( BrickCompression compression );
+
+/**
+ * Compress a brick payload.
+ * @param compression the compression to use.
+ * @param data the uncompressed brick.
+ * @param size the size of the uncompressed brick in bytes.
+ * @param output receives the compressed brick.
+ * @return true if the brick could be compressed into less than size bytes.
+ */
+LIVRE_API bool compressBrick( BrickCompression compression,
+                              const uint8_t* data, size_t size,
+                              std::vector< uint8_t >& output );
+
+/**
+ * Decompress a brick payload.
+ * @param compression the compression of the payload.
+ * @param data the compressed brick.
+ * @param size the size of the compressed brick in bytes.
+ * @param output the destination buffer for the uncompressed brick.
+ * @param outputSize the expected size of the uncompressed brick in bytes.
+ * @return true on success.
+ */
+LIVRE_API bool decompressBrick( BrickCompression compression,
+                                const uint8_t* data, size_t size,
+                                uint8_t* output, size_t outputSize );
+
+}
+
+#endif // _BrickCompression_h_
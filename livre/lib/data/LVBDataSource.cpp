@@ -0,0 +1,286 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/MemoryUnit.h>
+
+#include <livre/lib/data/LVBDataSource.h>
+#include <livre/lib/data/LVBFormat.h>
+
+#include <lunchbox/lock.h>
+#include <lunchbox/mtQueue.h>
+#include <lunchbox/pluginRegisterer.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace livre
+{
+
+namespace
+{
+   lunchbox::PluginRegisterer< LVBDataSource > registerer;
+}
+
+namespace detail
+{
+
+class LVBDataSource
+{
+public:
+    LVBDataSource( VolumeInformation& volumeInfo,
+                   const VolumeDataSourcePluginData& initData )
+        : _volumeInfo( volumeInfo )
+        , _fd( -1 )
+    {
+        const servus::URI& uri = initData.getURI();
+        const std::string path = uri.getHost() + uri.getPath();
+
+        _fd = ::open( path.c_str(), O_RDONLY );
+        if( _fd < 0 )
+            LBTHROW( std::runtime_error( "Cannot open LVB volume " + path ));
+
+        LVBHeader header;
+        if( !_read( &header, sizeof( header ), 0 ))
+        {
+            ::close( _fd );
+            LBTHROW( std::runtime_error( path + " is not an LVB volume" ));
+        }
+        if( header.magic == LVB_MAGIC_SWAPPED )
+        {
+            ::close( _fd );
+            LBTHROW( std::runtime_error( path + " was written on a host of "
+                                         "the other endianness" ));
+        }
+        if( header.magic != LVB_MAGIC || header.version != LVB_VERSION )
+        {
+            ::close( _fd );
+            LBTHROW( std::runtime_error( path + " is not an LVB volume" ));
+        }
+
+        _bricks.resize( header.brickCount );
+        if( !_bricks.empty() &&
+            !_read( &_bricks[0], _bricks.size() * sizeof( LVBBrick ),
+                    header.indexOffset ))
+        {
+            ::close( _fd );
+            LBTHROW( std::runtime_error( "Cannot read brick index of " + path ));
+        }
+        std::sort( _bricks.begin(), _bricks.end( ));
+
+        _volumeInfo.dataType = DataType( header.dataType );
+        _volumeInfo.compCount = header.compCount;
+        _volumeInfo.isBigEndian = header.isBigEndian;
+        _volumeInfo.voxels = Vector3ui( header.voxels[0], header.voxels[1],
+                                        header.voxels[2] );
+        _volumeInfo.maximumBlockSize = Vector3ui( header.maximumBlockSize[0],
+                                                  header.maximumBlockSize[1],
+                                                  header.maximumBlockSize[2] );
+        _volumeInfo.overlap = Vector3ui( header.overlap[0], header.overlap[1],
+                                         header.overlap[2] );
+        _volumeInfo.frameRange = Vector2ui( header.frameRange[0],
+                                            header.frameRange[1] );
+
+        if( !fillRegularVolumeInfo( _volumeInfo ))
+        {
+            ::close( _fd );
+            LBTHROW( std::runtime_error( "Cannot setup the regular tree" ));
+        }
+    }
+
+    ~LVBDataSource()
+    {
+        if( _reader )
+        {
+            _batches.push( Batch( )); // reads the pending batches first
+            _reader->join();
+        }
+        ::close( _fd );
+    }
+
+    MemoryUnitPtr getData( const LODNode& node )
+    {
+        const LVBBrick* brick = _findBrick( node );
+        return brick ? _readBrick( node, *brick ) : MemoryUnitPtr();
+    }
+
+    MemoryUnitFutures getDataAsync( const LODNodes& nodes )
+    {
+        Batch batch;
+        MemoryUnitFutures futures;
+        for( size_t i = 0; i < nodes.size(); ++i )
+        {
+            const Read read = { nodes[i], _findBrick( nodes[i] ),
+                                std::make_shared<
+                                    std::promise< MemoryUnitPtr > >( ) };
+            futures.push_back( read.promise->get_future( ));
+            batch.push_back( read );
+        }
+        if( batch.empty( ))
+            return futures;
+
+        // read in file order to turn the batch into a sequential scan
+        std::sort( batch.begin(), batch.end(),
+                   []( const Read& a, const Read& b )
+                   {
+                       const uint64_t aOffset = a.brick ? a.brick->offset : 0;
+                       const uint64_t bOffset = b.brick ? b.brick->offset : 0;
+                       return aOffset < bOffset;
+                   });
+
+        lunchbox::ScopedWrite mutex( _readerLock );
+        if( !_reader )
+            _reader.reset( new boost::thread(
+                               boost::bind( &LVBDataSource::_runReader,
+                                            this )));
+        _batches.push( batch );
+        return futures;
+    }
+
+private:
+    struct Read
+    {
+        LODNode node;
+        const LVBBrick* brick;
+        std::shared_ptr< std::promise< MemoryUnitPtr > > promise;
+    };
+    typedef std::vector< Read > Batch; //!< Empty to stop the reader
+
+    void _runReader()
+    {
+        for( ;; )
+        {
+            const Batch batch = _batches.pop();
+            if( batch.empty( ))
+                return;
+
+            BOOST_FOREACH( const Read& read, batch )
+                read.promise->set_value( read.brick ?
+                    _readBrick( read.node, *read.brick ) : MemoryUnitPtr( ));
+        }
+    }
+
+    const LVBBrick* _findBrick( const LODNode& node ) const
+    {
+        LVBBrick key;
+        key.nodeId = node.getNodeId().getId();
+        std::vector< LVBBrick >::const_iterator i =
+            std::lower_bound( _bricks.begin(), _bricks.end(), key );
+        if( i == _bricks.end() || i->nodeId != key.nodeId )
+        {
+            LBERROR << "No brick in LVB volume for " << node.getNodeId()
+                    << std::endl;
+            return 0;
+        }
+        return &(*i);
+    }
+
+    MemoryUnitPtr _readBrick( const LODNode& node, const LVBBrick& brick ) const
+    {
+        const Vector3ui blockSize = _volumeInfo.maximumBlockSize;
+        const size_t dataSize = size_t( blockSize.x( )) * blockSize.y() *
+                                blockSize.z() * _volumeInfo.compCount *
+                                _volumeInfo.getBytesPerVoxel();
+
+        AllocMemoryUnitPtr memoryUnit( new AllocMemoryUnit );
+        memoryUnit->alloc( dataSize );
+        uint8_t* data = memoryUnit->getData< uint8_t >();
+
+        const BrickCompression compression =
+            BrickCompression( brick.compression );
+        if( compression == BRICK_COMPRESSION_NONE )
+        {
+            if( brick.size != dataSize ||
+                !_read( data, dataSize, brick.offset ))
+            {
+                LBERROR << "Cannot read brick " << node.getNodeId()
+                        << std::endl;
+                return MemoryUnitPtr();
+            }
+            return memoryUnit;
+        }
+
+        std::vector< uint8_t > compressed( brick.size );
+        if( !_read( &compressed[0], compressed.size(), brick.offset ) ||
+            !decompressBrick( compression, &compressed[0],
+                                 compressed.size(), data, dataSize ))
+        {
+            LBERROR << "Cannot decompress brick " << node.getNodeId()
+                    << std::endl;
+            return MemoryUnitPtr();
+        }
+        return memoryUnit;
+    }
+
+    bool _read( void* data, const size_t size, const uint64_t offset ) const
+    {
+        uint8_t* ptr = static_cast< uint8_t* >( data );
+        size_t done = 0;
+        while( done < size )
+        {
+            const ssize_t nRead = ::pread( _fd, ptr + done, size - done,
+                                           offset + done );
+            if( nRead <= 0 )
+                return false;
+            done += nRead;
+        }
+        return true;
+    }
+
+    VolumeInformation& _volumeInfo;
+    int _fd;
+    std::vector< LVBBrick > _bricks;
+    lunchbox::Lock _readerLock;
+    boost::scoped_ptr< boost::thread > _reader; //!< Started on first batch
+    lunchbox::MTQueue< Batch > _batches;
+};
+
+}
+
+LVBDataSource::LVBDataSource( const VolumeDataSourcePluginData& initData )
+    : _impl( new detail::LVBDataSource( _volumeInfo, initData ))
+{
+}
+
+LVBDataSource::~LVBDataSource()
+{
+    delete _impl;
+}
+
+MemoryUnitPtr LVBDataSource::getData( const LODNode& node )
+{
+    return _impl->getData( node );
+}
+
+MemoryUnitFutures LVBDataSource::getDataAsync( const LODNodes& nodes )
+{
+    return _impl->getDataAsync( nodes );
+}
+
+bool LVBDataSource::handles( const VolumeDataSourcePluginData& initData )
+{
+    return initData.getURI().getScheme() == "lvb";
+}
+
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _LVBDataSource_h_
+#define _LVBDataSource_h_
+
+#include <livre/core/data/VolumeDataSourcePlugin.h>
+
+#include <livre/lib/types.h>
+
+namespace livre
+{
+
+namespace detail
+{
+    class LVBDataSource;
+}
+
+/**
+ * Reads volumes in the native Livre bricked format.
+ *
+ * Parses URIs in the form:
+ *   lvb:///path/to/volume.lvb
+ *
+ * The brick index is loaded once at startup; each brick is then read with a
+ * single pread() and decompressed if needed. Files are written with the
+ * livreConvert tool. @sa LVBFormat.h
+ */
+class LVBDataSource : public VolumeDataSourcePlugin
+{
+public:
+    LVBDataSource( const VolumeDataSourcePluginData& initData );
+    virtual ~LVBDataSource();
+
+    /**
+     * Read the data for a given node.
+     * @param node LODNode to be read.
+     * @return The block data for the node.
+     */
+    MemoryUnitPtr getData( const LODNode& node ) final;
+
+    /** @return true, the bricks are read with positional reads */
+    bool isThreadSafe() const final { return true; }
+
+    /**
+     * Read a batch of bricks in file order. The batches are queued to one
+     * reader thread per data source, started with the first batch.
+     * @param nodes LODNodes to be read.
+     * @return One future per node, in the order of the given nodes.
+     */
+    MemoryUnitFutures getDataAsync( const LODNodes& nodes ) final;
+
+    /** @return true, getDataAsync() reads on a background thread */
+    bool hasAsyncReads() const final { return true; }
+
+    static bool handles( const VolumeDataSourcePluginData& initData );
+
+private:
+    detail::LVBDataSource* _impl;
+};
+
+}
+
+#endif // _LVBDataSource_h_
@@ -0,0 +1,81 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _LVBFormat_h_
+#define _LVBFormat_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+#include <livre/lib/data/BrickCompression.h>
+
+namespace livre
+{
+
+/**
+ * On-disk layout of the native Livre bricked volume format (.lvb).
+ *
+ * The file starts with an LVBHeader padded to LVB_ALIGNMENT bytes, followed
+ * by the brick payloads, each starting at a multiple of LVB_ALIGNMENT. The
+ * brick index is an array of LVBBrick entries sorted by NodeId::getId(), stored
+ * at LVBHeader::indexOffset. All values are stored in the byte order of the
+ * writing host. A reader finds LVB_MAGIC_SWAPPED in files of the other byte
+ * order, which are rejected.
+ */
+const uint32_t LVB_MAGIC = 0x3142564c; //!< "LVB1"
+const uint32_t LVB_MAGIC_SWAPPED = 0x4c564231; //!< LVB_MAGIC, other endianness
+const uint32_t LVB_VERSION = 1;
+const uint64_t LVB_ALIGNMENT = 4096; //!< Alignment of header and payloads
+
+/** The file header, describing the volume */
+struct LVBHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t dataType; //!< @sa DataType
+    uint32_t compCount;
+    uint32_t isBigEndian;
+    uint32_t voxels[ 3 ];
+    uint32_t maximumBlockSize[ 3 ];
+    uint32_t overlap[ 3 ];
+    uint32_t frameRange[ 2 ];
+    uint32_t reserved;
+    uint64_t brickCount; //!< Number of entries in the brick index
+    uint64_t indexOffset; //!< File offset of the brick index
+};
+
+/** One entry of the brick index */
+struct LVBBrick
+{
+    uint64_t nodeId; //!< NodeId::getId() of the brick
+    uint64_t offset; //!< File offset of the payload, LVB_ALIGNMENT aligned
+    uint32_t size; //!< Stored size of the payload in bytes
+    uint32_t compression; //!< @sa BrickCompression
+
+    bool operator<( const LVBBrick& rhs ) const { return nodeId < rhs.nodeId; }
+};
+
+/** @return the given size rounded up to the next multiple of LVB_ALIGNMENT. */
+inline uint64_t alignLVB( const uint64_t size )
+{
+    return ( size + LVB_ALIGNMENT - 1 ) & ~( LVB_ALIGNMENT - 1 );
+}
+
+}
+
+#endif // _LVBFormat_h_
@@ -0,0 +1,148 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/data/LVBWriter.h>
+#include <livre/lib/data/LVBFormat.h>
+
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/MemoryUnit.h>
+#include <livre/core/data/VolumeDataSource.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace livre
+{
+
+namespace
+{
+/** Write the bricks of all levels of one frame, coarsest level first */
+void _writeFrame( VolumeDataSource& source, const uint32_t frame,
+                  const BrickCompression compression, std::ofstream& file,
+                  uint64_t& offset, std::vector< LVBBrick >& bricks )
+{
+    const VolumeInformation& info = source.getVolumeInformation();
+    const Vector3ui blockSize = info.maximumBlockSize - info.overlap * 2;
+    const uint32_t depth = info.rootNode.getDepth();
+    std::vector< uint8_t > compressed;
+
+    for( uint32_t level = 0; level < depth; ++level )
+    {
+        const uint32_t scale = 1u << ( depth - level - 1 );
+        Vector3ui blocks = info.rootNode.getBlockSize( level );
+        for( size_t i = 0; i < 3; ++i )
+        {
+            const uint32_t levelVoxels = ( info.voxels[i] + scale - 1 ) / scale;
+            blocks[i] = std::min( blocks[i], ( levelVoxels + blockSize[i] -
+                                               1 ) / blockSize[i] );
+        }
+
+        for( uint32_t z = 0; z < blocks.z(); ++z )
+          for( uint32_t y = 0; y < blocks.y(); ++y )
+            for( uint32_t x = 0; x < blocks.x(); ++x )
+            {
+                const NodeId nodeId( level, Vector3ui( x, y, z ), frame );
+                ConstLODNodePtr node = source.getNode( nodeId );
+                ConstMemoryUnitPtr data = source.getData( *node );
+                if( !data || data->getMemSize() == 0 )
+                {
+                    LBWARN << "Skipping empty brick " << nodeId << std::endl;
+                    continue;
+                }
+
+                LVBBrick brick;
+                brick.nodeId = nodeId.getId();
+                brick.offset = offset;
+                brick.compression = BRICK_COMPRESSION_NONE;
+
+                const uint8_t* payload = data->getData< uint8_t >();
+                size_t size = data->getMemSize();
+                if( compressBrick( compression, payload, size, compressed ))
+                {
+                    brick.compression = compression;
+                    payload = &compressed[0];
+                    size = compressed.size();
+                }
+                brick.size = size;
+
+                file.seekp( offset );
+                file.write( reinterpret_cast< const char* >( payload ), size );
+                offset = alignLVB( offset + size );
+                bricks.push_back( brick );
+            }
+        LBINFO << "Frame " << frame << " level " << level << ": "
+               << bricks.size() << " bricks written" << std::endl;
+    }
+}
+}
+
+void writeLVB( VolumeDataSource& source, const std::string& filename,
+               const BrickCompression compression, const uint32_t frames )
+{
+    const VolumeInformation& info = source.getVolumeInformation();
+
+    const uint32_t firstFrame = info.frameRange[0];
+    uint32_t lastFrame = info.frameRange[1];
+    if( lastFrame == INVALID_FRAME || lastFrame <= firstFrame )
+        lastFrame = firstFrame + 1;
+    if( frames > 0 )
+        lastFrame = std::min( lastFrame, firstFrame + frames );
+
+    std::ofstream file( filename.c_str(), std::ios::binary );
+    if( !file )
+        LBTHROW( std::runtime_error( "Cannot open " + filename ));
+
+    uint64_t offset = LVB_ALIGNMENT;
+    std::vector< LVBBrick > bricks;
+    for( uint32_t frame = firstFrame; frame < lastFrame; ++frame )
+        _writeFrame( source, frame, compression, file, offset, bricks );
+
+    std::sort( bricks.begin(), bricks.end( ));
+    file.seekp( offset );
+    file.write( reinterpret_cast< const char* >( bricks.data( )),
+                bricks.size() * sizeof( LVBBrick ));
+
+    LVBHeader header;
+    ::memset( &header, 0, sizeof( header ));
+    header.magic = LVB_MAGIC;
+    header.version = LVB_VERSION;
+    header.dataType = info.dataType;
+    header.compCount = info.compCount;
+    header.isBigEndian = info.isBigEndian;
+    for( size_t i = 0; i < 3; ++i )
+    {
+        header.voxels[i] = info.voxels[i];
+        header.maximumBlockSize[i] = info.maximumBlockSize[i];
+        header.overlap[i] = info.overlap[i];
+    }
+    header.frameRange[0] = firstFrame;
+    header.frameRange[1] = lastFrame;
+    header.brickCount = bricks.size();
+    header.indexOffset = offset;
+
+    file.seekp( 0 );
+    file.write( reinterpret_cast< const char* >( &header ), sizeof( header ));
+    file.close();
+
+    if( !file )
+        LBTHROW( std::runtime_error( "Error while writing " + filename ));
+}
+
+}
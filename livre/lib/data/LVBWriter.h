@@ -0,0 +1,46 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _LVBWriter_h_
+#define _LVBWriter_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+#include <livre/lib/data/BrickCompression.h>
+
+namespace livre
+{
+
+/**
+ * Write the bricks of all levels of a volume to a native bricked volume file
+ * (.lvb), coarsest level first, \see LVBFormat.h. Empty bricks are skipped.
+ * @param source The volume to convert.
+ * @param filename The path of the .lvb file.
+ * @param compression The compression of the bricks, bricks which do not
+ *        compress are stored uncompressed.
+ * @param frames The number of frames to write, 0 for all of them, or one if
+ *        the frame range of the source is unbounded.
+ * @throw std::runtime_error if the file cannot be written.
+ */
+LIVRE_API void writeLVB( VolumeDataSource& source, const std::string& filename,
+                         BrickCompression compression, uint32_t frames = 0 );
+
+}
+
+#endif // _LVBWriter_h_
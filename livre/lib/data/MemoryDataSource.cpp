@@ -22,6 +22,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <livre/core/defines.h>
 #include <livre/core/data/LODNode.h>
 #include <livre/core/data/MemoryUnit.h>
 #include <livre/core/dash/DashRenderNode.h>
@@ -29,12 +30,90 @@
 #include <livre/lib/data/MemoryDataSource.h>
 #include <lunchbox/pluginRegisterer.h>
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 namespace livre
 {
 
 namespace
 {
    lunchbox::PluginRegisterer< MemoryDataSource > registerer;
+
+/** Integer hash with good avalanche, computed on 32 bit lanes below */
+inline uint32_t _hash( uint32_t x )
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+#ifdef __SSE2__
+/** 32 bit lane multiplication, SSE2 only multiplies the even lanes */
+inline __m128i _mullo( const __m128i a, const __m128i b )
+{
+    const __m128i even = _mm_mul_epu32( a, b );
+    const __m128i odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ),
+                                       _mm_srli_epi64( b, 32 ));
+    return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE(0,0,2,0)),
+                               _mm_shuffle_epi32( odd, _MM_SHUFFLE(0,0,2,0)));
+}
+
+/** _hash() of four lanes */
+inline __m128i _hash( __m128i x )
+{
+    x = _mm_xor_si128( x, _mm_srli_epi32( x, 16 ));
+    x = _mullo( x, _mm_set1_epi32( 0x7feb352d ));
+    x = _mm_xor_si128( x, _mm_srli_epi32( x, 15 ));
+    x = _mullo( x, _mm_set1_epi32( int32_t( 0x846ca68bu )));
+    x = _mm_xor_si128( x, _mm_srli_epi32( x, 16 ));
+    return x;
+}
+
+/** @return the noise values of four voxels, in the low byte of each lane */
+inline __m128i _noise( const __m128i index, const __m128i threshold )
+{
+    const __m128i hash = _hash( index );
+    const __m128i keep = _mm_cmplt_epi32(
+        _mm_and_si128( hash, _mm_set1_epi32( 0xffffff )), threshold );
+    const __m128i value = _mm_or_si128( _mm_srli_epi32( hash, 24 ),
+                                        _mm_set1_epi32( 1 ));
+    return _mm_and_si128( value, keep );
+}
+
+/** Store 16 values of 0..255 from four vectors of 32 bit lanes */
+inline void _store16( uint8_t* data, const __m128i a, const __m128i b,
+                      const __m128i c, const __m128i d )
+{
+    _mm_storeu_si128( reinterpret_cast< __m128i* >( data ),
+                      _mm_packus_epi16( _mm_packs_epi32( a, b ),
+                                        _mm_packs_epi32( c, d )));
+}
+#endif
+
+inline uint32_t _hash( const uint32_t seed, const Identifier id )
+{
+    return _hash( seed ^ _hash( uint32_t( id ) ^ _hash( uint32_t( id >> 32 ))));
+}
+
+/** @return a hash mapped to [0,1] */
+inline float _unit( const uint32_t hash )
+{
+    return float( hash >> 8 ) / float( 1u << 24 );
+}
+
+template< class T >
+T _getQuery( const servus::URI& uri, const std::string& key,
+             const T& defaultValue )
+{
+    servus::URI::ConstKVIter i = uri.findQuery( key );
+    return i == uri.queryEnd() ? defaultValue
+                               : boost::lexical_cast< T >( i->second );
+}
 }
 
 MemoryDataSource::MemoryDataSource( const VolumeDataSourcePluginData& initData )
@@ -47,14 +126,30 @@ MemoryDataSource::MemoryDataSource( const VolumeDataSourcePluginData& initData )
                              boost::is_any_of( "," ));
 
     using boost::lexical_cast;
+    std::string pattern;
     try
     {
-        servus::URI::ConstKVIter i = uri.findQuery( "sparsity" );
-        _sparsity = i == uri.queryEnd() ? 1.0f : lexical_cast<float>(i->second);
+        _sparsity = _getQuery< float >( uri, "sparsity", 1.0f );
+        _seed = _getQuery< uint32_t >( uri, "seed", 0u );
+        _nSpheres = _getQuery< uint32_t >( uri, "spheres", 16u );
+        pattern = _getQuery< std::string >( uri, "pattern",
+                                    _sparsity < 1.f ? "noise" : "constant" );
     }
     catch( boost::bad_lexical_cast& except )
         LBTHROW( std::runtime_error( except.what() ));
 
+    if( pattern == "constant" )
+        _pattern = PATTERN_CONSTANT;
+    else if( pattern == "noise" )
+        _pattern = PATTERN_NOISE;
+    else if( pattern == "spheres" )
+        _pattern = PATTERN_SPHERES;
+    else if( pattern == "gradient" )
+        _pattern = PATTERN_GRADIENT;
+    else
+        LBTHROW( std::runtime_error( "Unknown memory data pattern " +
+                                     pattern ));
+
     if( parameters.size() < 4 ) // use defaults
     {
         _volumeInfo.voxels = Vector3ui( 4096 );
@@ -89,30 +184,189 @@ MemoryUnitPtr MemoryDataSource::getData( const LODNode& node )
     const Vector3i blockSize = node.getBlockSize() + _volumeInfo.overlap * 2;
     const size_t dataSize = blockSize.product() * _volumeInfo.compCount *
                             _volumeInfo.getBytesPerVoxel();
-    const Identifier nodeID = node.getNodeId().getId();
-    const uint8_t* id = reinterpret_cast< const uint8_t* >( &nodeID );
-    const uint8_t value =  ( id[0] ^ id[1] ^ id[2] ^ id[3] ) + 16 +
-        127 * std::sin( ((float)node.getNodeId().getFrame() + 1) / 200.f);
 
     AllocMemoryUnitPtr memoryUnit( new AllocMemoryUnit );
     memoryUnit->alloc( dataSize );
     uint8_t* data = memoryUnit->getData< uint8_t >();
 
-    if( _sparsity < 1.f )
+    switch( _pattern )
+    {
+    case PATTERN_CONSTANT:
+    {
+        const Identifier nodeID = node.getNodeId().getId();
+        const uint8_t* id = reinterpret_cast< const uint8_t* >( &nodeID );
+        const uint8_t value =  ( id[0] ^ id[1] ^ id[2] ^ id[3] ) + 16 +
+            127 * std::sin( ((float)node.getNodeId().getFrame() + 1) / 200.f);
+        ::memset( data, value, dataSize );
+        break;
+    }
+    case PATTERN_NOISE:
+        _generateNoise( node, data, dataSize );
+        break;
+    case PATTERN_SPHERES:
+        _generateSpheres( node, data );
+        break;
+    case PATTERN_GRADIENT:
+        _generateGradient( node, data );
+        break;
+    }
+    return memoryUnit;
+}
+
+void MemoryDataSource::_generateNoise( const LODNode& node, uint8_t* data,
+                                       const size_t size ) const
+{
+    const uint32_t key = _hash( _seed, node.getNodeId().getId( ));
+    const uint32_t threshold =
+        uint32_t( std::max( 0.f, std::min( _sparsity, 1.f )) * ( 1u << 24 ));
+
+    size_t begin = 0;
+#ifdef __SSE2__
+    const __m128i limit = _mm_set1_epi32( int32_t( threshold ));
+    const __m128i four = _mm_set1_epi32( 4 );
+    __m128i index = _mm_add_epi32( _mm_set1_epi32( int32_t( key )),
+                                   _mm_setr_epi32( 0, 1, 2, 3 ));
+    for( ; begin + 16 <= size; begin += 16 )
+    {
+        const __m128i a = _noise( index, limit );
+        index = _mm_add_epi32( index, four );
+        const __m128i b = _noise( index, limit );
+        index = _mm_add_epi32( index, four );
+        const __m128i c = _noise( index, limit );
+        index = _mm_add_epi32( index, four );
+        const __m128i d = _noise( index, limit );
+        index = _mm_add_epi32( index, four );
+        _store16( data + begin, a, b, c, d );
+    }
+#endif
+
+    // scalar fallback and remainder, vectorized by the compiler if it can
+#ifdef LIVRE_USE_OPENMP
+#  pragma omp simd
+#endif
+    for( size_t i = begin; i < size; ++i )
+    {
+        const uint32_t hash = _hash( key + uint32_t( i ));
+        data[ i ] = ( hash & 0xffffffu ) < threshold ?
+                        uint8_t(( hash >> 24 ) | 1u ) : 0;
+    }
+}
+
+void MemoryDataSource::_generateSpheres( const LODNode& node,
+                                         uint8_t* data ) const
+{
+    const Vector3i& overlap = _volumeInfo.overlap;
+    const Vector3i brickSize = node.getBlockSize() + overlap * 2;
+    const Vector3i start = node.getAbsolutePosition() * node.getBlockSize() -
+                           overlap;
+    const float scale = 1u << ( _volumeInfo.rootNode.getDepth() -
+                                node.getRefLevel() - 1 );
+    const Vector3f voxels( _volumeInfo.voxels );
+    const float minSize = std::min( voxels.x(), std::min( voxels.y(),
+                                                          voxels.z( )));
+
+    ::memset( data, 0, brickSize.product( ));
+
+    // The spheres only depend on the seed and the frame, so they are the same
+    // in all bricks and levels. Each sphere fills one span per brick row.
+    const uint32_t frameKey =
+        _hash( _seed ^ _hash( node.getNodeId().getFrame( )));
+    for( uint32_t i = 0; i < _nSpheres; ++i )
     {
-        for( int32_t i = 0; i < blockSize.product(); ++i )
+        const uint32_t key = _hash( frameKey + i * 6 );
+        const Vector3f center( _unit( _hash( key + 1 )) * voxels.x() / scale,
+                               _unit( _hash( key + 2 )) * voxels.y() / scale,
+                               _unit( _hash( key + 3 )) * voxels.z() / scale );
+        const float radius = ( 0.02f + 0.08f * _unit( _hash( key + 4 ))) *
+                             minSize / scale;
+        const uint8_t value = 64 + _hash( key + 5 ) % 192;
+
+        const int32_t zBegin = std::max( 0, int32_t( std::ceil(
+                                   center.z() - radius - 0.5f )) - start.z( ));
+        const int32_t zEnd = std::min( brickSize.z(), int32_t( std::floor(
+                                 center.z() + radius - 0.5f )) - start.z() + 1);
+        for( int32_t z = zBegin; z < zEnd; ++z )
         {
-            const int random = rand() % 1000000 + 1;
-            if( random < 1000000 * _sparsity )
-                data[ i ] = value;
-            else
-                data[ i ] = 0;
+            const float dz = start.z() + z + 0.5f - center.z();
+            for( int32_t y = 0; y < brickSize.y(); ++y )
+            {
+                const float dy = start.y() + y + 0.5f - center.y();
+                const float d2 = radius * radius - dy * dy - dz * dz;
+                if( d2 <= 0.f )
+                    continue;
+
+                const float half = std::sqrt( d2 );
+                const int32_t xBegin = std::max( 0, int32_t( std::ceil(
+                                      center.x() - half - 0.5f )) - start.x( ));
+                const int32_t xEnd = std::min( brickSize.x(), int32_t(
+                    std::floor( center.x() + half - 0.5f )) - start.x() + 1 );
+                if( xEnd > xBegin )
+                    ::memset( data + ( size_t( z ) * brickSize.y() + y ) *
+                                     brickSize.x() + xBegin,
+                              value, xEnd - xBegin );
+            }
         }
     }
-    else
-        ::memset( data, value, dataSize );
+}
 
-    return memoryUnit;
+void MemoryDataSource::_generateGradient( const LODNode& node,
+                                          uint8_t* data ) const
+{
+    const Vector3i& overlap = _volumeInfo.overlap;
+    const Vector3i brickSize = node.getBlockSize() + overlap * 2;
+    const Vector3i start = node.getAbsolutePosition() * node.getBlockSize() -
+                           overlap;
+    const float scale = 1u << ( _volumeInfo.rootNode.getDepth() -
+                                node.getRefLevel() - 1 );
+
+    // value = 255 * ( x / X + y / Y + z / Z ) / 3 in full resolution voxels
+    const Vector3f step( 85.f * scale / _volumeInfo.voxels.x(),
+                         85.f * scale / _volumeInfo.voxels.y(),
+                         85.f * scale / _volumeInfo.voxels.z( ));
+    for( int32_t z = 0; z < brickSize.z(); ++z )
+    {
+        for( int32_t y = 0; y < brickSize.y(); ++y )
+        {
+            const float base = ( start.y() + y + 0.5f ) * step.y() +
+                               ( start.z() + z + 0.5f ) * step.z() +
+                               ( start.x() + 0.5f ) * step.x();
+            uint8_t* row = data + ( size_t( z ) * brickSize.y() + y ) *
+                                  brickSize.x();
+            int32_t begin = 0;
+#ifdef __SSE2__
+            const __m128 base4 = _mm_set1_ps( base );
+            const __m128 step4 = _mm_set1_ps( step.x( ));
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 max = _mm_set1_ps( 255.f );
+            const __m128i four = _mm_set1_epi32( 4 );
+            __m128i x4 = _mm_setr_epi32( 0, 1, 2, 3 );
+            __m128i values[4];
+            for( ; begin + 16 <= brickSize.x(); begin += 16 )
+            {
+                for( size_t i = 0; i < 4; ++i )
+                {
+                    const __m128 value = _mm_add_ps( base4, _mm_mul_ps(
+                                             _mm_cvtepi32_ps( x4 ), step4 ));
+                    values[i] = _mm_cvttps_epi32(
+                        _mm_max_ps( zero, _mm_min_ps( value, max )));
+                    x4 = _mm_add_epi32( x4, four );
+                }
+                _store16( row + begin, values[0], values[1], values[2],
+                          values[3] );
+            }
+#endif
+
+            // scalar fallback and remainder
+#ifdef LIVRE_USE_OPENMP
+#  pragma omp simd
+#endif
+            for( int32_t x = begin; x < brickSize.x(); ++x )
+            {
+                const float value = base + x * step.x();
+                row[ x ] = uint8_t( std::max( 0.f, std::min( value, 255.f )));
+            }
+        }
+    }
 }
 
 bool MemoryDataSource::handles( const VolumeDataSourcePluginData& initData )
@@ -30,12 +30,28 @@ namespace livre
 /**
  * Generates in-memory volume data.
  *
- * Parses URIs in the form:   mem:///?sparsity=1.0#1024,1024,1024,32
+ * Parses URIs in the form:
+ *   mem:///?sparsity=1.0&pattern=noise&seed=0&spheres=16#1024,1024,1024,32
+ *
+ * The "pattern" parameter selects the generated data:
+ * - constant: one value per brick (default if sparsity is 1.0)
+ * - noise: random values, of which a "sparsity" fraction is not empty
+ *   (default if sparsity is below 1.0)
+ * - spheres: "spheres" random spheres of different values, consistent across
+ *   bricks and levels of detail
+ * - gradient: a linear ramp along the volume diagonal
  *
  * The "sparsity" parameter is the sparsity of the data between 0.0
  * and 1.0. 1.0 means no voxels will be empty. 0.0 means all voxels
  * will be empty. 0.001 means 99.9% of the voxels will be empty.
  *
+ * The data is computed from hashes of the "seed" parameter and the node
+ * identifier, so a brick always has the same content, independent of the
+ * thread or the order it is generated in. The noise and gradient generators
+ * compute 16 voxels at a time with SSE2 intrinsics, or with scalar loops on
+ * other architectures, and the spheres are filled span by span, so generation
+ * runs close to memory bandwidth.
+ *
  * The rest of the parameters are total number of voxels in X,Y,Z and
  * the block size.
  */
@@ -53,9 +69,29 @@ public:
      */
     MemoryUnitPtr getData( const LODNode& node ) final;
 
+    /** @return true, the bricks are generated without shared state */
+    bool isThreadSafe() const final { return true; }
+
     static bool handles( const VolumeDataSourcePluginData& initData );
 
+private:
+    enum Pattern
+    {
+        PATTERN_CONSTANT,
+        PATTERN_NOISE,
+        PATTERN_SPHERES,
+        PATTERN_GRADIENT
+    };
+
+    void _generateNoise( const LODNode& node, uint8_t* data,
+                         size_t size ) const;
+    void _generateSpheres( const LODNode& node, uint8_t* data ) const;
+    void _generateGradient( const LODNode& node, uint8_t* data ) const;
+
     float _sparsity;
+    Pattern _pattern;
+    uint32_t _seed;
+    uint32_t _nSpheres;
 };
 
 }
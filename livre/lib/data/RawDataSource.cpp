@@ -0,0 +1,321 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include <livre/core/defines.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/MemoryUnit.h>
+#include <livre/core/maths/maths.h>
+
+#include <livre/lib/data/RawDataSource.h>
+
+#include <lunchbox/memoryMap.h>
+#include <lunchbox/pluginRegisterer.h>
+
+namespace livre
+{
+
+namespace
+{
+   lunchbox::PluginRegisterer< RawDataSource > registerer;
+
+DataType _getDataType( const std::string& type )
+{
+    if( type == "uint8" )
+        return DT_UINT8;
+    if( type == "int8" )
+        return DT_INT8;
+    if( type == "uint16" )
+        return DT_UINT16;
+    if( type == "int16" )
+        return DT_INT16;
+    if( type == "uint32" )
+        return DT_UINT32;
+    if( type == "int32" )
+        return DT_INT32;
+    if( type == "float" )
+        return DT_FLOAT32;
+    if( type == "double" )
+        return DT_FLOAT64;
+    return DT_UNDEFINED;
+}
+
+template< class T >
+T _getQuery( const servus::URI& uri, const std::string& key,
+             const T& defaultValue )
+{
+    servus::URI::ConstKVIter i = uri.findQuery( key );
+    if( i == uri.queryEnd( ))
+        return defaultValue;
+    try
+    {
+        return boost::lexical_cast< T >( i->second );
+    }
+    catch( boost::bad_lexical_cast& except )
+        LBTHROW( std::runtime_error( "Invalid value for raw parameter " + key +
+                                     ": " + except.what( )));
+}
+}
+
+namespace detail
+{
+
+class RawDataSource
+{
+public:
+    RawDataSource( VolumeInformation& volumeInfo,
+                   const VolumeDataSourcePluginData& initData )
+        : _volumeInfo( volumeInfo )
+        , _data( 0 )
+    {
+        const servus::URI& uri = initData.getURI();
+
+        std::vector< std::string > dims;
+        servus::URI::ConstKVIter i = uri.findQuery( "dims" );
+        if( i != uri.queryEnd( ))
+            boost::algorithm::split( dims, i->second, boost::is_any_of( "," ));
+        if( dims.size() != 3 )
+            LBTHROW( std::runtime_error( "Raw volume needs dims=X,Y,Z" ));
+
+        try
+        {
+            for( size_t j = 0; j < 3; ++j )
+                _volumeInfo.voxels[ j ] =
+                    boost::lexical_cast< uint32_t >( dims[ j ] );
+        }
+        catch( boost::bad_lexical_cast& except )
+            LBTHROW( std::runtime_error( except.what( )));
+
+        _volumeInfo.dataType =
+            _getDataType( _getQuery< std::string >( uri, "type", "uint8" ));
+        if( _volumeInfo.dataType == DT_UNDEFINED )
+            LBTHROW( std::runtime_error( "Unknown raw volume data type" ));
+
+        _volumeInfo.overlap = Vector3ui( _getQuery< uint32_t >( uri, "overlap",
+                                                                4u ));
+        const Vector3ui blockSize( _getQuery< uint32_t >( uri, "block", 32u ));
+        _volumeInfo.maximumBlockSize = blockSize + _volumeInfo.overlap * 2;
+        _volumeInfo.compCount = 1;
+        _volumeInfo.frameRange = Vector2ui( 0, 1 );
+
+        // raw://data/volume.img puts the first path element into the host
+        const std::string path = uri.getHost() + uri.getPath();
+        const size_t offset = _getQuery< size_t >( uri, "offset", 0 );
+        const size_t volumeSize = size_t( _volumeInfo.voxels.x( )) *
+                                  _volumeInfo.voxels.y() *
+                                  _volumeInfo.voxels.z() *
+                                  _volumeInfo.getBytesPerVoxel();
+
+        const uint8_t* data = static_cast< const uint8_t* >( _map.map( path ));
+        if( !data )
+            LBTHROW( std::runtime_error( "Cannot map raw volume " + path ));
+        if( _map.getSize() < offset + volumeSize )
+            LBTHROW( std::runtime_error( "Raw volume " + path +
+                                         " is smaller than its dimensions" ));
+        _data = data + offset;
+
+        if( !fillRegularVolumeInfo( _volumeInfo ))
+            LBTHROW( std::runtime_error( "Cannot setup the regular tree" ));
+    }
+
+    MemoryUnitPtr getData( const LODNode& node )
+    {
+        switch( _volumeInfo.dataType )
+        {
+        case DT_UINT8:
+            return _getBrick< uint8_t >( node );
+        case DT_INT8:
+            return _getBrick< int8_t >( node );
+        case DT_UINT16:
+            return _getBrick< uint16_t >( node );
+        case DT_INT16:
+            return _getBrick< int16_t >( node );
+        case DT_UINT32:
+            return _getBrick< uint32_t >( node );
+        case DT_INT32:
+            return _getBrick< int32_t >( node );
+        case DT_FLOAT32:
+            return _getBrick< float >( node );
+        case DT_FLOAT64:
+            return _getBrick< double >( node );
+        case DT_UNDEFINED:
+            LBERROR << "Undefined data type" << std::endl;
+            break;
+        }
+        return MemoryUnitPtr();
+    }
+
+private:
+    /** @return the downsampling factor of the node's level. */
+    uint32_t _getScale( const LODNode& node ) const
+    {
+        const uint32_t depth = _volumeInfo.rootNode.getDepth();
+        return 1u << ( depth - node.getRefLevel() - 1 );
+    }
+
+    template< class T >
+    MemoryUnitPtr _getBrick( const LODNode& node ) const
+    {
+        const Vector3i& overlap = _volumeInfo.overlap;
+        const Vector3i brickSize = node.getBlockSize() + overlap * 2;
+        const Vector3i start = node.getAbsolutePosition() *
+                               node.getBlockSize() - overlap;
+        const uint32_t scale = _getScale( node );
+        const Vector3i& voxels = _volumeInfo.voxels;
+        const size_t dataSize = brickSize.product() * sizeof( T );
+
+        // Full resolution bricks spanning whole slices are contiguous
+        if( scale == 1 && start.x() == 0 && start.y() == 0 &&
+            brickSize.x() == voxels.x() && brickSize.y() == voxels.y() &&
+            start.z() >= 0 && start.z() + brickSize.z() <= voxels.z( ))
+        {
+            const size_t sliceSize = size_t( voxels.x( )) * voxels.y();
+            const T* ptr = reinterpret_cast< const T* >( _data ) +
+                           sliceSize * start.z();
+            return MemoryUnitPtr(
+                new ConstMemoryUnit( reinterpret_cast< const uint8_t* >( ptr ),
+                                     dataSize ));
+        }
+
+        AllocMemoryUnitPtr memoryUnit( new AllocMemoryUnit );
+        memoryUnit->alloc( dataSize );
+        T* brick = memoryUnit->getData< T >();
+
+        if( scale == 1 )
+            _copyBrick( start, brickSize, brick );
+        else
+            _downsampleBrick( start, brickSize, scale, brick );
+        return memoryUnit;
+    }
+
+    /** Copy one full resolution brick, clamping the overlap at the borders */
+    template< class T >
+    void _copyBrick( const Vector3i& start, const Vector3i& brickSize,
+                     T* brick ) const
+    {
+        const Vector3i& voxels = _volumeInfo.voxels;
+        const T* source = reinterpret_cast< const T* >( _data );
+        const int32_t xBegin = std::max( 0, -start.x( ));
+        const int32_t xEnd = std::min( brickSize.x(), voxels.x() - start.x( ));
+
+#ifdef LIVRE_USE_OPENMP
+#  pragma omp parallel for
+#endif
+        for( int32_t z = 0; z < brickSize.z(); ++z )
+        {
+            const size_t sz = maths::clamp( start.z() + z, 0, voxels.z() - 1 );
+            for( int32_t y = 0; y < brickSize.y(); ++y )
+            {
+                const size_t sy = maths::clamp( start.y() + y, 0,
+                                                voxels.y() - 1 );
+                const T* row = source + ( sz * voxels.y() + sy ) * voxels.x();
+                T* dst = brick + ( size_t( z ) * brickSize.y() + y ) *
+                                 brickSize.x();
+
+                for( int32_t x = 0; x < xBegin; ++x )
+                    dst[ x ] = row[ 0 ];
+                if( xEnd > xBegin )
+                    ::memcpy( dst + xBegin, row + start.x() + xBegin,
+                              ( xEnd - xBegin ) * sizeof( T ));
+                for( int32_t x = std::max( xBegin, xEnd );
+                     x < brickSize.x(); ++x )
+                {
+                    dst[ x ] = row[ voxels.x() - 1 ];
+                }
+            }
+        }
+    }
+
+    /** Box-filter the full resolution voxels into a coarser level brick */
+    template< class T >
+    void _downsampleBrick( const Vector3i& start, const Vector3i& brickSize,
+                           const uint32_t scale, T* brick ) const
+    {
+        const Vector3i& voxels = _volumeInfo.voxels;
+        const T* source = reinterpret_cast< const T* >( _data );
+        const int32_t iScale = scale;
+
+#ifdef LIVRE_USE_OPENMP
+#  pragma omp parallel for
+#endif
+        for( int32_t z = 0; z < brickSize.z(); ++z )
+        {
+            const int32_t z0 = maths::clamp( ( start.z() + z ) * iScale, 0,
+                                             voxels.z() - 1 );
+            const int32_t z1 = std::min( z0 + iScale, voxels.z( ));
+            for( int32_t y = 0; y < brickSize.y(); ++y )
+            {
+                const int32_t y0 = maths::clamp( ( start.y() + y ) * iScale, 0,
+                                                 voxels.y() - 1 );
+                const int32_t y1 = std::min( y0 + iScale, voxels.y( ));
+                T* dst = brick + ( size_t( z ) * brickSize.y() + y ) *
+                                 brickSize.x();
+                for( int32_t x = 0; x < brickSize.x(); ++x )
+                {
+                    const int32_t x0 = maths::clamp( ( start.x() + x ) * iScale,
+                                                     0, voxels.x() - 1 );
+                    const int32_t x1 = std::min( x0 + iScale, voxels.x( ));
+
+                    double sum = 0.0;
+                    for( int32_t sz = z0; sz < z1; ++sz )
+                        for( int32_t sy = y0; sy < y1; ++sy )
+                        {
+                            const T* row = source +
+                                ( size_t( sz ) * voxels.y() + sy ) * voxels.x();
+                            for( int32_t sx = x0; sx < x1; ++sx )
+                                sum += row[ sx ];
+                        }
+                    const size_t count = size_t( z1 - z0 ) * ( y1 - y0 ) *
+                                         ( x1 - x0 );
+                    dst[ x ] = T( sum / count );
+                }
+            }
+        }
+    }
+
+    VolumeInformation& _volumeInfo;
+    lunchbox::MemoryMap _map;
+    const uint8_t* _data;
+};
+
+}
+
+RawDataSource::RawDataSource( const VolumeDataSourcePluginData& initData )
+    : _impl( new detail::RawDataSource( _volumeInfo, initData ))
+{
+}
+
+RawDataSource::~RawDataSource()
+{
+    delete _impl;
+}
+
+MemoryUnitPtr RawDataSource::getData( const LODNode& node )
+{
+    return _impl->getData( node );
+}
+
+bool RawDataSource::handles( const VolumeDataSourcePluginData& initData )
+{
+    return initData.getURI().getScheme() == "raw";
+}
+
+}
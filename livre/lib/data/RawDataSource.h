@@ -0,0 +1,81 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _RawDataSource_h_
+#define _RawDataSource_h_
+
+#include <livre/core/data/VolumeDataSourcePlugin.h>
+
+#include <livre/lib/types.h>
+
+namespace livre
+{
+
+namespace detail
+{
+    class RawDataSource;
+}
+
+/**
+ * Reads flat, headerless raw volumes through a memory mapping.
+ *
+ * Parses URIs in the form:
+ *   raw:///path/to/volume.img?dims=1024,1024,512&type=uint16
+ *
+ * Mandatory parameters:
+ * - dims: number of voxels in X,Y,Z
+ *
+ * Optional parameters:
+ * - type: uint8 (default), int8, uint16, int16, uint32, int32, float, double
+ * - block: the block size without overlap (default 32)
+ * - overlap: the overlap voxels between blocks (default 4)
+ * - offset: the number of header bytes to skip (default 0)
+ *
+ * The voxels are expected in X-fastest order. Full resolution bricks which are
+ * contiguous in the file (full X and Y extent, no overlap padding) are returned
+ * as views into the mapping without any copy. This needs overlap=0 and a block
+ * size covering X and Y, e.g. for stacks of slices streamed as they are. All
+ * other bricks are extracted from the mapping, and bricks of the coarser levels
+ * are box-filtered on the fly.
+ */
+class RawDataSource : public VolumeDataSourcePlugin
+{
+public:
+    RawDataSource( const VolumeDataSourcePluginData& initData );
+    virtual ~RawDataSource();
+
+    /**
+     * Read the data for a given node.
+     * @param node LODNode to be read.
+     * @return The block data for the node.
+     */
+    MemoryUnitPtr getData( const LODNode& node ) final;
+
+    /** @return true, the bricks are read from a read-only mapping */
+    bool isThreadSafe() const final { return true; }
+
+    static bool handles( const VolumeDataSourcePluginData& initData );
+
+private:
+    detail::RawDataSource* _impl;
+};
+
+}
+
+#endif // _RawDataSource_h_
@@ -26,13 +26,19 @@
 namespace livre
 {
 
+class CacheBudgetManager;
+class CompressedCache;
+class DataLoaderPool;
 class DataUploadProcessor;
+class DiskCache;
+class LRUCache;
 class RenderNodeVisitor;
 class TextureCache;
 class TextureDataCache;
 class TextureDataObject;
 class TextureObject;
 class TextureUploadProcessor;
+class TierWriter;
 struct ApplicationParameters;
 struct ClientParameters;
 struct EFPrefetchAlgorithmParameters;
@@ -50,6 +56,9 @@ typedef boost::shared_ptr< RESTParameters > RESTParametersPtr;
 typedef boost::shared_ptr< const RESTParameters > ConstRESTParametersPtr;
 
 typedef boost::shared_ptr< TextureCache > TextureCachePtr;
+typedef boost::shared_ptr< CompressedCache > CompressedCachePtr;
+typedef boost::shared_ptr< DiskCache > DiskCachePtr;
+typedef boost::shared_ptr< TierWriter > TierWriterPtr;
 typedef boost::shared_ptr< DataUploadProcessor > DataUploadProcessorPtr;
 typedef boost::shared_ptr< TextureUploadProcessor > TextureUploadProcessorPtr;
 typedef boost::shared_ptr< const DataUploadProcessor > ConstDataUploadProcessorPtr;
@@ -62,6 +71,7 @@ typedef boost::intrusive_ptr< TextureDataObject > TextureDataObjectPtr;
 typedef boost::intrusive_ptr< TextureObject > TextureObjectPtr;
 
 typedef boost::scoped_ptr< TextureDataCache > TextureDataCachePtr;
+typedef boost::scoped_ptr< DataLoaderPool > DataLoaderPoolPtr;
 
 /** Map definitions */
 typedef boost::unordered_map< uint32_t, DataUploadProcessorPtr > DataUploadProcessorPtrMap;
@@ -0,0 +1,252 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/uploaders/DataLoaderPool.h>
+#include <livre/lib/cache/TextureDataCache.h>
+#include <livre/core/cache/CacheObject.h>
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/VolumeDataSource.h>
+
+#include <boost/foreach.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <deque>
+
+namespace livre
+{
+
+namespace detail
+{
+
+class DataLoaderPool
+{
+public:
+    DataLoaderPool( TextureDataCache& textureDataCache, const size_t nThreads )
+        : _cache( textureDataCache )
+        , _nThreads( std::max( nThreads, size_t( 1 )))
+        , _stopping( false )
+    {
+        for( size_t i = 0; i < _nThreads; ++i )
+            _threads.create_thread( [this]() { _run(); } );
+    }
+
+    ~DataLoaderPool()
+    {
+        {
+            boost::unique_lock< boost::mutex > lock( _mutex );
+            _stopping = true;
+            _queue.clear();
+            _queued.clear();
+        }
+        _workCondition.notify_all();
+        _threads.join_all();
+
+        BOOST_FOREACH( const CacheId cacheId, _readAhead )
+            _cache.getDataSource()->cancelReadAhead( NodeId( cacheId ));
+    }
+
+    void setQueue( const CacheIds& cacheIds )
+    {
+        CacheIds cancelled;
+        {
+            boost::unique_lock< boost::mutex > lock( _mutex );
+            _queue.clear();
+            _queued.clear();
+            BOOST_FOREACH( const CacheId cacheId, cacheIds )
+            {
+                if( !_loading.count( cacheId ) &&
+                    _queued.insert( cacheId ).second )
+                {
+                    _queue.push_back( cacheId );
+                }
+            }
+
+            for( CacheIdSet::iterator i = _readAhead.begin();
+                 i != _readAhead.end(); )
+            {
+                if( _queued.count( *i ) || _loading.count( *i ))
+                    ++i;
+                else
+                {
+                    cancelled.push_back( *i );
+                    _readAhead.erase( i++ );
+                }
+            }
+        }
+        _workCondition.notify_all();
+
+        BOOST_FOREACH( const CacheId cacheId, cancelled )
+            _cache.getDataSource()->cancelReadAhead( NodeId( cacheId ));
+    }
+
+    ConstCacheObjectPtr load( const CacheId cacheId )
+    {
+        {
+            boost::unique_lock< boost::mutex > lock( _mutex );
+            while( _loading.count( cacheId ))
+                _doneCondition.wait( lock );
+
+            // the loader threads skip the queued ids which are not in _queued
+            _queued.erase( cacheId );
+            _loading.insert( cacheId );
+        }
+        return _load( cacheId );
+    }
+
+    size_t getQueueSize() const
+    {
+        boost::unique_lock< boost::mutex > lock( _mutex );
+        return _queued.size();
+    }
+
+    size_t getThreadCount() const { return _nThreads; }
+
+private:
+    void _run()
+    {
+        for( ;; )
+        {
+            CacheId cacheId = INVALID_CACHE_ID;
+            CacheIds readAhead;
+            {
+                boost::unique_lock< boost::mutex > lock( _mutex );
+                while( !_stopping && _queue.empty( ))
+                    _workCondition.wait( lock );
+                if( _stopping )
+                    return;
+
+                cacheId = _queue.front();
+                _queue.pop_front();
+                if( !_queued.erase( cacheId )) // taken by load()
+                    continue;
+                _loading.insert( cacheId );
+                readAhead = _nextReadAhead();
+            }
+            _startReadAhead( readAhead );
+            _load( cacheId );
+        }
+    }
+
+    /**
+     * @return the bricks to read ahead, so the next ones in the queue are read
+     *         by the data source while the current ones are loaded.
+     */
+    CacheIds _nextReadAhead()
+    {
+        CacheIds cacheIds;
+        size_t window = 0;
+        for( std::deque< CacheId >::const_iterator i = _queue.begin();
+             i != _queue.end() && window < _nThreads; ++i )
+        {
+            if( !_queued.count( *i ))
+                continue;
+            ++window;
+            if( _readAhead.insert( *i ).second )
+                cacheIds.push_back( *i );
+        }
+        return cacheIds;
+    }
+
+    void _startReadAhead( const CacheIds& cacheIds )
+    {
+        if( cacheIds.empty( ))
+            return;
+
+        const VolumeDataSourcePtr dataSource = _cache.getDataSource();
+        LODNodes nodes;
+        nodes.reserve( cacheIds.size( ));
+        BOOST_FOREACH( const CacheId cacheId, cacheIds )
+            nodes.push_back( *dataSource->getNode( NodeId( cacheId )));
+        dataSource->readAhead( nodes );
+    }
+
+    /** Loads a brick marked as loading, and unmarks it */
+    ConstCacheObjectPtr _load( const CacheId cacheId )
+    {
+        // keep a reference, so the object is not reclaimed while loading
+        const CacheObjectPtr textureData = _cache.getObjectFromCache( cacheId );
+        if( !textureData->isLoaded( ))
+            textureData->cacheLoad();
+
+        bool readAhead = false;
+        {
+            boost::unique_lock< boost::mutex > lock( _mutex );
+            _loading.erase( cacheId );
+            readAhead = _readAhead.erase( cacheId ) > 0;
+        }
+        _doneCondition.notify_all();
+
+        // the data read ahead is not taken if the brick was loaded before or
+        // from the compressed or disk cache
+        if( readAhead )
+            _cache.getDataSource()->cancelReadAhead( NodeId( cacheId ));
+        return textureData;
+    }
+
+    TextureDataCache& _cache;
+    const size_t _nThreads;
+
+    mutable boost::mutex _mutex;
+    boost::condition_variable _workCondition; //!< Bricks were queued
+    boost::condition_variable _doneCondition; //!< A brick was loaded
+    std::deque< CacheId > _queue; //!< In priority order, may hold stale ids
+    CacheIdSet _queued; //!< The ids of _queue to load
+    CacheIdSet _loading;
+    CacheIdSet _readAhead; //!< The ids read ahead by the data source
+    bool _stopping;
+
+    boost::thread_group _threads;
+};
+
+}
+
+DataLoaderPool::DataLoaderPool( TextureDataCache& textureDataCache,
+                                const size_t nThreads )
+    : _impl( new detail::DataLoaderPool( textureDataCache, nThreads ))
+{
+}
+
+DataLoaderPool::~DataLoaderPool()
+{
+    delete _impl;
+}
+
+void DataLoaderPool::setQueue( const CacheIds& cacheIds )
+{
+    _impl->setQueue( cacheIds );
+}
+
+ConstCacheObjectPtr DataLoaderPool::load( const CacheId cacheId )
+{
+    return _impl->load( cacheId );
+}
+
+size_t DataLoaderPool::getQueueSize() const
+{
+    return _impl->getQueueSize();
+}
+
+size_t DataLoaderPool::getThreadCount() const
+{
+    return _impl->getThreadCount();
+}
+
+}
@@ -0,0 +1,88 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _DataLoaderPool_h_
+#define _DataLoaderPool_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+#include <boost/noncopyable.hpp>
+
+namespace livre
+{
+
+namespace detail
+{
+    class DataLoaderPool;
+}
+
+/**
+ * The DataLoaderPool class loads the bricks of a \see TextureDataCache on a
+ * pool of threads, which take the bricks from a shared queue in priority order.
+ *
+ * The queue is replaced for every frame with the bricks to load, the most
+ * important first. A brick is only loaded by one thread at a time: the bricks
+ * being loaded are not queued again, and load() waits for them. The loader
+ * threads have no OpenGL context. They call the data source concurrently,
+ * which serializes the reads of plugins that are not thread safe, and have the
+ * data source read the next queued bricks ahead with its getDataAsync(), if
+ * the plugin reads asynchronously.
+ *
+ * All methods are thread safe.
+ */
+class DataLoaderPool : public boost::noncopyable
+{
+public:
+    /**
+     * @param textureDataCache The cache to load the bricks into.
+     * @param nThreads The number of loader threads, at least one.
+     */
+    LIVRE_API DataLoaderPool( TextureDataCache& textureDataCache,
+                              size_t nThreads );
+
+    /** Drops the queued bricks and waits for the bricks being loaded. */
+    LIVRE_API ~DataLoaderPool();
+
+    /**
+     * Replaces the queued bricks, the bricks being loaded are not queued.
+     * @param cacheIds The cache ids of the bricks, the most important first.
+     */
+    LIVRE_API void setQueue( const CacheIds& cacheIds );
+
+    /**
+     * Loads a brick on the calling thread, unless a loader thread has started
+     * to load it, in which case it waits for that load.
+     * @param cacheId The cache id of the brick.
+     * @return The brick, not loaded if loading failed.
+     */
+    LIVRE_API ConstCacheObjectPtr load( CacheId cacheId );
+
+    /** @return the number of queued bricks not being loaded yet. */
+    LIVRE_API size_t getQueueSize() const;
+
+    /** @return the number of loader threads. */
+    LIVRE_API size_t getThreadCount() const;
+
+private:
+    detail::DataLoaderPool* _impl;
+};
+
+}
+
+#endif // _DataLoaderPool_h_
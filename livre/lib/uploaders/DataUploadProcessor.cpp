@@ -27,18 +27,29 @@
 #include <livre/core/visitor/RenderNodeVisitor.h>
 #include <livre/lib/visitor/DFSTraversal.h>
 
+#include <livre/lib/uploaders/DataLoaderPool.h>
+#include <livre/lib/uploaders/LoadRequestQueue.h>
 #include <livre/lib/uploaders/DataUploadProcessor.h>
 #include <livre/core/dashpipeline/DashProcessorInput.h>
 #include <livre/lib/cache/TextureDataCache.h>
 #include <livre/lib/cache/TextureDataObject.h>
 #include <livre/lib/configuration/VolumeRendererParameters.h>
-#include <livre/lib/visitor/CollectionTraversal.h>
 #include <livre/lib/cache/LRUCachePolicy.h>
-#include <livre/lib/visitor/CollectionTraversal.h>
+#include <livre/core/cache/CacheStatistics.h>
+
+#include <lunchbox/scopedMutex.h>
+
+#include <boost/thread/thread.hpp>
 
 namespace livre
 {
 
+namespace
+{
+const float PREFETCH_TIME = 10.f; //!< Max prefetching per loop in ms
+const float PREFETCH_MEMORY_RATIO = 0.9f; //!< Of the cache to fill at most
+}
+
 #ifdef _ITT_DEBUG_
 #include <ittnotify.h>
 __itt_domain* ittDataLoadDomain = __itt_domain_create("Data Loading");
@@ -46,56 +57,40 @@ __itt_string_handle* ittDataComputationTask = __itt_string_handle_create("Data l
 __itt_string_handle* ittDataLoadTask = __itt_string_handle_create("Data loading task");
 #endif // _ITT_DEBUG_
 
-class DataLoaderVisitor : public RenderNodeVisitor
-{
-public:
-    DataLoaderVisitor( DashTreePtr dashTree, TextureDataCache& textureDataCache,
-                       ProcessorInputPtr processorInput,
-                       ProcessorOutputPtr processorOutput )
-        : RenderNodeVisitor( dashTree ),
-          _cache( textureDataCache ),
-          _input( processorInput ),
-          _output( processorOutput )
-    {}
-
-    void visit( DashRenderNode& renderNode, VisitState& state );
-
-private:
-    TextureDataCache& _cache;
-    ProcessorInputPtr _input;
-    ProcessorOutputPtr _output;
-    lunchbox::Clock _clock;
-};
-
-class DepthCollectorVisitor : public RenderNodeVisitor
+class RequestCollectorVisitor : public RenderNodeVisitor
 {
 public:
-    DepthCollectorVisitor( DashTreePtr dashTree,
-                           TextureDataCache& textureDataCache,
-                           ProcessorOutputPtr processorOutput,
-                           DashNodeVector& refLevelCollection )
+    RequestCollectorVisitor( DashTreePtr dashTree,
+                             TextureDataCache& textureDataCache,
+                             ProcessorOutputPtr processorOutput,
+                             const Frustum& frustum,
+                             LoadRequestQueue& loadQueue )
         : RenderNodeVisitor( dashTree ),
           _cache( textureDataCache ),
           _output( processorOutput ),
-          _collection( refLevelCollection )
+          _frustum( frustum ),
+          _loadQueue( loadQueue )
     {}
     void visit( DashRenderNode& node, VisitState& state ) final;
 
 private:
     TextureDataCache& _cache;
     ProcessorOutputPtr _output;
-    DashNodeVector& _collection;
+    const Frustum& _frustum;
+    LoadRequestQueue& _loadQueue;
 };
 
-class DepthSortedDataLoaderVisitor : public RenderNodeVisitor
+class PriorityDataLoaderVisitor : public RenderNodeVisitor
 {
 public:
-    DepthSortedDataLoaderVisitor( DashTreePtr dashTree,
+    PriorityDataLoaderVisitor( DashTreePtr dashTree,
                                   TextureDataCache& textureDataCache,
+                                  DataLoaderPool* loaderPool,
                                   ProcessorInputPtr processorInput,
                                   ProcessorOutputPtr processorOutput )
         : RenderNodeVisitor( dashTree )
         , _cache( textureDataCache )
+        , _loaderPool( loaderPool )
         , _input( processorInput )
         , _output( processorOutput )
     {}
@@ -103,33 +98,27 @@ public:
     void visit( DashRenderNode& renderNode, VisitState& state ) final;
 private:
     TextureDataCache& _cache;
+    DataLoaderPool* _loaderPool;
     ProcessorInputPtr _input;
     ProcessorOutputPtr _output;
 };
 
-// Sort helper function for sorting the textures to load the front texture data first
-struct DepthCompare
+namespace
 {
-    explicit DepthCompare( const Frustum& frustum )
-        : frustum_( frustum ) { }
-
-    bool operator()( dash::NodePtr node1,
-                     dash::NodePtr node2 )
-    {
-        DashRenderNode renderNode1( node1 );
-        DashRenderNode renderNode2( node2 );
-
-        const LODNode& lodNode1 = renderNode1.getLODNode();
-        const LODNode& lodNode2 = renderNode2.getLODNode();
-
-        const float depth1 = ( frustum_.getEyeCoords() -
-                               lodNode1.getWorldBox().getCenter( )).length();
-        const float depth2 = ( frustum_.getEyeCoords() -
-                               lodNode2.getWorldBox().getCenter( )).length();
-        return  depth1 < depth2;
-    }
-    const Frustum& frustum_;
-};
+/**
+ * @return the expected reduction of the screen space error by loading a node.
+ * Until it is loaded, its region is drawn from a coarser level, with twice as
+ * large voxels. The removed error is the on-screen size of its voxels, as in
+ * ImportanceCachePolicy, weighted by the share of the viewport it covers.
+ */
+float getErrorReduction( const LODNode& lodNode, const Frustum& frustum )
+{
+    // 0 without a view, all bricks then have the same priority
+    const float nodeSize = frustum.getProjectedHeight( lodNode.getWorldBox( ));
+    const float voxelSize = nodeSize / lodNode.getBlockSize().y();
+    return voxelSize * nodeSize * nodeSize;
+}
+}
 
 DataUploadProcessor::DataUploadProcessor( DashTreePtr dashTree,
                                           GLContextPtr shareContext,
@@ -141,10 +130,28 @@ DataUploadProcessor::DataUploadProcessor( DashTreePtr dashTree,
     , _textureDataCache( textureDataCache )
     , _currentFrameID( 0 )
     , _threadOp( TO_NONE )
+    , _prefetchPosition( 0 )
+    , _loaderThreadCount( 1 )
 {
     setDashContext( dashTree->createContext() );
 }
 
+DataUploadProcessor::~DataUploadProcessor()
+{
+}
+
+void DataUploadProcessor::setLoaderThreadCount( const size_t nThreads )
+{
+    _loaderThreadCount = nThreads;
+}
+
+void DataUploadProcessor::setPrefetchList( const CacheIds& cacheIds )
+{
+    lunchbox::ScopedWrite mutex( _prefetchLock );
+    _prefetchList = cacheIds;
+    _prefetchPosition = 0;
+}
+
 bool DataUploadProcessor::initializeThreadRun_()
 {
     setName( "DataUp" );
@@ -152,6 +159,18 @@ bool DataUploadProcessor::initializeThreadRun_()
     _shareContext->shareContext( getGLContext( ));
     VolumeDataSourcePtr dataSource = _textureDataCache.getDataSource();
     dataSource->initializeGL();
+
+    const size_t nThreads = _loaderThreadCount > 0 ?
+                            _loaderThreadCount :
+                            boost::thread::hardware_concurrency();
+    if( nThreads > 1 )
+    {
+        // this thread publishes the bricks and loads too, see _loadData()
+        _loaderPool.reset( new DataLoaderPool( _textureDataCache,
+                                               nThreads - 1 ));
+        LBINFO << "Loading the bricks with " << nThreads << " threads"
+               << std::endl;
+    }
     return DashProcessor::initializeThreadRun_();
 }
 
@@ -167,6 +186,7 @@ void DataUploadProcessor::runLoop_()
 
     _checkThreadOperation();
     _loadData();
+    _prefetch();
 
 #ifdef _ITT_DEBUG_
     __itt_task_end( ittDataLoadDomain );
@@ -178,34 +198,88 @@ void DataUploadProcessor::_loadData()
 {
     const DashRenderStatus& renderStatus = _dashTree->getRenderStatus();
 
-    const Frustum& frustum = renderStatus.getFrustum();
-    _currentFrameID = renderStatus.getFrameID();
+    const Frustum frustum = renderStatus.getFrustum();
+    const uint64_t frameID = renderStatus.getFrameID();
 
-    DashNodeVector dashNodeList;
-    DepthCollectorVisitor depthCollectorVisitor( _dashTree,
-                                                 _textureDataCache,
-                                                 processorOutputPtr_,
-                                                 dashNodeList );
+    // The requests of a previous view or frame are stale, the visible ones
+    // are queued again below with their new priority.
+    if( frameID != _currentFrameID || frustum != _currentFrustum )
+    {
+        _currentFrameID = frameID;
+        _currentFrustum = frustum;
+        _loadQueue.setEpoch( _loadQueue.getEpoch() + 1 );
+    }
+
+    RequestCollectorVisitor requestCollector( _dashTree, _textureDataCache,
+                                              processorOutputPtr_,
+                                              _currentFrustum, _loadQueue );
 
     const RootNode& rootNode = _dashTree->getDataSource()->getVolumeInformation().rootNode;
 
     DFSTraversal traverser;
-    traverser.traverse( rootNode, depthCollectorVisitor, _currentFrameID );
-
-    std::sort( dashNodeList.begin( ), dashNodeList.end( ),
-               DepthCompare( frustum ));
-    CollectionTraversal collectionTraverser;
-    DepthSortedDataLoaderVisitor dataLoader( _dashTree, _textureDataCache,
-                                             processorInputPtr_,
-                                             processorOutputPtr_ );
-    collectionTraverser.traverse( dashNodeList, dataLoader );
+    traverser.traverse( rootNode, requestCollector, _currentFrameID );
+
+    // The loader threads load the bricks in priority order, while this thread
+    // publishes them in the same order, loading the ones not started yet.
+    if( _loaderPool )
+        _loaderPool->setQueue( _loadQueue.getCacheIds( ));
+
+    // Loads until new input arrives, the remaining requests are kept for the
+    // next loop unless the view or frame changes.
+    PriorityDataLoaderVisitor dataLoader( _dashTree, _textureDataCache,
+                                          _loaderPool.get(),
+                                          processorInputPtr_,
+                                          processorOutputPtr_ );
+    VisitState state;
+    CacheId cacheId = INVALID_CACHE_ID;
+    while( !state.getBreakTraversal() && _loadQueue.pop( cacheId ))
+    {
+        const dash::NodePtr dashNode =
+            _dashTree->getDashNode( NodeId( cacheId ));
+        if( !dashNode )
+            continue;
+
+        DashRenderNode renderNode( dashNode );
+        dataLoader.visit( renderNode, state );
+    }
     processorOutputPtr_->commit( CONNECTION_ID );
+}
 
-    DataLoaderVisitor loadVisitor( _dashTree, _textureDataCache,
-                                   processorInputPtr_, processorOutputPtr_ );
+void DataUploadProcessor::_prefetch()
+{
+    lunchbox::ScopedWrite mutex( _prefetchLock );
+    if( _prefetchPosition >= _prefetchList.size( ))
+        return;
 
-    traverser.traverse( rootNode, loadVisitor, _currentFrameID );
-    processorOutputPtr_->commit( CONNECTION_ID );
+    const CacheStatistics& statistics = _textureDataCache.getStatistics();
+    const size_t maxMemory = statistics.getMaximumMemory() *
+                             PREFETCH_MEMORY_RATIO;
+    lunchbox::Clock clock;
+    while( _prefetchPosition < _prefetchList.size() &&
+           clock.getTimef() < PREFETCH_TIME &&
+           !processorInputPtr_->dataWaitingOnInput( CONNECTION_ID ))
+    {
+        // never unload the bricks of the current frames for prefetching
+        if( statistics.getUsedMemory() >= maxMemory )
+        {
+            _prefetchPosition = _prefetchList.size();
+            break;
+        }
+
+        const CacheId cacheId = _prefetchList[ _prefetchPosition++ ];
+        const CacheObjectPtr textureData =
+            _textureDataCache.getObjectFromCache( cacheId );
+        if( !textureData->isLoaded( ))
+            textureData->cacheLoad();
+    }
+
+    if( _prefetchPosition < _prefetchList.size( ))
+        return;
+
+    LBINFO << "Prefetched the cache snapshot, " << statistics.getUsedMemory() /
+              LB_1MB << " MB in the data cache" << std::endl;
+    _prefetchList.clear();
+    _prefetchPosition = 0;
 }
 
 void DataUploadProcessor::_checkThreadOperation()
@@ -223,53 +297,8 @@ void DataUploadProcessor::_checkThreadOperation()
         exit();
 }
 
-void DataLoaderVisitor::visit( DashRenderNode& renderNode, VisitState& state )
-{
-    const LODNode& node = renderNode.getLODNode();
-
-    if( !node.isValid() )
-        return;
-
-    state.setBreakTraversal( _input->dataWaitingOnInput( CONNECTION_ID ));
-
-    if( !renderNode.isInFrustum( ))
-    {
-        state.setVisitChild( false );
-        return;
-    }
-
-    if( !renderNode.isLODVisible( ))
-        return;
-
-    state.setVisitChild( false );
-
-    const ConstCacheObjectPtr texture = renderNode.getTextureObject();
-    if( texture->isLoaded( ))
-        return;
-
-    const TextureDataObject& tData = _cache.getNodeTextureData(
-                                         node.getNodeId().getId( ));
-    if( tData.isLoaded( ))
-        return;
-
-#ifdef _ITT_DEBUG_
-    __itt_task_begin( ittDataLoadDomain, __itt_null, __itt_null,
-                      ittDataLoadTask );
-#endif //_ITT_DEBUG_
-    TextureDataObject& textureData =
-        _cache.getNodeTextureData( node.getNodeId().getId( ));
-    textureData.cacheLoad( );
-    if( _clock.getTime64() > 1000 ) // commit once every second
-    {
-        _clock.reset();
-        _output->commit( CONNECTION_ID );
-    }
-#ifdef _ITT_DEBUG_
-    __itt_task_end( ittDataLoadDomain );
-#endif //_ITT_DEBUG_
-}
-
-void DepthCollectorVisitor::visit( DashRenderNode& renderNode, VisitState& state )
+void RequestCollectorVisitor::visit( DashRenderNode& renderNode,
+                                     VisitState& state )
 {
     const LODNode& lodNode = renderNode.getLODNode();
 
@@ -296,20 +325,21 @@ void DepthCollectorVisitor::visit( DashRenderNode& renderNode, VisitState& state
         return;
 
     // Triggers creation of the cache object.
-    TextureDataObject& textureData =
-            _cache.getNodeTextureData( lodNode.getNodeId().getId( ));
-    if( textureData.isLoaded() )
+    const CacheObjectPtr textureData =
+            _cache.getObjectFromCache( lodNode.getNodeId().getId( ));
+    if( textureData->isLoaded() )
     {
-        renderNode.setTextureDataObject( &textureData );
-        _output->commit( CONNECTION_ID );
+        renderNode.setTextureDataObject( textureData );
+        _output->commitBatched( CONNECTION_ID );
         return;
     }
 
-    _collection.push_back( renderNode.getDashNode());
+    _loadQueue.push( lodNode.getNodeId().getId(),
+                     getErrorReduction( lodNode, _frustum ));
 }
 
-void DepthSortedDataLoaderVisitor::visit( DashRenderNode& renderNode,
-                                          VisitState& state )
+void PriorityDataLoaderVisitor::visit( DashRenderNode& renderNode,
+                                       VisitState& state )
 {
     const LODNode& lodNode = renderNode.getLODNode();
 
@@ -317,28 +347,39 @@ void DepthSortedDataLoaderVisitor::visit( DashRenderNode& renderNode,
     __itt_task_begin( ittDataLoadDomain, __itt_null, __itt_null,
                       ittDataLoadTask );
 #endif //_ITT_DEBUG_
-    TextureDataObject& textureData =
-            static_cast< const TextureDataCache& >
-            ( _cache ).getNodeTextureData( lodNode.getNodeId().getId( ));
-    textureData.cacheLoad();
+    const CacheId cacheId = lodNode.getNodeId().getId();
+    const CacheObjectPtr object = _cache.getObjectFromCache( cacheId );
+
+    // Loading blocks, publish the batched bricks before
+    if( !object->isLoaded( ))
+        _output->commitPending( CONNECTION_ID );
+
+    ConstCacheObjectPtr textureData;
+    if( _loaderPool )
+        textureData = _loaderPool->load( cacheId );
+    else
+    {
+        object->cacheLoad();
+        textureData = object;
+    }
 
 #ifdef _ITT_DEBUG_
     __itt_task_end( ittDataLoadDomain );
 #endif //_ITT_DEBUG_
 
-    renderNode.setTextureDataObject( &textureData );
+    renderNode.setTextureDataObject( textureData );
 
 #ifdef _DEBUG_
     const ConstCacheObjectPtr tData = renderNode.getTextureDataObject();
     if( !tData->isLoaded() )
     {
         LBERROR << "Texture data loaded but no in the render node : "
-                << textureData.getLODNode()->getNodeId().getId();
+                << cacheId
                 << std::endl;
     }
 #endif //_DEBUG_
 
-    _output->commit( CONNECTION_ID );
+    _output->commitBatched( CONNECTION_ID );
     state.setBreakTraversal( _input->dataWaitingOnInput( CONNECTION_ID ));
 
 }
@@ -22,9 +22,11 @@
 #define _DataLoadProcessor_h_
 
 #include <lunchbox/clock.h>
+#include <lunchbox/lock.h>
 
 #include <livre/lib/api.h>
 #include <livre/lib/visitor/DFSTraversal.h>
+#include <livre/lib/uploaders/LoadRequestQueue.h>
 #include <livre/lib/types.h>
 
 #include <livre/core/dashpipeline/DashProcessor.h>
@@ -54,17 +56,45 @@ public:
                                    GLContextPtr context,
                                    TextureDataCache& textureDataCache );
 
+    LIVRE_API ~DataUploadProcessor();
+
+    /**
+     * Sets the number of threads loading the bricks of a frame, including the
+     * processor thread, which publishes the loaded bricks in priority order.
+     * Takes effect when the processor thread starts. The data source has to
+     * support concurrent getData() calls from threads without a GL context.
+     * @param nThreads The number of threads, 0 for one per core.
+     */
+    LIVRE_API void setLoaderThreadCount( size_t nThreads );
+
+    /**
+     * Sets the bricks to prefetch into the texture data cache, e.g. from a
+     * cache snapshot. They are loaded in order once the bricks of the current
+     * frame are loaded, only into free cache memory, and the prefetching yields
+     * whenever new frame data arrives.
+     * @param cacheIds The cache ids of the bricks, the most important first.
+     */
+    LIVRE_API void setPrefetchList( const CacheIds& cacheIds );
+
 private:
     bool initializeThreadRun_( ) final;
     void runLoop_( ) final;
     void _loadData();
+    void _prefetch();
 
     DashTreePtr _dashTree;
     GLContextPtr _shareContext;
     TextureDataCache& _textureDataCache;
     uint64_t _currentFrameID;
+    Frustum _currentFrustum;
+    LoadRequestQueue _loadQueue;
     void _checkThreadOperation( );
     ThreadOperation _threadOp;
+    lunchbox::Lock _prefetchLock;
+    CacheIds _prefetchList;
+    size_t _prefetchPosition;
+    size_t _loaderThreadCount;
+    DataLoaderPoolPtr _loaderPool;
 };
 
 }
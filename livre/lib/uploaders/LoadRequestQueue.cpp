@@ -0,0 +1,145 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <livre/lib/uploaders/LoadRequestQueue.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace livre
+{
+
+namespace
+{
+const size_t MIN_COMPACT_SIZE = 1024; //!< Heap size to drop stale requests at
+}
+
+LoadRequestQueue::LoadRequestQueue()
+    : _epoch( 0 )
+{
+}
+
+void LoadRequestQueue::setEpoch( const uint64_t epoch )
+{
+    if( epoch == _epoch )
+        return;
+
+    _epoch = epoch;
+    clear();
+}
+
+uint64_t LoadRequestQueue::getEpoch() const
+{
+    return _epoch;
+}
+
+void LoadRequestQueue::push( const CacheId cacheId, const float priority )
+{
+    // NaN breaks the ordering of the heap
+    if( !std::isfinite( priority ))
+        return;
+
+    std::pair< PriorityMap::iterator, bool > result =
+        _priorities.insert( PriorityMap::value_type( cacheId, priority ));
+    if( !result.second )
+    {
+        if( result.first->second == priority )
+            return;
+        // the previous request stays in the heap, pop() skips it
+        result.first->second = priority;
+    }
+
+    const Request request = { priority, cacheId };
+    _heap.push_back( request );
+    std::push_heap( _heap.begin(), _heap.end( ));
+
+    if( _heap.size() > MIN_COMPACT_SIZE &&
+        _heap.size() > 2 * _priorities.size( ))
+    {
+        _compact();
+    }
+}
+
+bool LoadRequestQueue::pop( CacheId& cacheId )
+{
+    while( !_heap.empty( ))
+    {
+        const Request request = _heap.front();
+        std::pop_heap( _heap.begin(), _heap.end( ));
+        _heap.pop_back();
+
+        PriorityMap::iterator i = _priorities.find( request.cacheId );
+        if( i == _priorities.end() || i->second != request.priority )
+            continue;
+
+        _priorities.erase( i );
+        cacheId = request.cacheId;
+        return true;
+    }
+    return false;
+}
+
+CacheIds LoadRequestQueue::getCacheIds() const
+{
+    std::vector< Request > requests;
+    requests.reserve( _priorities.size( ));
+    for( PriorityMap::const_iterator i = _priorities.begin();
+         i != _priorities.end(); ++i )
+    {
+        const Request request = { i->second, i->first };
+        requests.push_back( request );
+    }
+    std::sort( requests.rbegin(), requests.rend( ));
+
+    CacheIds cacheIds;
+    cacheIds.reserve( requests.size( ));
+    for( size_t i = 0; i < requests.size(); ++i )
+        cacheIds.push_back( requests[ i ].cacheId );
+    return cacheIds;
+}
+
+size_t LoadRequestQueue::getSize() const
+{
+    return _priorities.size();
+}
+
+bool LoadRequestQueue::isEmpty() const
+{
+    return _priorities.empty();
+}
+
+void LoadRequestQueue::clear()
+{
+    _heap.clear();
+    _priorities.clear();
+}
+
+void LoadRequestQueue::_compact()
+{
+    _heap.clear();
+    for( PriorityMap::const_iterator i = _priorities.begin();
+         i != _priorities.end(); ++i )
+    {
+        const Request request = { i->second, i->first };
+        _heap.push_back( request );
+    }
+    std::make_heap( _heap.begin(), _heap.end( ));
+}
+
+}
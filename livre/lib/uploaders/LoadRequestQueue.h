@@ -0,0 +1,102 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _LoadRequestQueue_h_
+#define _LoadRequestQueue_h_
+
+#include <livre/lib/api.h>
+#include <livre/lib/types.h>
+
+#include <boost/unordered_map.hpp>
+
+namespace livre
+{
+
+/**
+ * The LoadRequestQueue class orders the bricks to load by priority, e.g. by
+ * the screen space error their loading removes.
+ *
+ * Every request belongs to the epoch it was queued in. Starting a new epoch,
+ * e.g. on a camera or frame change, drops the requests of the previous one, so
+ * stale loads never delay the ones of the current view. Queueing a brick again
+ * updates its priority. The queue is not thread safe.
+ */
+class LoadRequestQueue
+{
+public:
+    LIVRE_API LoadRequestQueue();
+
+    /**
+     * Starts a new epoch if it differs from the current one, dropping all
+     * queued requests.
+     * @param epoch The epoch of the new requests.
+     */
+    LIVRE_API void setEpoch( uint64_t epoch );
+
+    /** @return the epoch of the queued requests. */
+    LIVRE_API uint64_t getEpoch() const;
+
+    /**
+     * Queues a brick in the current epoch, or updates its priority. Requests
+     * with an infinite or NaN priority are ignored.
+     * @param cacheId The cache id of the brick.
+     * @param priority The priority of the brick, the largest is loaded first.
+     */
+    LIVRE_API void push( CacheId cacheId, float priority );
+
+    /**
+     * Takes the request with the largest priority out of the queue.
+     * @param cacheId Returns the cache id of the brick.
+     * @return false if the queue is empty.
+     */
+    LIVRE_API bool pop( CacheId& cacheId );
+
+    /** @return the cache ids of the queued bricks, in priority order. */
+    LIVRE_API CacheIds getCacheIds() const;
+
+    /** @return the number of queued bricks. */
+    LIVRE_API size_t getSize() const;
+
+    /** @return true if no brick is queued. */
+    LIVRE_API bool isEmpty() const;
+
+    /** Drops all requests, keeping the epoch. */
+    LIVRE_API void clear();
+
+private:
+    struct Request
+    {
+        float priority;
+        CacheId cacheId;
+
+        bool operator<( const Request& rhs ) const
+            { return priority < rhs.priority; }
+    };
+    typedef boost::unordered_map< CacheId, float > PriorityMap;
+
+    void _compact();
+
+    std::vector< Request > _heap; //!< May hold stale requests
+    PriorityMap _priorities; //!< The queued bricks and their priority
+    uint64_t _epoch;
+};
+
+}
+
+#endif // _LoadRequestQueue_h_
@@ -130,10 +130,18 @@ const TextureCache& TextureUploadProcessor::getTextureCache() const
     return _textureCache;
 }
 
+TextureCache& TextureUploadProcessor::getTextureCache()
+{
+    return _textureCache;
+}
+
 bool TextureUploadProcessor::initializeThreadRun_()
 {
     setName( "TexUp" );
     _textureCache.setMaximumMemory( _vrParameters->maxGPUCacheMemoryMB * LB_1MB );
+    _textureCache.setPolicy(
+        LRUCache::getPolicyType( _vrParameters->gpuCachePolicy ));
+    _reserveCoarseLevels();
     LBASSERT( getGLContext( ));
     _shareContext->shareContext( getGLContext( ));
     return DashProcessor::initializeThreadRun_();
@@ -154,6 +162,29 @@ void TextureUploadProcessor::onPostCommit_( const uint32_t,
         glFinish();
 }
 
+void TextureUploadProcessor::_reserveCoarseLevels()
+{
+    // Reserve the memory of all textures of a level, coarsest level first, as
+    // long as the reserved memory lasts
+    const VolumeInformation& volInfo =
+            _dashTree->getDataSource()->getVolumeInformation();
+    const size_t textureSize = _textureCache.getTextureSize(
+                                   Vector3i( volInfo.maximumBlockSize ));
+
+    size_t reservedMemory = _vrParameters->gpuCacheReservedMB * LB_1MB;
+    for( uint32_t level = 0; level < volInfo.rootNode.getDepth(); ++level )
+    {
+        const Vector3ui blocks = volInfo.rootNode.getBlockSize( level );
+        const size_t levelMemory = size_t( blocks.x( )) * blocks.y() *
+                                   blocks.z() * textureSize;
+        if( levelMemory > reservedMemory )
+            break;
+
+        _textureCache.setLevelReservation( level, levelMemory );
+        reservedMemory -= levelMemory;
+    }
+}
+
 void TextureUploadProcessor::_loadData()
 {
     TextureLoaderVisitor loadVisitor( _dashTree, _textureCache,
@@ -196,6 +227,7 @@ void TextureUploadProcessor::runLoop_()
                 _dashTree->getDataSource()->getVolumeInformation().rootNode;
         traverser.traverse( rootNode, collectVisibles, renderStatus.getFrameID( ));
         _textureCache.setProtectList( _protectUnloading );
+        _textureCache.setFrustum( renderStatus.getFrustum( ));
         _currentFrameID = renderStatus.getFrameID();
     }
     _loadData();
@@ -246,7 +278,7 @@ void TextureLoaderVisitor::visit( DashRenderNode& renderNode, VisitState& state
     if( texture.isLoaded() )
     {
         renderNode.setTextureObject( &texture );
-        _output->commit( CONNECTION_ID );
+        _output->commitBatched( CONNECTION_ID );
         return;
     }
     else
@@ -269,7 +301,7 @@ void TextureLoaderVisitor::visit( DashRenderNode& renderNode, VisitState& state
             renderNode.setTextureObject( &lodTexture );
 
             renderNode.setTextureDataObject( TextureDataObject::getEmptyPtr() );
-            _output->commit( CONNECTION_ID );
+            _output->commitBatched( CONNECTION_ID );
             _needRedraw = true;
         }
         else
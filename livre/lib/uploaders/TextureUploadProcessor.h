@@ -53,6 +53,9 @@ public:
     /** @return the texture cache */
     LIVRE_API const TextureCache& getTextureCache() const;
 
+    /** @return the texture cache */
+    LIVRE_API TextureCache& getTextureCache();
+
 protected:
     LIVRE_API bool onPreCommit_( uint32_t connection ) override;
     LIVRE_API void onPostCommit_( uint32_t connection, CommitState state ) override;
@@ -62,6 +65,7 @@ private:
     LIVRE_API bool initializeThreadRun_( ) final;
     LIVRE_API void runLoop_( ) final;
 
+    void _reserveCoarseLevels();
     void _loadData();
     void _checkThreadOperation( );
 
@@ -55,7 +55,8 @@ lunchbox::URI deserializeDataSource( const ::zeq::Event& event )
     return lunchbox::URI( data->uri()->c_str( ));
 }
 
-::zeq::Event serializeDataSourceData( const RemoteInformation& info )
+::zeq::Event serializeDataSourceData( const RemoteInformation& info,
+                                      const uint32_t compressions )
 {
     ::zeq::Event event( EVENT_DATASOURCE_DATA );
     flatbuffers::FlatBufferBuilder& fbb = event.getFBB();
@@ -87,6 +88,7 @@ lunchbox::URI deserializeDataSource( const ::zeq::Event& event )
     builder.add_boundingBoxMin( bboxMin );
     builder.add_boundingBoxMax( bboxMax );
     builder.add_worldSpacePerVoxel( vi.worldSpacePerVoxel );
+    builder.add_compressions( compressions );
 
     fbb.Finish( builder.Finish( ));
     return event;
@@ -136,8 +138,16 @@ RemoteInformation deserializeDataSourceData( const ::zeq::Event& event )
     return info;
 }
 
+uint32_t deserializeDataSourceCompressions( const ::zeq::Event& event )
+{
+    if( event.getType() != EVENT_DATASOURCE_DATA )
+        return 0;
+    return GetVolumeInformation( event.getData( ))->compressions();
+}
+
 ::zeq::Event serializeDataSample( const uint128_t& id,
-                                  const livre::LODNode& node )
+                                  const livre::LODNode& node,
+                                  const BrickCompression compression )
 {
     ::zeq::Event event( id );
     flatbuffers::FlatBufferBuilder& fbb = event.getFBB();
@@ -152,6 +162,7 @@ RemoteInformation deserializeDataSourceData( const ::zeq::Event& event )
     builder.add_blockSize( blockSize );
     builder.add_worldBoxMin( worldBoxMin );
     builder.add_worldBoxMax( worldBoxMax );
+    builder.add_compression( compression );
 
     fbb.Finish( builder.Finish( ));
     return event;
@@ -172,22 +183,40 @@ LODNodeSample deserializeDataSample( const ::zeq::Event& event )
     return sample;
 }
 
+BrickCompression deserializeDataSampleCompression( const ::zeq::Event& event )
+{
+    return BrickCompression( GetLODNode( event.getData( ))->compression( ));
+}
+
 ::zeq::Event serializeDataSampleData( const uint128_t& id,
-                                      const MemoryUnitPtr memory )
+                                      const NodeId& nodeId,
+                                      const MemoryUnitPtr memory,
+                                      const BrickCompression compression )
 {
     ::zeq::Event event( id );
     flatbuffers::FlatBufferBuilder& fbb = event.getFBB();
     const size_t size = memory->getMemSize();
-    auto data = fbb.CreateUninitializedVector< uint8_t >( size );
+    const uint8_t* source = memory->getData< uint8_t >();
+
+    // sparse bricks compress well; send them raw if compression does not help
+    std::vector< uint8_t > compressed;
+    const bool isCompressed = compressBrick( compression, source, size,
+                                             compressed );
+    const size_t payloadSize = isCompressed ? compressed.size() : size;
+    auto data = fbb.CreateUninitializedVector< uint8_t >( payloadSize );
 
     // https://groups.google.com/d/msg/flatbuffers/GWsYUlTYsQs/CCzihVQqpYcJ
     uint8_t* ptr = const_cast< uint8_t* >(
         reinterpret_cast< flatbuffers::Vector< const uint8_t >* >(
             fbb.GetBufferPointer( ))->Data( ));
-    ::memcpy( ptr, memory->getData< uint8_t >(), size );
+    ::memcpy( ptr, isCompressed ? &compressed[0] : source, payloadSize );
 
     MemoryBuilder builder( fbb );
     builder.add_data( data );
+    builder.add_nodeId( nodeId.getId( ));
+    builder.add_compression( isCompressed ? compression :
+                                            BRICK_COMPRESSION_NONE );
+    builder.add_size( size );
 
     fbb.Finish( builder.Finish( ));
     return event;
@@ -199,5 +228,29 @@ LODNodeSampleData deserializeDataSampleData( const ::zeq::Event& event )
     return std::make_pair( data->Data(), data->size( ));
 }
 
+NodeId deserializeDataSampleNodeId( const ::zeq::Event& event )
+{
+    return NodeId( GetMemory( event.getData( ))->nodeId( ));
+}
+
+bool deserializeDataSampleData( const ::zeq::Event& event,
+                                AllocMemoryUnit& memory )
+{
+    auto response = GetMemory( event.getData( ));
+    auto data = response->data();
+    const BrickCompression compression =
+        BrickCompression( response->compression( ));
+
+    if( compression == BRICK_COMPRESSION_NONE )
+    {
+        memory.allocAndSetData( data->Data(), data->size( ));
+        return true;
+    }
+
+    memory.alloc( response->size( ));
+    return decompressBrick( compression, data->Data(), data->size(),
+                            memory.getData< uint8_t >(), response->size( ));
+}
+
 }
 }
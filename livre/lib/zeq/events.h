@@ -21,6 +21,7 @@
 #define _livreEvents_h_
 
 #include <livre/lib/api.h>
+#include <livre/lib/data/BrickCompression.h>
 #include <livre/core/types.h>
 #include <lunchbox/uint128_t.h>
 #include <zeq/types.h>
@@ -53,36 +54,79 @@ LIVRE_API lunchbox::URI deserializeDataSource( const ::zeq::Event& event );
 typedef std::pair< lunchbox::uint128_t,
                    livre::VolumeInformation > RemoteInformation;
 
-/** Serialize information of a data source. */
-LIVRE_API ::zeq::Event serializeDataSourceData( const RemoteInformation& );
+/**
+ * Serialize information of a data source.
+ *
+ * @param compressions the bit mask of BrickCompression the service can use
+ *        for the data of this data source, see getSupportedBrickCompressions().
+ */
+LIVRE_API ::zeq::Event serializeDataSourceData( const RemoteInformation&,
+                                                uint32_t compressions =
+                                                  1u << BRICK_COMPRESSION_NONE );
 
 /** Deserialize information of a data source. */
 LIVRE_API RemoteInformation deserializeDataSourceData( const ::zeq::Event& );
 
+/** Deserialize the bit mask of BrickCompression offered by a data source. */
+LIVRE_API uint32_t deserializeDataSourceCompressions( const ::zeq::Event& );
+
 
 /**
  * Deserialized data sample event. See RemoteInformation for uint128_t semantic.
  */
 typedef std::pair< lunchbox::uint128_t, LODNode > LODNodeSample;
 
-/** Serialize the request for the data of one node. */
+/**
+ * Serialize the request for the data of one node.
+ *
+ * @param compression the compression requested for the response, which must be
+ *        one of the compressions offered by the data source.
+ */
 LIVRE_API ::zeq::Event serializeDataSample( const uint128_t& id,
-                                            const livre::LODNode& node );
+                                            const livre::LODNode& node,
+                                            BrickCompression compression =
+                                                BRICK_COMPRESSION_NONE );
 
 /** Deserialize the request for the data of one node. */
 LIVRE_API LODNodeSample deserializeDataSample( const ::zeq::Event& event );
 
+/** Deserialize the compression requested for the data of one node. */
+LIVRE_API BrickCompression deserializeDataSampleCompression(
+    const ::zeq::Event& event );
 
-/** Serialize the response for the data of one node. */
+
+/**
+ * Serialize the response for the data of one node.
+ *
+ * The response carries the identifier of the node, so that several requests
+ * can be in flight and answered in any order.
+ */
 LIVRE_API ::zeq::Event serializeDataSampleData( const uint128_t& id,
-                                                const MemoryUnitPtr data );
+                                                const NodeId& nodeId,
+                                                const MemoryUnitPtr data,
+                                                BrickCompression compression =
+                                                    BRICK_COMPRESSION_NONE );
 
-/** Deserialized data for one node. Valid until given event is disposed. */
+/**
+ * Deserialized payload for one node, possibly compressed. Valid until given
+ * event is disposed.
+ */
 typedef std::pair< const uint8_t*, size_t > LODNodeSampleData;
 
-/** Deserialize the request for the data of one node. */
+/** Deserialize the payload of the response for the data of one node. */
 LIVRE_API LODNodeSampleData deserializeDataSampleData( const ::zeq::Event& event );
 
+/**
+ * Deserialize the response for the data of one node, decompressing it directly
+ * into the given memory unit.
+ * @return false if the data could not be decompressed.
+ */
+LIVRE_API bool deserializeDataSampleData( const ::zeq::Event& event,
+                                          AllocMemoryUnit& memory );
+
+/** Deserialize the node identifier of the response for one node. */
+LIVRE_API NodeId deserializeDataSampleNodeId( const ::zeq::Event& event );
+
 }
 }
 
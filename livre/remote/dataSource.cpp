@@ -32,6 +32,10 @@
 #include <zeq/connection/service.h>
 
 #include <boost/bind.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <lunchbox/atomic.h>
+#include <lunchbox/clock.h>
 #include <lunchbox/pluginRegisterer.h>
 
 namespace livre
@@ -43,6 +47,8 @@ using boost::lexical_cast;
 namespace detail
 {
 static const uint32_t timeout = 60000; /*ms*/
+static const uint32_t receiveTimeout = 100; /*ms*/
+static const size_t defaultWindow = 16; //!< Outstanding requests
 namespace
 {
 lunchbox::URI _getSinkURI( const VolumeDataSourcePluginData& initData )
@@ -72,6 +78,10 @@ public:
                 VolumeInformation& info )
         : _publisher( _getSinkURI( initData ))
         , _subscriber( _getSourceURI( initData ))
+        , _compressions( 0 )
+        , _compression( BRICK_COMPRESSION_NONE )
+        , _window( _getWindowSize( initData ))
+        , _running( 1 )
     {
         const std::string& host = initData.getURI().getHost();
         if( !host.empty( ))
@@ -102,41 +112,166 @@ public:
             _subscriber.deregisterHandler( livre::zeq::EVENT_DATASOURCE_DATA ));
         if( tries == 0 )
             LBTHROW( std::runtime_error( "Cannot connect to publisher") );
+        _compression = _selectCompression( initData );
+
+        // Responses are tagged with their node id, so one handler serves all
+        // outstanding requests. ZeroEQ is not thread safe: from here on only
+        // the receiver thread touches the subscriber.
+        LBCHECK( _subscriber.registerHandler( _event + 1,
+                       boost::bind( &livre::remote::detail::DataSource::_onData,
+                                    this, _1 )));
+        _receiver = boost::thread(
+                boost::bind( &livre::remote::detail::DataSource::_receive,
+                             this ));
     }
 
+    ~DataSource()
+    {
+        _running = 0;
+        _receiver.join();
+        _expire( 0.f );
+    }
 
     MemoryUnitPtr sample( const LODNode& node )
     {
-        lunchbox::Clock clock;
-
-        // ZeroEQ/MQ is not thread safe. Livre calls this concurrently from all
-        // render threads. When using a thread-save ZeroEQ, use node id in place
-        // of '+ 1' to have one handler per brick.
-        lunchbox::ScopedWrite mutex( _lock );
-        AllocMemoryUnit* memory = 0;
-
-        LBCHECK( _subscriber.registerHandler( _event + 1,
-                       boost::bind( &livre::remote::detail::DataSource::_onData,
-                                    this, _1, boost::ref( memory ))));
-        LBCHECK( _publisher.publish( zeq::serializeDataSample( _event, node )));
+        return _request( node ).get();
+    }
 
-        while( !memory )
+    MemoryUnitFutures sampleAsync( const LODNodes& nodes )
+    {
+        MemoryUnitFutures futures;
+        futures.reserve( nodes.size( ));
+        BOOST_FOREACH( const LODNode& node, nodes )
         {
-            const float left = timeout - clock.getTimef();
-            if( left <= 0.f )
-                break;
-            _subscriber.receive( left );
+            const SharedMemoryUnitFuture future = _request( node );
+            futures.push_back( std::async( std::launch::deferred,
+                                           [ future ]() { return future.get(); }));
         }
-
-        LBCHECK( _subscriber.deregisterHandler( _event + 1 ));
-        return AllocMemoryUnitPtr( memory );
+        return futures;
     }
 
 private:
+    typedef std::shared_future< MemoryUnitPtr > SharedMemoryUnitFuture;
+
+    /** One outstanding request, shared by all callers asking for the node */
+    struct Request
+    {
+        std::promise< MemoryUnitPtr > promise;
+        SharedMemoryUnitFuture future;
+        lunchbox::Clock clock;
+    };
+    typedef std::shared_ptr< Request > RequestPtr;
+    typedef boost::unordered_map< Identifier, RequestPtr > RequestMap;
+
     ::zeq::Publisher _publisher;
     ::zeq::Subscriber _subscriber;
     lunchbox::uint128_t _event;
-    lunchbox::Lock _lock;
+    uint32_t _compressions; //!< offered by the service
+    BrickCompression _compression; //!< requested for all bricks
+
+    const size_t _window;
+    lunchbox::Lock _publishLock;
+    boost::mutex _requestLock;
+    boost::condition_variable _requestCondition;
+    RequestMap _requests;
+
+    boost::thread _receiver;
+    lunchbox::a_int32_t _running;
+
+    static size_t _getWindowSize( const VolumeDataSourcePluginData& initData )
+    {
+        const lunchbox::URI& uri = initData.getURI();
+        lunchbox::URI::ConstKVIter i = uri.findQuery( "window" );
+        if( i == uri.queryEnd( ))
+            return defaultWindow;
+        return std::max( lexical_cast< size_t >( i->second ), size_t( 1 ));
+    }
+
+    /**
+     * Select the wire compression from the 'compression' URI query, or LZ4 if
+     * both sides support it.
+     */
+    BrickCompression _selectCompression(
+        const VolumeDataSourcePluginData& initData ) const
+    {
+        BrickCompression compression = BRICK_COMPRESSION_LZ4;
+        const lunchbox::URI& uri = initData.getURI();
+        lunchbox::URI::ConstKVIter i = uri.findQuery( "compression" );
+        if( i != uri.queryEnd( ))
+        {
+            if( i->second == "zstd" )
+                compression = BRICK_COMPRESSION_ZSTD;
+            else if( i->second != "lz4" )
+                return BRICK_COMPRESSION_NONE;
+        }
+
+        if( !isBrickCompressionSupported( compression ) ||
+            !( _compressions & ( 1u << compression )))
+        {
+            return BRICK_COMPRESSION_NONE;
+        }
+        return compression;
+    }
+
+    SharedMemoryUnitFuture _request( const LODNode& node )
+    {
+        const Identifier id = node.getNodeId().getId();
+        boost::unique_lock< boost::mutex > lock( _requestLock );
+
+        RequestMap::const_iterator i = _requests.find( id );
+        while( i == _requests.end() && _requests.size() >= _window )
+        {
+            _requestCondition.wait( lock );
+            i = _requests.find( id );
+        }
+        if( i != _requests.end( ))
+            return i->second->future;
+
+        RequestPtr request = std::make_shared< Request >();
+        request->future = request->promise.get_future().share();
+        _requests[ id ] = request;
+        lock.unlock();
+
+        lunchbox::ScopedWrite mutex( _publishLock );
+        LBCHECK( _publisher.publish( zeq::serializeDataSample( _event, node,
+                                                               _compression )));
+        return request->future;
+    }
+
+    void _receive()
+    {
+        while( _running )
+        {
+            _subscriber.receive( receiveTimeout );
+            _expire( timeout );
+        }
+    }
+
+    /** Answer all requests older than the given time with no data. */
+    void _expire( const float maxAge )
+    {
+        std::vector< RequestPtr > expired;
+        {
+            boost::unique_lock< boost::mutex > lock( _requestLock );
+            for( RequestMap::iterator i = _requests.begin();
+                 i != _requests.end(); )
+            {
+                if( i->second->clock.getTimef() < maxAge )
+                {
+                    ++i;
+                    continue;
+                }
+                expired.push_back( i->second );
+                i = _requests.erase( i );
+            }
+        }
+        if( expired.empty( ))
+            return;
+
+        _requestCondition.notify_all();
+        BOOST_FOREACH( const RequestPtr& request, expired )
+            request->promise.set_value( MemoryUnitPtr( ));
+    }
 
     void _onInfo( const ::zeq::Event& event, VolumeInformation& info )
     {
@@ -145,15 +280,32 @@ private:
 
         _event = data.first;
         info = data.second;
+        _compressions = livre::zeq::deserializeDataSourceCompressions( event );
     }
 
-    void _onData( const ::zeq::Event& event, AllocMemoryUnit*& ptr )
+    void _onData( const ::zeq::Event& event )
     {
-        AllocMemoryUnit* memory = new AllocMemoryUnit;
-        const livre::zeq::LODNodeSampleData& data =
-            livre::zeq::deserializeDataSampleData( event );
-        memory->allocAndSetData( data.first, data.second );
-        ptr = memory;
+        const Identifier id =
+            livre::zeq::deserializeDataSampleNodeId( event ).getId();
+        RequestPtr request;
+        {
+            boost::unique_lock< boost::mutex > lock( _requestLock );
+            RequestMap::iterator i = _requests.find( id );
+            if( i == _requests.end( )) // not requested by us, or expired
+                return;
+            request = i->second;
+            _requests.erase( i );
+        }
+        _requestCondition.notify_all();
+
+        AllocMemoryUnitPtr memory( new AllocMemoryUnit );
+        if( !livre::zeq::deserializeDataSampleData( event, *memory ))
+        {
+            LBERROR << "Cannot decompress data for node "
+                    << NodeId( id ) << std::endl;
+            memory.reset();
+        }
+        request->promise.set_value( memory );
     }
 };
 }
@@ -185,6 +337,11 @@ MemoryUnitPtr DataSource::getData( const LODNode& node )
     return _impl->sample( node );
 }
 
+MemoryUnitFutures DataSource::getDataAsync( const LODNodes& nodes )
+{
+    return _impl->sampleAsync( nodes );
+}
+
 bool DataSource::handles( const VolumeDataSourcePluginData& initData )
 {
     const std::string remote = "remote";
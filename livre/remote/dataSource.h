@@ -39,6 +39,13 @@ namespace detail{ class DataSource; }
  * place of zeroconf auto-discovery. If specified, uses a 'bind=address'
  * key-value pair in the URI query part to bind the local publisher to a fixed
  * address instead of INADDR_ANY.
+ *
+ * Up to 'window=N' requests (default 16) are kept in flight to the service.
+ * Responses are matched to their request by node id and may arrive in any
+ * order. Concurrent requests for the same node share one round trip.
+ *
+ * Bricks are transferred LZ4 compressed if the service supports it. Use
+ * 'compression=none|lz4|zstd' in the URI query to select the compression.
  */
 class DataSource : public VolumeDataSourcePlugin
 {
@@ -48,6 +55,9 @@ public:
     virtual ~DataSource();
 
     MemoryUnitPtr getData( const LODNode& node ) final;
+    MemoryUnitFutures getDataAsync( const LODNodes& nodes ) final;
+    bool isThreadSafe() const final { return true; }
+    bool hasAsyncReads() const final { return true; }
 
     static bool handles( const VolumeDataSourcePluginData& initData );
 
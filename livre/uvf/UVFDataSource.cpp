@@ -36,7 +36,14 @@
 
 #pragma GCC diagnostic pop
 
+#include <lunchbox/lock.h>
+#include <lunchbox/monitor.h>
+#include <lunchbox/mtQueue.h>
 #include <lunchbox/pluginRegisterer.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
 
 #define MAX_ACCEPTABLE_BLOCK_SIZE 512
 
@@ -46,6 +53,69 @@ namespace livre
 namespace
 {
    lunchbox::PluginRegisterer< UVFDataSource > registerer;
+
+/**
+ * Fixed set of threads running the brick reads of getDataAsync(), shared by
+ * all UVF data sources.
+ */
+class DecompressionPool
+{
+public:
+    typedef std::function< void() > Task;
+
+    explicit DecompressionPool( const size_t nThreads )
+        : _nThreads( std::max( nThreads, size_t( 1 )))
+    {
+        for( size_t i = 0; i < _nThreads; ++i )
+            _threads.create_thread( [this]() { _run(); } );
+    }
+
+    ~DecompressionPool()
+    {
+        for( size_t i = 0; i < _nThreads; ++i )
+            _tasks.push( Task( ));
+        _threads.join_all();
+    }
+
+    void post( const Task& task ) { _tasks.push( task ); }
+
+private:
+    void _run()
+    {
+        for( ;; )
+        {
+            const Task task = _tasks.pop();
+            if( !task )
+                return;
+            task();
+        }
+    }
+
+    const size_t _nThreads;
+    lunchbox::MTQueue< Task > _tasks;
+    boost::thread_group _threads;
+};
+
+typedef std::shared_ptr< DecompressionPool > DecompressionPoolPtr;
+
+/**
+ * @return the pool of the process, created with nThreads threads unless
+ *         another data source holds it already.
+ */
+DecompressionPoolPtr getDecompressionPool( const size_t nThreads )
+{
+    static lunchbox::Lock lock;
+    static std::weak_ptr< DecompressionPool > instance;
+
+    lunchbox::ScopedWrite mutex( lock );
+    DecompressionPoolPtr pool = instance.lock();
+    if( !pool )
+    {
+        pool = std::make_shared< DecompressionPool >( nThreads );
+        instance = pool;
+    }
+    return pool;
+}
 }
 
 namespace detail
@@ -137,6 +207,13 @@ public:
             _readTOCBlock( initData.getURI().getPath());
 
             _volumeInfo.frameRange = Vector2ui( 0, _uvfDataSetPtr->GetNumberOfTimesteps( ));
+
+            const servus::URI& uri = initData.getURI();
+            servus::URI::ConstKVIter i = uri.findQuery( "threads" );
+            const size_t nThreads = i == uri.queryEnd() ?
+                                boost::thread::hardware_concurrency() :
+                                boost::lexical_cast< size_t >( i->second );
+            _pool = getDecompressionPool( nThreads );
          }
         catch( ... )
         {
@@ -150,6 +227,9 @@ public:
 
     ~UVFDataSource()
     {
+        // the pool outlives this source, wait for the reads posted by it
+        _pending.waitEQ( 0 );
+        _pool.reset();
         if( _tuvokLargeMMapFilePtr )
             _tuvokLargeMMapFilePtr->close();
     }
@@ -246,6 +326,33 @@ public:
         return memUnitPtr;
     }
 
+    MemoryUnitFutures getDataAsync( const LODNodes& nodes )
+    {
+        MemoryUnitFutures futures;
+        futures.reserve( nodes.size( ));
+        BOOST_FOREACH( const LODNode& node, nodes )
+        {
+            typedef std::promise< MemoryUnitPtr > Promise;
+            const std::shared_ptr< Promise > promise =
+                std::make_shared< Promise >( );
+            futures.push_back( promise->get_future( ));
+            ++_pending;
+            _pool->post( [this, node, promise]()
+            {
+                try
+                {
+                    promise->set_value( getData( node ));
+                }
+                catch( ... )
+                {
+                    promise->set_exception( std::current_exception( ));
+                }
+                --_pending;
+            });
+        }
+        return futures;
+    }
+
     template< class T >
     MemoryUnitPtr _tuvokBrickToMemoryUnit( const LODNode& node,
                                            const uint32_t brickIndex ) const
@@ -274,12 +381,14 @@ public:
         else if( blockInfo.m_eCompression == CT_ZLIB )
         {
             const Vector3i dimensions = node.getVoxelBox().getDimension();
-            const uint32_t uncompressedSize = dimensions[ 0 ] *
-                                              dimensions[ 1 ] *
-                                              dimensions[ 2 ] * _volumeInfo.compCount;
+            const size_t uncompressedBytes = size_t( dimensions[ 0 ] ) *
+                                             dimensions[ 1 ] * dimensions[ 2 ] *
+                                             _volumeInfo.compCount * sizeof( T );
+
+            AllocMemoryUnit *allocUnit = new AllocMemoryUnit( );
+            memUnitPtr.reset( allocUnit );
+            allocUnit->alloc( uncompressedBytes );
 
-            std::vector< T > tuvokData;
-            tuvokData.resize( uncompressedSize );
             const void* dataPtr =
                     _tuvokLargeMMapFilePtr->rd( _offset + blockInfo.m_iOffset,
                                                 blockInfo.m_iLength ).get( );
@@ -288,15 +397,13 @@ public:
             // API from TUVOK, a ref to a shared ptr ? wow
             // void zDecompress(std::shared_ptr<uint8_t> src,
             // std::shared_ptr<uint8_t>& dst,size_t uncompressedBytes)
+            // The destination is the memory unit itself, so the brick is
+            // inflated in place without an intermediate copy.
             std::shared_ptr< std::uint8_t > src( (std::uint8_t *)dataPtr,
                                                     DontDeleteObject< std::uint8_t >() );
-            std::shared_ptr< std::uint8_t > dst( (std::uint8_t *)&tuvokData[ 0 ],
+            std::shared_ptr< std::uint8_t > dst( allocUnit->getData< std::uint8_t >(),
                                                    DontDeleteObject< std::uint8_t >() );
-            zDecompress( src, dst, uncompressedSize );
-
-            AllocMemoryUnit *allocUnit = new AllocMemoryUnit( );
-            allocUnit->allocAndSetData< T >( tuvokData );
-            memUnitPtr.reset( allocUnit );
+            zDecompress( src, dst, uncompressedBytes );
         }
         else
         {
@@ -404,6 +511,9 @@ public:
     LargeFileMMapPtr _tuvokLargeMMapFilePtr;
 
     VolumeInformation& _volumeInfo;
+
+    DecompressionPoolPtr _pool;
+    lunchbox::Monitor< size_t > _pending; //!< The reads posted to _pool
 };
 
 }
@@ -428,6 +538,11 @@ MemoryUnitPtr UVFDataSource::getData( const LODNode& node )
     return _impl->getData( node );
 }
 
+MemoryUnitFutures UVFDataSource::getDataAsync( const LODNodes& nodes )
+{
+    return _impl->getDataAsync( nodes );
+}
+
 void UVFDataSource::internalNodeToLODNode(
     const NodeId internalNode, LODNode& lodNode ) const
 {
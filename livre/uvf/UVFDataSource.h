@@ -31,7 +31,17 @@ namespace detail
     class UVFDataSource;
 }
 
-/** Reads Tuvok Volumes and generates hierarchies. */
+/**
+ * Reads Tuvok Volumes and generates hierarchies.
+ *
+ * Parses URIs in the form:
+ *   uvf:///path/to/volume.uvf?threads=8
+ *
+ * The optional threads parameter sets the number of threads reading and
+ * decompressing bricks for getDataAsync(), by default one per core. The
+ * threads are shared by all UVF data sources of the process, and the parameter
+ * of the source which creates them applies.
+ */
 class UVFDataSource : public VolumeDataSourcePlugin
 {
 public:
@@ -43,6 +53,9 @@ public:
 private:
 
     MemoryUnitPtr getData( const LODNode& node ) final;
+    MemoryUnitFutures getDataAsync( const LODNodes& nodes ) final;
+    bool isThreadSafe() const final { return true; }
+    bool hasAsyncReads() const final { return true; }
     void internalNodeToLODNode( const NodeId internalNode,
                                 LODNode &lodNode ) const final;
 
@@ -20,10 +20,18 @@
 #define BOOST_TEST_MODULE LibCore
 
 #include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <livre/lib/cache/CacheBudgetManager.h>
+#include <livre/lib/cache/CacheSnapshot.h>
+
+#include <boost/filesystem.hpp>
 
 #include "cache/ValidCacheObject.h"
 #include "cache/CacheObjectObserver.h"
 #include "cache/Cache.h"
+#include "cache/CostCache.h"
+#include "cache/LODCache.h"
 
 namespace ut = boost::unit_test;
 
@@ -88,3 +96,272 @@ BOOST_AUTO_TEST_CASE( testCache )
 }
 
 
+
+BOOST_AUTO_TEST_CASE( testCacheStatistics )
+{
+    test::Cache cache;
+    livre::CacheObjectPtr cacheObject = cache.getObjectFromCache( 1 );
+    BOOST_CHECK( !cacheObject->isLoaded( ));
+    cacheObject->cacheLoad();
+    BOOST_CHECK_EQUAL( cacheObject->getReferenceCount_(), 2u );
+
+    // the lookups of each thread are summed up when queried
+    boost::thread_group threads;
+    for( size_t i = 0; i < 4; ++i )
+        threads.create_thread( [ cacheObject ]()
+            {
+                for( size_t j = 0; j < 100; ++j )
+                    cacheObject->isLoaded();
+            });
+    threads.join_all();
+
+    const livre::CacheStatistics& statistics = cache.getStatistics();
+    BOOST_CHECK_EQUAL( statistics.getCacheHits(), 400u );
+    BOOST_CHECK_EQUAL( statistics.getCacheMisses(), 1u );
+    BOOST_CHECK_EQUAL( statistics.getBlockCount(), 1u );
+
+    const std::string json = statistics.toJSON();
+    BOOST_CHECK( json.find( "\"cacheHits\": 400," ) != std::string::npos );
+    BOOST_CHECK( json.find( "\"loads\": 1," ) != std::string::npos );
+    BOOST_CHECK( json.find( "\"loadedBytes\": 1000," ) != std::string::npos );
+    // 1000 bytes are in the [512, 1024) bin
+    BOOST_CHECK( json.find( "\"size\": [0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0" ) !=
+                 std::string::npos );
+    BOOST_CHECK( json.find( "{ \"op\": \"load\"" ) != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( testLRUCache )
+{
+    test::Cache cache;
+    cache.setMaximumMemory( 5 * test::CACHE_SIZE );
+    cache.setCleanupRatio( 0.5f );
+
+    livre::CacheIdSet protectList;
+    protectList.insert( 1 );
+    cache.setProtectList( protectList );
+
+    for( livre::CacheId id = 1; id <= 5; ++id )
+        cache.getObjectFromCache( id )->cacheLoad();
+    BOOST_CHECK( cache.getObjectFromCache( 1 )->isPinned( ));
+
+    // reaching the maximum unloads the least recently used, unpinned objects
+    // until the memory is below half of the maximum
+    cache.getObjectFromCache( 6 )->cacheLoad();
+
+    BOOST_CHECK( cache.getObjectFromCache( 1 )->isLoaded( ));
+    BOOST_CHECK( !cache.getObjectFromCache( 3 )->isLoaded( ));
+    BOOST_CHECK( !cache.getObjectFromCache( 4 )->isLoaded( ));
+    BOOST_CHECK( cache.getObjectFromCache( 6 )->isLoaded( ));
+    BOOST_CHECK_LT( cache.getStatistics().getUsedMemory(),
+                    5 * test::CACHE_SIZE );
+
+    cache.clearProtectList();
+    BOOST_CHECK( !cache.getObjectFromCache( 1 )->isPinned( ));
+}
+
+BOOST_AUTO_TEST_CASE( testAdmissionFilter )
+{
+    test::Cache cache;
+    cache.setMaximumMemory( 5 * test::CACHE_SIZE );
+    cache.setCleanupRatio( 0.1f );
+    cache.setAdmissionFilter( 64 );
+    BOOST_CHECK( cache.hasAdmissionFilter( ));
+
+    for( size_t i = 0; i < 4; ++i )
+        for( livre::CacheId id = 1; id <= 4; ++id )
+            cache.getObjectFromCache( id );
+    for( livre::CacheId id = 1; id <= 4; ++id )
+        cache.getObjectFromCache( id )->cacheLoad();
+
+    // a scan of objects requested once only displaces its own objects
+    for( livre::CacheId id = 100; id < 120; ++id )
+        cache.getObjectFromCache( id )->cacheLoad();
+
+    const livre::CacheStatistics& statistics = cache.getStatistics();
+    BOOST_CHECK_EQUAL( statistics.getRejectionCount(), 20u );
+    BOOST_CHECK_EQUAL( statistics.getAdmissionCount(), 0u );
+    BOOST_CHECK_EQUAL( statistics.getUsedMemory(), 5 * test::CACHE_SIZE );
+    for( livre::CacheId id = 1; id <= 4; ++id )
+        BOOST_CHECK( cache.getObjectFromCache( id )->isLoaded( ));
+    BOOST_CHECK( !cache.getObjectFromCache( 118 )->isLoaded( ));
+    BOOST_CHECK( cache.getObjectFromCache( 119 )->isLoaded( ));
+    BOOST_CHECK( statistics.toJSON().find( "\"rejected\": 20," ) !=
+                 std::string::npos );
+
+    // an object requested more often than the next victim is admitted
+    for( size_t i = 0; i < 4; ++i )
+        cache.getObjectFromCache( 200 );
+    cache.getObjectFromCache( 200 )->cacheLoad();
+    BOOST_CHECK_EQUAL( statistics.getAdmissionCount(), 1u );
+    BOOST_CHECK( cache.getObjectFromCache( 200 )->isLoaded( ));
+    BOOST_CHECK( !cache.getObjectFromCache( 119 )->isLoaded( ));
+    BOOST_CHECK_LT( statistics.getUsedMemory(), 5 * test::CACHE_SIZE );
+}
+
+BOOST_AUTO_TEST_CASE( testGDSFCache )
+{
+    test::Cache cache;
+    cache.setPolicy( livre::LRUCache::POLICY_GDSF );
+    cache.setMaximumMemory( 5 * test::CACHE_SIZE );
+    cache.setCleanupRatio( 0.5f );
+
+    livre::CacheIdSet protectList;
+    protectList.insert( 1 );
+    cache.setProtectList( protectList );
+
+    for( livre::CacheId id = 1; id <= 6; ++id )
+        cache.getObjectFromCache( id )->cacheLoad();
+
+    BOOST_CHECK( cache.getObjectFromCache( 1 )->isLoaded( ));
+    BOOST_CHECK_LT( cache.getStatistics().getUsedMemory(),
+                    5 * test::CACHE_SIZE );
+    BOOST_CHECK_GT( cache.getStatistics().getUnloadCount(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( testGDSFCacheCosts )
+{
+    // an expensive small object, loaded first, and a cheap large one
+    const livre::CacheId expensive = 1;
+    const livre::CacheId cheap = 2;
+    const livre::CacheId filler = 3;
+
+    test::CostCache cache;
+    cache.setPolicy( livre::LRUCache::POLICY_GDSF );
+    cache.setMaximumMemory( 6 * test::CACHE_SIZE );
+    cache.setCleanupRatio( 0.4f );
+    cache.setCost( expensive, test::CACHE_SIZE, 50 );
+    cache.setCost( cheap, 4 * test::CACHE_SIZE, 0 );
+    cache.setCost( filler, 2 * test::CACHE_SIZE, 0 );
+
+    cache.getObjectFromCache( expensive )->cacheLoad();
+    cache.getObjectFromCache( cheap )->cacheLoad();
+    BOOST_CHECK_GT( cache.getObjectFromCache( expensive )->getLoadTime(),
+                    cache.getObjectFromCache( cheap )->getLoadTime( ));
+
+    // exceeds the maximum memory: the cheap large object goes first, even
+    // though the expensive one is the least recently used
+    cache.getObjectFromCache( filler )->cacheLoad();
+    BOOST_CHECK( !cache.getObjectFromCache( cheap )->isLoaded( ));
+    BOOST_CHECK( cache.getObjectFromCache( expensive )->isLoaded( ));
+    BOOST_CHECK_EQUAL( cache.getStatistics().getUsedMemory(),
+                       3 * test::CACHE_SIZE );
+}
+
+BOOST_AUTO_TEST_CASE( testImportanceCache )
+{
+    const livre::NodeId root( 0, livre::Vector3ui( 0u ));
+    const livre::NodeIds children = root.getChildren();
+
+    // once all children are loaded, the root is covered and unloaded first
+    test::LODCache cache;
+    cache.setMaximumMemory( 9 * test::CACHE_SIZE );
+    cache.setCleanupRatio( 0.05f );
+
+    cache.getObjectFromCache( root.getId( ))->cacheLoad();
+    BOOST_FOREACH( const livre::NodeId& child, children )
+        cache.getObjectFromCache( child.getId( ))->cacheLoad();
+
+    BOOST_CHECK( !cache.getObjectFromCache( root.getId( ))->isLoaded( ));
+    BOOST_CHECK_EQUAL( cache.getStatistics().getUsedMemory(),
+                       8 * test::CACHE_SIZE );
+
+    // unless its level reserves the memory
+    test::LODCache reservedCache;
+    reservedCache.setMaximumMemory( 9 * test::CACHE_SIZE );
+    reservedCache.setCleanupRatio( 0.05f );
+    reservedCache.getImportancePolicy().setLevelReservation(
+        0, test::CACHE_SIZE );
+
+    reservedCache.getObjectFromCache( root.getId( ))->cacheLoad();
+    BOOST_FOREACH( const livre::NodeId& child, children )
+        reservedCache.getObjectFromCache( child.getId( ))->cacheLoad();
+
+    BOOST_CHECK( reservedCache.getObjectFromCache( root.getId( ))->isLoaded( ));
+    BOOST_CHECK_EQUAL( reservedCache.getStatistics().getUsedMemory(),
+                       8 * test::CACHE_SIZE );
+}
+
+BOOST_AUTO_TEST_CASE( testCacheBudgetManager )
+{
+    test::Cache thrashingCache;
+    test::Cache idleCache;
+    thrashingCache.setCleanupRatio( 0.5f );
+
+    livre::CacheBudgetManager manager;
+    manager.addCache( thrashingCache, 2 * test::CACHE_SIZE, test::CACHE_SIZE,
+                      8 * test::CACHE_SIZE );
+    manager.addCache( idleCache, 8 * test::CACHE_SIZE, 2 * test::CACHE_SIZE,
+                      8 * test::CACHE_SIZE );
+    BOOST_CHECK( !manager.rebalance( ));
+
+    // the thrashing cache unloads and misses objects, the idle one only hits
+    idleCache.getObjectFromCache( 1 )->cacheLoad();
+    for( size_t i = 0; i < 2; ++i )
+        for( livre::CacheId id = 1; id <= 6; ++id )
+        {
+            livre::CacheObjectPtr object =
+                thrashingCache.getObjectFromCache( id );
+            if( !object->isLoaded( ))
+                object->cacheLoad();
+            idleCache.getObjectFromCache( 1 )->isLoaded();
+        }
+    BOOST_CHECK_GT( thrashingCache.getStatistics().getUnloadCount(), 0u );
+
+    // a tenth of both budgets moves to the thrashing cache
+    BOOST_CHECK( manager.rebalance( ));
+    BOOST_CHECK_EQUAL( manager.getBudget( thrashingCache ),
+                       3 * test::CACHE_SIZE );
+    BOOST_CHECK_EQUAL( manager.getBudget( idleCache ), 7 * test::CACHE_SIZE );
+
+    // without new statistics, the budgets are kept
+    BOOST_CHECK( !manager.rebalance( ));
+    BOOST_CHECK_EQUAL( manager.getBudget( idleCache ), 7 * test::CACHE_SIZE );
+
+    manager.removeCache( idleCache );
+    BOOST_CHECK_EQUAL( manager.getBudget( idleCache ), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( testCacheSnapshot )
+{
+    test::Cache cache;
+    for( livre::CacheId id = 1; id <= 3; ++id )
+        cache.getObjectFromCache( id );
+    cache.getObjectFromCache( 2 )->cacheLoad();
+    cache.getObjectFromCache( 3 )->cacheLoad();
+
+    // 2 becomes the most recently used
+    boost::this_thread::sleep( boost::posix_time::milliseconds( 10 ));
+    cache.getObjectFromCache( 2 );
+
+    const livre::CacheIds cacheIds = cache.getLoadedCacheIds();
+    BOOST_REQUIRE_EQUAL( cacheIds.size(), 2u );
+    BOOST_CHECK_EQUAL( cacheIds[0], 2u );
+    BOOST_CHECK_EQUAL( cacheIds[1], 3u );
+
+    // the snapshot keeps the order, and only applies to the same volume
+    const boost::filesystem::path filename =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path( "livre-%%%%-%%%%.snapshot" );
+    BOOST_REQUIRE( livre::saveCacheSnapshot( filename.string(), "mem:///",
+                                             cacheIds ));
+    BOOST_CHECK( livre::loadCacheSnapshot( filename.string(), "mem:///" ) ==
+                 cacheIds );
+
+    const livre::CacheIds hotFirst = { 0xff00000000000003ull, 2, 1 };
+    BOOST_REQUIRE( livre::saveCacheSnapshot( filename.string(), "mem:///",
+                                             hotFirst ));
+    BOOST_CHECK( livre::loadCacheSnapshot( filename.string(), "mem:///" ) ==
+                 hotFirst );
+    BOOST_CHECK( livre::loadCacheSnapshot( filename.string(),
+                                           "mem:///#other" ).empty( ));
+    boost::filesystem::remove( filename );
+    BOOST_CHECK( livre::loadCacheSnapshot( filename.string(),
+                                           "mem:///" ).empty( ));
+
+    // an unwritable snapshot fails
+    const boost::filesystem::path missingDir =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path( "livre-%%%%-%%%%" ) / "cache.snapshot";
+    BOOST_CHECK( !livre::saveCacheSnapshot( missingDir.string(), "mem:///",
+                                            hotFirst ));
+}
@@ -0,0 +1,92 @@
+/* Copyright (c) 2011-2014, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _TestCostCache_h_
+#define _TestCostCache_h_
+
+#include <livre/lib/cache/LRUCache.h>
+#include <livre/core/cache/CacheObject.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace test
+{
+
+/** Cache object with a given size and loading time */
+class CostCacheObject : public livre::CacheObject
+{
+public:
+    CostCacheObject( const livre::CacheId cacheId, const size_t size,
+                     const uint32_t loadTimeMS )
+        : cacheId_( cacheId ),
+          size_( size ),
+          loadTimeMS_( loadTimeMS ),
+          isLoadedVar_( false )
+    {}
+
+    livre::CacheId getCacheID() const final { return cacheId_; }
+    size_t getCacheSize() const final { return size_; }
+
+private:
+    bool load_() final
+    {
+        if( loadTimeMS_ > 0 )
+            boost::this_thread::sleep( boost::posix_time::milliseconds(
+                                           loadTimeMS_ ));
+        isLoadedVar_ = true;
+        return true;
+    }
+
+    void unload_() final { isLoadedVar_ = false; }
+    bool isLoaded_() const final { return isLoadedVar_; }
+    bool isValid_() const final { return true; }
+
+    const livre::CacheId cacheId_;
+    const size_t size_;
+    const uint32_t loadTimeMS_;
+    bool isLoadedVar_;
+};
+
+/** Cache of CostCacheObject, with the costs set per cache id */
+class CostCache : public livre::LRUCache
+{
+public:
+    void setCost( const livre::CacheId cacheId, const size_t size,
+                  const uint32_t loadTimeMS )
+    {
+        costs_[ cacheId ] = Cost( size, loadTimeMS );
+    }
+
+private:
+    typedef std::pair< size_t, uint32_t > Cost;
+
+    livre::CacheObject* generateCacheObjectFromID_(
+        const livre::CacheId cacheId ) final
+    {
+        const Cost& cost = costs_[ cacheId ];
+        return new CostCacheObject( cacheId, cost.first, cost.second );
+    }
+
+    boost::unordered_map< livre::CacheId, Cost > costs_;
+};
+
+}
+
+#endif // _TestCostCache_h_
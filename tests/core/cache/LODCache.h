@@ -0,0 +1,84 @@
+/* Copyright (c) 2011-2014, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _TestLODCache_h_
+#define _TestLODCache_h_
+
+#include <livre/core/data/LODNode.h>
+#include <livre/core/data/LODNodeTrait.h>
+#include <livre/lib/cache/ImportanceCachePolicy.h>
+#include <livre/lib/cache/LRUCache.h>
+
+#include "ValidCacheObject.h"
+
+namespace test
+{
+
+const livre::Vector3i BLOCK_SIZE( 32 );
+
+class LODCacheObject : public ValidCacheObject, public livre::LODNodeTrait
+{
+public:
+    explicit LODCacheObject( const livre::NodeId& nodeId )
+        : livre::LODNodeTrait( livre::ConstLODNodePtr(
+              new livre::LODNode( nodeId, BLOCK_SIZE,
+                                  livre::Vector3i( 1 << nodeId.getLevel( )))))
+    {
+        setCacheId( nodeId.getId( ));
+    }
+};
+
+/** A cache of LODCacheObjects, the cache ids are node ids */
+class LODCache : public livre::LRUCache
+{
+public:
+    LODCache()
+    {
+        setPolicy_( importancePolicy_, "Importance" );
+    }
+
+    void setMaximumMemory( const size_t maxMemoryInBytes ) override
+    {
+        livre::LRUCache::setMaximumMemory( maxMemoryInBytes );
+        importancePolicy_.setMaximumMemory( maxMemoryInBytes );
+    }
+
+    void setCleanupRatio( const float cleanUpRatio ) override
+    {
+        livre::LRUCache::setCleanupRatio( cleanUpRatio );
+        importancePolicy_.setCleanupRatio( cleanUpRatio );
+    }
+
+    livre::ImportanceCachePolicy& getImportancePolicy()
+        { return importancePolicy_; }
+
+private:
+
+    livre::CacheObject *generateCacheObjectFromID_(
+        const livre::CacheId cacheID )
+    {
+        return new LODCacheObject( livre::NodeId( cacheID ));
+    }
+
+    livre::ImportanceCachePolicy importancePolicy_;
+};
+
+}
+
+#endif // _TestLODCache_h_
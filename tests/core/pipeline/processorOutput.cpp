@@ -0,0 +1,138 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE ProcessorOutput
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <livre/core/pipeline/Processor.h>
+#include <livre/core/pipeline/ProcessorOutput.h>
+
+namespace
+{
+const uint32_t CONNECTION_ID = 0;
+
+class Output : public livre::ProcessorOutput
+{
+public:
+    explicit Output( livre::Processor& processor )
+        : livre::ProcessorOutput( processor )
+        , commits( 0 )
+        , pendingCommits( 0 )
+    {}
+
+    size_t commits;
+    size_t pendingCommits;
+
+private:
+    livre::CommitState commit_( const uint32_t ) final
+    {
+        ++commits;
+        return livre::CS_COMMITED;
+    }
+
+    size_t getPendingCommits_( const uint32_t ) const final
+    {
+        return pendingCommits;
+    }
+};
+}
+
+BOOST_AUTO_TEST_CASE( testCommitBatchedCount )
+{
+    livre::Processor processor;
+    Output output( processor );
+    output.setCommitBatching( 3, 1e6f, 0 );
+
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_NOCHANGE );
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_NOCHANGE );
+    BOOST_CHECK_EQUAL( output.getBatchedChanges(), 2u );
+    BOOST_CHECK_EQUAL( output.commits, 0u );
+
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_COMMITED );
+    BOOST_CHECK_EQUAL( output.getBatchedChanges(), 0u );
+    BOOST_CHECK_EQUAL( output.commits, 1u );
+}
+
+BOOST_AUTO_TEST_CASE( testCommitBatchedLatency )
+{
+    livre::Processor processor;
+    Output output( processor );
+    output.setCommitBatching( 100, 10.f, 0 );
+
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_NOCHANGE );
+    boost::this_thread::sleep( boost::posix_time::milliseconds( 20 ));
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_COMMITED );
+    BOOST_CHECK_EQUAL( output.commits, 1u );
+
+    // a new batch starts its own latency budget
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_NOCHANGE );
+    BOOST_CHECK_EQUAL( output.commits, 1u );
+}
+
+BOOST_AUTO_TEST_CASE( testCommitBatchedPending )
+{
+    livre::Processor processor;
+    Output output( processor );
+    output.setCommitBatching( 1, 0.f, 2 );
+
+    // held back while the receiver lags, the changes coalesce
+    output.pendingCommits = 2;
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_NOCHANGE );
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_NOCHANGE );
+    BOOST_CHECK_EQUAL( output.getBatchedChanges(), 2u );
+    BOOST_CHECK_EQUAL( output.commits, 0u );
+
+    output.pendingCommits = 1;
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_COMMITED );
+    BOOST_CHECK_EQUAL( output.commits, 1u );
+
+    // no limit
+    output.setCommitBatching( 1, 0.f, 0 );
+    output.pendingCommits = 100;
+    BOOST_CHECK_EQUAL( output.commitBatched( CONNECTION_ID ),
+                       livre::CS_COMMITED );
+}
+
+BOOST_AUTO_TEST_CASE( testCommitPending )
+{
+    livre::Processor processor;
+    Output output( processor );
+    output.setCommitBatching( 100, 1e6f, 0 );
+
+    BOOST_CHECK_EQUAL( output.commitPending( CONNECTION_ID ),
+                       livre::CS_NOCHANGE );
+    BOOST_CHECK_EQUAL( output.commits, 0u );
+
+    output.commitBatched( CONNECTION_ID );
+    BOOST_CHECK_EQUAL( output.commitPending( CONNECTION_ID ),
+                       livre::CS_COMMITED );
+    BOOST_CHECK_EQUAL( output.commits, 1u );
+    BOOST_CHECK_EQUAL( output.getBatchedChanges(), 0u );
+}
@@ -0,0 +1,82 @@
+/* Copyright (c) 2011-2014, EPFL/Blue Brain Project
+ *                     Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE SlabAllocator
+
+#include <boost/test/unit_test.hpp>
+
+#include <livre/core/data/MemoryUnit.h>
+#include <livre/core/data/SlabAllocator.h>
+
+BOOST_AUTO_TEST_CASE( testSlabAllocator )
+{
+    livre::SlabAllocator allocator( 1000, 2 );
+    BOOST_CHECK_EQUAL( allocator.getSlotSize(), 4096u );
+    BOOST_CHECK_EQUAL( allocator.getSlotCount(), 2u );
+
+    uint8_t* first = allocator.allocate( 4096 );
+    uint8_t* second = allocator.allocate( 1 );
+    BOOST_REQUIRE( first && second );
+    BOOST_CHECK( first != second );
+    BOOST_CHECK( !allocator.allocate( 1 ));
+    BOOST_CHECK_EQUAL( allocator.getUsedSlotCount(), 2u );
+
+    allocator.deallocate( first );
+    BOOST_CHECK( !allocator.allocate( 4097 ));
+    BOOST_CHECK( allocator.allocate( 100 ) == first );
+    allocator.deallocate( first );
+    allocator.deallocate( second );
+    BOOST_CHECK_EQUAL( allocator.getUsedSlotCount(), 0u );
+
+    livre::SlabAllocator brickAllocator( 4096, 1,
+                                         livre::SlabAllocator::SLAB_DEFAULT,
+                                         2048 );
+    BOOST_CHECK_EQUAL( brickAllocator.getMinimumSize(), 2048u );
+    BOOST_CHECK( !brickAllocator.allocate( 2047 ));
+    uint8_t* brick = brickAllocator.allocate( 2048 );
+    BOOST_REQUIRE( brick );
+    brickAllocator.deallocate( brick );
+}
+
+BOOST_AUTO_TEST_CASE( testSlabMemoryUnit )
+{
+    livre::SlabAllocatorPtr allocator( new livre::SlabAllocator( 4096, 1 ));
+    livre::AllocMemoryUnit::setSlabAllocator( allocator );
+
+    livre::AllocMemoryUnit slabUnit;
+    slabUnit.alloc( 4000 );
+    BOOST_CHECK_EQUAL( slabUnit.getMemSize(), 4000u );
+    BOOST_CHECK_EQUAL( slabUnit.getAllocSize(), 4096u );
+    BOOST_CHECK_EQUAL( allocator->getUsedSlotCount(), 1u );
+
+    // without a free slot, the memory comes from the heap
+    {
+        livre::AllocMemoryUnit heapUnit;
+        heapUnit.allocAndSetData( std::vector< uint8_t >( 4000, 42 ));
+        BOOST_CHECK_EQUAL( heapUnit.getData< uint8_t >()[ 3999 ], 42 );
+        BOOST_CHECK_EQUAL( allocator->getUsedSlotCount(), 1u );
+    }
+
+    // the slot outlives the allocator setting, and is returned on release
+    livre::AllocMemoryUnit::setSlabAllocator( livre::SlabAllocatorPtr( ));
+    slabUnit.getData< uint8_t >()[ 3999 ] = 42;
+    slabUnit.release();
+    BOOST_CHECK_EQUAL( slabUnit.getMemSize(), 0u );
+    BOOST_CHECK_EQUAL( allocator->getUsedSlotCount(), 0u );
+}
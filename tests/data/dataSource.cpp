@@ -27,6 +27,11 @@
 #include <livre/core/data/MemoryUnit.h>
 #include <livre/core/data/VolumeInformation.h>
 #include <livre/core/mathTypes.h>
+#include <livre/lib/data/LVBFormat.h>
+#include <livre/lib/data/LVBWriter.h>
+
+#include <cstdio>
+#include <fstream>
 
 
 namespace
@@ -36,6 +41,30 @@ const uint32_t VOXEL_SIZE_X = 1024;
 const uint32_t VOXEL_SIZE_Y = 1024;
 const uint32_t VOXEL_SIZE_Z = 512;
 
+const uint32_t RAW_SIZE_XY = 32;
+const uint32_t RAW_SIZE_Z = 128;
+
+uint8_t _getRawVoxel( const uint32_t x, const uint32_t y, const uint32_t z )
+{
+    return uint8_t( x + 3 * y + 7 * z );
+}
+
+/** Writes a uint8 raw volume of RAW_SIZE_XY^2 * RAW_SIZE_Z voxels */
+void _writeRawVolume( const std::string& filename )
+{
+    std::vector< uint8_t > voxels;
+    voxels.reserve( RAW_SIZE_XY * RAW_SIZE_XY * RAW_SIZE_Z );
+    for( uint32_t z = 0; z < RAW_SIZE_Z; ++z )
+        for( uint32_t y = 0; y < RAW_SIZE_XY; ++y )
+            for( uint32_t x = 0; x < RAW_SIZE_XY; ++x )
+                voxels.push_back( _getRawVoxel( x, y, z ));
+
+    std::ofstream file( filename.c_str(), std::ios::binary );
+    file.write( reinterpret_cast< const char* >( voxels.data( )),
+                voxels.size( ));
+    BOOST_REQUIRE( file );
+}
+
 void _testDataSource( const std::string& uriStr )
 {
     const lunchbox::URI uri( uriStr );
@@ -69,6 +98,30 @@ void _testDataSource( const std::string& uriStr )
                              info.compCount * info.getBytesPerVoxel();
 
     BOOST_CHECK_EQUAL( memUnit->getMemSize(), allocSize );
+
+    livre::LODNodes children;
+    BOOST_FOREACH( const livre::NodeId& childId, parentNodeId.getChildren( ))
+        children.push_back( *source.getNode( childId ));
+
+    livre::MemoryUnitFutures futures = source.getDataAsync( children );
+    BOOST_CHECK_EQUAL( futures.size(), children.size( ));
+    BOOST_FOREACH( livre::MemoryUnitFuture& future, futures )
+    {
+        const livre::MemoryUnitPtr childUnit = future.get();
+        BOOST_CHECK( childUnit );
+        BOOST_CHECK_EQUAL( childUnit->getMemSize(), allocSize );
+    }
+
+    // getData() returns the data read ahead, or reads it again if cancelled
+    source.readAhead( children );
+    source.readAhead( children );
+    source.cancelReadAhead( children.front().getNodeId( ));
+    BOOST_FOREACH( const livre::LODNode& child, children )
+    {
+        const livre::MemoryUnitPtr childUnit = source.getData( child );
+        BOOST_CHECK( childUnit );
+        BOOST_CHECK_EQUAL( childUnit->getMemSize(), allocSize );
+    }
 }
 }
 
@@ -81,6 +134,70 @@ BOOST_AUTO_TEST_CASE( memoryDataSource )
     _testDataSource( volumeName.str( ));
 }
 
+BOOST_AUTO_TEST_CASE( memoryDataSourcePatterns )
+{
+    const char* patterns[] = { "constant", "noise", "spheres", "gradient" };
+    BOOST_FOREACH( const char* pattern, patterns )
+    {
+        std::stringstream volumeName;
+        volumeName << "mem:///?sparsity=0.5&pattern=" << pattern << "#"
+                   << VOXEL_SIZE_X << "," << VOXEL_SIZE_Y << ","
+                   << VOXEL_SIZE_Z << "," << BLOCK_SIZE;
+        _testDataSource( volumeName.str( ));
+
+        // the same brick has the same data in every source and every call
+        const lunchbox::URI uri( volumeName.str( ));
+        livre::VolumeDataSource source1( uri );
+        livre::VolumeDataSource source2( uri );
+        const livre::NodeId nodeId( 4, livre::Vector3ui( 3, 5, 7 ), 0 );
+        livre::ConstLODNodePtr node = source1.getNode( nodeId );
+        const livre::MemoryUnitPtr data1 = source1.getData( *node );
+        const livre::MemoryUnitPtr data2 = source2.getData( *node );
+        BOOST_REQUIRE_EQUAL( data1->getMemSize(), data2->getMemSize( ));
+        const uint8_t* bytes1 = data1->getData< uint8_t >();
+        const uint8_t* bytes2 = data2->getData< uint8_t >();
+        BOOST_CHECK_EQUAL_COLLECTIONS( bytes1, bytes1 + data1->getMemSize(),
+                                       bytes2, bytes2 + data2->getMemSize( ));
+    }
+    BOOST_CHECK_THROW( livre::VolumeDataSource(
+                           lunchbox::URI( "mem:///?pattern=plaid" )),
+                       std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( memoryDataSourceGenerators )
+{
+    std::stringstream size;
+    size << "#" << VOXEL_SIZE_X << "," << VOXEL_SIZE_Y << "," << VOXEL_SIZE_Z
+         << "," << BLOCK_SIZE;
+    const livre::NodeId nodeId( 4, livre::Vector3ui( 3, 5, 7 ), 0 );
+
+    // the sparsity is the fraction of the voxels which are not empty
+    livre::VolumeDataSource noise(
+        lunchbox::URI( "mem:///?pattern=noise&sparsity=0.25" + size.str( )));
+    const livre::MemoryUnitPtr noiseData =
+        noise.getData( *noise.getNode( nodeId ));
+    const uint8_t* noiseBytes = noiseData->getData< uint8_t >();
+    size_t nonEmpty = 0;
+    for( size_t i = 0; i < noiseData->getMemSize(); ++i )
+        nonEmpty += noiseBytes[i] ? 1 : 0;
+    const float fraction = float( nonEmpty ) / noiseData->getMemSize();
+    BOOST_CHECK_GT( fraction, 0.23f );
+    BOOST_CHECK_LT( fraction, 0.27f );
+
+    // the gradient rows increase along x, on the vector and the scalar paths
+    livre::VolumeDataSource gradient(
+        lunchbox::URI( "mem:///?pattern=gradient" + size.str( )));
+    const livre::MemoryUnitPtr gradientData =
+        gradient.getData( *gradient.getNode( nodeId ));
+    const uint8_t* gradientBytes = gradientData->getData< uint8_t >();
+    const size_t rowSize = BLOCK_SIZE + 2 * 4; // overlap of the mem source
+    for( size_t i = 0; i < gradientData->getMemSize(); ++i )
+    {
+        if( i % rowSize != 0 )
+            BOOST_REQUIRE_LE( gradientBytes[i - 1], gradientBytes[i] );
+    }
+}
+
 #ifdef LIVRE_USE_REMOTE_DATASOURCE
 BOOST_AUTO_TEST_CASE( remoteMemoryDataSource )
 {
@@ -101,3 +218,132 @@ BOOST_AUTO_TEST_CASE( remoteMemoryDataSource )
     }
 }
 #endif
+
+BOOST_AUTO_TEST_CASE( rawDataSource )
+{
+    const std::string filename = "rawDataSource.img";
+    _writeRawVolume( filename );
+
+    std::stringstream dims;
+    dims << "raw://" << filename << "?dims=" << RAW_SIZE_XY << ","
+         << RAW_SIZE_XY << "," << RAW_SIZE_Z << "&type=uint8&block="
+         << RAW_SIZE_XY;
+
+    // Without overlap, the bricks span whole slices and map the file
+    {
+        livre::VolumeDataSource source(
+            lunchbox::URI( dims.str() + "&overlap=0" ));
+        const livre::NodeId nodeId( 0, livre::Vector3ui( 0, 0, 1 ), 0 );
+        livre::ConstLODNodePtr node = source.getNode( nodeId );
+        BOOST_REQUIRE( node );
+
+        const livre::ConstMemoryUnitPtr data1 = source.getData( *node );
+        const livre::ConstMemoryUnitPtr data2 = source.getData( *node );
+        BOOST_REQUIRE( data1 && data2 );
+        BOOST_CHECK_EQUAL( data1->getMemSize(),
+                           RAW_SIZE_XY * RAW_SIZE_XY * RAW_SIZE_XY );
+        const uint8_t* voxels = data1->getData< uint8_t >();
+        BOOST_CHECK( voxels == data2->getData< uint8_t >( ));
+        BOOST_CHECK_EQUAL( voxels[ 0 ], _getRawVoxel( 0, 0, RAW_SIZE_XY ));
+        BOOST_CHECK_EQUAL( voxels[ RAW_SIZE_XY + 1 ],
+                           _getRawVoxel( 1, 1, RAW_SIZE_XY ));
+    }
+
+    // With overlap, the bricks are copied and clamped at the borders
+    {
+        const uint32_t overlap = 2;
+        std::stringstream uri;
+        uri << dims.str() << "&overlap=" << overlap;
+        livre::VolumeDataSource source( (lunchbox::URI( uri.str( ))));
+        const livre::NodeId nodeId( 0, livre::Vector3ui( 0, 0, 1 ), 0 );
+        livre::ConstLODNodePtr node = source.getNode( nodeId );
+        BOOST_REQUIRE( node );
+
+        const uint32_t size = RAW_SIZE_XY + 2 * overlap;
+        const livre::ConstMemoryUnitPtr data1 = source.getData( *node );
+        const livre::ConstMemoryUnitPtr data2 = source.getData( *node );
+        BOOST_REQUIRE( data1 && data2 );
+        BOOST_CHECK_EQUAL( data1->getMemSize(), size * size * size );
+        const uint8_t* voxels = data1->getData< uint8_t >();
+        BOOST_CHECK( voxels != data2->getData< uint8_t >( ));
+
+        // x and y are clamped to 0, z starts within the previous brick
+        BOOST_CHECK_EQUAL( voxels[ 0 ],
+                           _getRawVoxel( 0, 0, RAW_SIZE_XY - overlap ));
+        const size_t first = ( overlap * size + overlap ) * size + overlap;
+        BOOST_CHECK_EQUAL( voxels[ first ], _getRawVoxel( 0, 0, RAW_SIZE_XY ));
+        BOOST_CHECK_EQUAL( voxels[ first + 1 ],
+                           _getRawVoxel( 1, 0, RAW_SIZE_XY ));
+    }
+
+    ::remove( filename.c_str( ));
+}
+
+BOOST_AUTO_TEST_CASE( lvbDataSource )
+{
+    const lunchbox::URI uri( "mem:///?pattern=spheres#128,128,128,32" );
+    livre::VolumeDataSource source( uri );
+    const livre::VolumeInformation& info = source.getVolumeInformation();
+    const std::string filename = "lvbDataSource.lvb";
+
+    const livre::BrickCompression compressions[] = {
+        livre::BRICK_COMPRESSION_NONE, livre::BRICK_COMPRESSION_LZ4,
+        livre::BRICK_COMPRESSION_ZSTD };
+    BOOST_FOREACH( const livre::BrickCompression compression, compressions )
+    {
+        if( !livre::isBrickCompressionSupported( compression ))
+            continue;
+
+        livre::writeLVB( source, filename, compression );
+        livre::VolumeDataSource lvb( lunchbox::URI( "lvb://" + filename ));
+        const livre::VolumeInformation& lvbInfo = lvb.getVolumeInformation();
+        BOOST_CHECK_EQUAL( lvbInfo.voxels, info.voxels );
+        BOOST_CHECK_EQUAL( lvbInfo.maximumBlockSize, info.maximumBlockSize );
+        BOOST_CHECK_EQUAL( lvbInfo.overlap, info.overlap );
+        BOOST_CHECK_EQUAL( lvbInfo.dataType, info.dataType );
+        BOOST_CHECK_EQUAL( lvbInfo.rootNode.getDepth(),
+                           info.rootNode.getDepth( ));
+
+        // every brick reads back as written
+        for( uint32_t level = 0; level < info.rootNode.getDepth(); ++level )
+        {
+            const livre::Vector3ui blocks = info.rootNode.getBlockSize( level );
+            for( uint32_t z = 0; z < blocks.z(); ++z )
+              for( uint32_t y = 0; y < blocks.y(); ++y )
+                for( uint32_t x = 0; x < blocks.x(); ++x )
+                {
+                    const livre::NodeId nodeId( level,
+                                                livre::Vector3ui( x, y, z ),
+                                                info.frameRange[0] );
+                    livre::ConstLODNodePtr node = source.getNode( nodeId );
+                    livre::ConstLODNodePtr lvbNode = lvb.getNode( nodeId );
+                    BOOST_REQUIRE( node && lvbNode );
+
+                    const livre::ConstMemoryUnitPtr data =
+                        source.getData( *node );
+                    const livre::ConstMemoryUnitPtr lvbData =
+                        lvb.getData( *lvbNode );
+                    BOOST_REQUIRE( lvbData );
+                    BOOST_REQUIRE_EQUAL( lvbData->getMemSize(),
+                                         data->getMemSize( ));
+                    const uint8_t* bytes = data->getData< uint8_t >();
+                    const uint8_t* lvbBytes = lvbData->getData< uint8_t >();
+                    BOOST_CHECK( std::equal( bytes,
+                                             bytes + data->getMemSize(),
+                                             lvbBytes ));
+                }
+        }
+    }
+
+    // files of the other byte order are rejected
+    {
+        std::fstream file( filename.c_str(), std::ios::binary |
+                                             std::ios::in | std::ios::out );
+        const uint32_t magic = livre::LVB_MAGIC_SWAPPED;
+        file.write( reinterpret_cast< const char* >( &magic ), sizeof( magic ));
+    }
+    BOOST_CHECK_THROW( livre::VolumeDataSource(
+                           lunchbox::URI( "lvb://" + filename )),
+                       std::runtime_error );
+    ::remove( filename.c_str( ));
+}
@@ -0,0 +1,82 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE LibCompressedCache
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/cache/CompressedCache.h>
+#include <livre/core/data/MemoryUnit.h>
+
+namespace
+{
+const size_t BRICK_SIZE = 4096;
+
+void storeBrick( livre::CompressedCache& cache, const uint8_t value )
+{
+    livre::AllocMemoryUnit brick;
+    brick.alloc( BRICK_SIZE );
+    ::memset( brick.getData< uint8_t >(), value, BRICK_SIZE );
+    cache.store( value, brick );
+}
+}
+
+BOOST_AUTO_TEST_CASE( testCompressedCache )
+{
+    livre::CompressedCache cache( BRICK_SIZE );
+    storeBrick( cache, 1 );
+    if( !livre::CompressedCache::isSupported( ))
+    {
+        BOOST_CHECK( !cache.contains( 1 ));
+        return;
+    }
+
+    // uniform bricks compress to a fraction of their size
+    BOOST_CHECK( cache.contains( 1 ));
+    BOOST_CHECK_LT( cache.getUsedMemory(), BRICK_SIZE / 8 );
+    BOOST_CHECK_EQUAL( cache.getUncompressedMemory(), BRICK_SIZE );
+
+    livre::AllocMemoryUnit brick;
+    BOOST_CHECK( !cache.load( 2, BRICK_SIZE, brick ));
+    BOOST_REQUIRE( cache.load( 1, BRICK_SIZE, brick ));
+    BOOST_CHECK_EQUAL( brick.getMemSize(), BRICK_SIZE );
+    BOOST_CHECK_EQUAL( brick.getData< uint8_t >()[ BRICK_SIZE - 1 ], 1 );
+
+    // loaded bricks leave the cache
+    BOOST_CHECK( !cache.contains( 1 ));
+    BOOST_CHECK_EQUAL( cache.getUsedMemory(), 0u );
+
+    // random bricks do not compress and are not stored
+    livre::AllocMemoryUnit noise;
+    noise.alloc( BRICK_SIZE );
+    uint32_t seed = 42;
+    for( size_t i = 0; i < BRICK_SIZE; ++i )
+    {
+        seed = seed * 1664525u + 1013904223u;
+        noise.getData< uint8_t >()[ i ] = uint8_t( seed >> 24 );
+    }
+    cache.store( 3, noise );
+    BOOST_CHECK( !cache.contains( 3 ));
+
+    // the least recently stored bricks are evicted
+    for( uint8_t i = 4; i < 255; ++i )
+        storeBrick( cache, i );
+    BOOST_CHECK( !cache.contains( 4 ));
+    BOOST_CHECK( cache.contains( 254 ));
+    BOOST_CHECK_LE( cache.getUsedMemory(), BRICK_SIZE );
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE LibDataLoaderPool
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/cache/TextureDataCache.h>
+#include <livre/lib/uploaders/DataLoaderPool.h>
+#include <livre/core/cache/CacheObject.h>
+#include <livre/core/data/NodeId.h>
+#include <livre/core/data/VolumeDataSource.h>
+
+#include <eq/gl.h>
+#include <boost/foreach.hpp>
+
+BOOST_AUTO_TEST_CASE( testDataLoaderPool )
+{
+    // 256^3 voxels in 32^3 blocks, the third level has 4x4x4 bricks
+    livre::VolumeDataSourcePtr source( new livre::VolumeDataSource(
+        lunchbox::URI( "mem://#256,256,256,32" )));
+    livre::TextureDataCache cache( source, GL_UNSIGNED_BYTE );
+    cache.setMaximumMemory( LB_1GB );
+
+    livre::CacheIds cacheIds;
+    for( uint32_t z = 0; z < 4; ++z )
+        for( uint32_t y = 0; y < 4; ++y )
+            for( uint32_t x = 0; x < 4; ++x )
+                cacheIds.push_back( livre::NodeId(
+                    2, livre::Vector3ui( x, y, z ), 0 ).getId( ));
+
+    livre::DataLoaderPool pool( cache, 4 );
+    BOOST_CHECK_EQUAL( pool.getThreadCount(), 4u );
+
+    // duplicates are queued once
+    livre::CacheIds queue = cacheIds;
+    queue.insert( queue.end(), cacheIds.begin(), cacheIds.end( ));
+    pool.setQueue( queue );
+    BOOST_CHECK_LE( pool.getQueueSize(), cacheIds.size( ));
+
+    // the bricks are published in queue order, whichever thread loads them
+    BOOST_FOREACH( const livre::CacheId cacheId, cacheIds )
+    {
+        const livre::ConstCacheObjectPtr brick = pool.load( cacheId );
+        BOOST_REQUIRE( brick );
+        BOOST_CHECK( brick->isLoaded( ));
+        BOOST_CHECK_EQUAL( brick->getCacheID(), cacheId );
+    }
+    BOOST_CHECK_EQUAL( pool.getQueueSize(), 0u );
+    BOOST_CHECK_EQUAL( cache.getNumberOfCacheObjects(), cacheIds.size( ));
+
+    // loaded bricks are not loaded again
+    const livre::ConstCacheObjectPtr brick = pool.load( cacheIds.front( ));
+    BOOST_CHECK( brick->isLoaded( ));
+    BOOST_CHECK_EQUAL( cache.getNumberOfCacheObjects(), cacheIds.size( ));
+}
@@ -0,0 +1,88 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE LibDiskCache
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/cache/DiskCache.h>
+#include <livre/core/data/MemoryUnit.h>
+
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+const size_t BRICK_SIZE = 1024;
+const std::string VOLUME = "mem:///#64,64,64,1,32";
+const uint32_t FORMAT = 42;
+
+void storeBrick( livre::DiskCache& cache, const uint8_t value )
+{
+    livre::AllocMemoryUnit brick;
+    brick.alloc( BRICK_SIZE );
+    ::memset( brick.getData< uint8_t >(), value, BRICK_SIZE );
+    cache.store( value, FORMAT, brick );
+}
+}
+
+BOOST_AUTO_TEST_CASE( testDiskCache )
+{
+    const fs::path directory = fs::temp_directory_path() /
+                               fs::unique_path( "livre-%%%%-%%%%" );
+    {
+        livre::DiskCache cache( directory.string(), VOLUME,
+                                BRICK_SIZE * 5 / 2 );
+        for( uint8_t i = 1; i <= 3; ++i )
+            storeBrick( cache, i );
+
+        // the least recently used brick is evicted
+        BOOST_CHECK( !cache.contains( 1, FORMAT ));
+        BOOST_CHECK( cache.contains( 2, FORMAT ));
+        BOOST_CHECK( cache.contains( 3, FORMAT ));
+        BOOST_CHECK_EQUAL( cache.getUsedMemory(), 2 * BRICK_SIZE );
+
+        livre::AllocMemoryUnit brick;
+        BOOST_CHECK( !cache.load( 1, FORMAT, BRICK_SIZE, brick ));
+        // removes the brick
+        BOOST_CHECK( !cache.load( 2, FORMAT, BRICK_SIZE + 1, brick ));
+
+        // bricks of another format are not read back
+        BOOST_CHECK( !cache.contains( 3, FORMAT + 1 ));
+        BOOST_CHECK( !cache.load( 3, FORMAT + 1, BRICK_SIZE, brick ));
+    }
+    {
+        // bricks survive the session
+        livre::DiskCache cache( directory.string(), VOLUME, BRICK_SIZE * 4 );
+        BOOST_CHECK( cache.contains( 3, FORMAT ));
+        BOOST_CHECK_EQUAL( cache.getUsedMemory(), BRICK_SIZE );
+
+        livre::AllocMemoryUnit brick;
+        BOOST_REQUIRE( cache.load( 3, FORMAT, BRICK_SIZE, brick ));
+        BOOST_CHECK_EQUAL( brick.getMemSize(), BRICK_SIZE );
+        BOOST_CHECK_EQUAL( brick.getData< uint8_t >()[ BRICK_SIZE - 1 ], 3 );
+    }
+    {
+        // other volumes do not share the bricks
+        livre::DiskCache cache( directory.string(), VOLUME + "#other",
+                                BRICK_SIZE * 4 );
+        BOOST_CHECK( !cache.contains( 3, FORMAT ));
+    }
+    fs::remove_all( directory );
+}
@@ -21,6 +21,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include <livre/lib/zeq/events.h>
+#include <livre/core/data/MemoryUnit.h>
+#include <livre/core/data/NodeId.h>
 #include <livre/core/data/VolumeInformation.h>
 #include <zeq/event.h>
 #include <zeq/publisher.h>
@@ -129,3 +131,39 @@ BOOST_AUTO_TEST_CASE( testDataSourceData )
     }
     BOOST_CHECK( received );
 }
+
+BOOST_AUTO_TEST_CASE( testDataSampleData )
+{
+    const livre::NodeId nodeId( 2, Vector3ui( 1, 2, 3 ), 4 );
+    livre::AllocMemoryUnitPtr sparse( new livre::AllocMemoryUnit );
+    sparse->alloc( 40 * 40 * 40 );
+    uint8_t* bytes = sparse->getData< uint8_t >();
+    ::memset( bytes, 0, sparse->getMemSize( ));
+    bytes[ 42 ] = 17;
+
+    const livre::BrickCompression compressions[] = {
+        livre::BRICK_COMPRESSION_NONE, livre::BRICK_COMPRESSION_LZ4,
+        livre::BRICK_COMPRESSION_ZSTD };
+    BOOST_FOREACH( const livre::BrickCompression compression, compressions )
+    {
+        if( !livre::isBrickCompressionSupported( compression ))
+            continue;
+
+        const zeq::Event& event = livre::zeq::serializeDataSampleData(
+                                      zeq::uint128_t( 17, 42 ), nodeId,
+                                      sparse, compression );
+        BOOST_CHECK( livre::zeq::deserializeDataSampleNodeId( event ) ==
+                     nodeId );
+        if( compression != livre::BRICK_COMPRESSION_NONE )
+            BOOST_CHECK_LT( livre::zeq::deserializeDataSampleData( event ).second,
+                            sparse->getMemSize( ));
+
+        livre::AllocMemoryUnit memory;
+        BOOST_CHECK( livre::zeq::deserializeDataSampleData( event, memory ));
+        BOOST_REQUIRE_EQUAL( memory.getMemSize(), sparse->getMemSize( ));
+        BOOST_CHECK_EQUAL_COLLECTIONS( bytes, bytes + sparse->getMemSize(),
+                                       memory.getData< uint8_t >(),
+                                       memory.getData< uint8_t >() +
+                                           memory.getMemSize( ));
+    }
+}
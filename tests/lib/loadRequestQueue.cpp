@@ -0,0 +1,82 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE LibLoadRequestQueue
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/uploaders/LoadRequestQueue.h>
+
+#include <limits>
+
+BOOST_AUTO_TEST_CASE( testLoadRequestQueue )
+{
+    livre::LoadRequestQueue queue;
+    livre::CacheId cacheId = livre::INVALID_CACHE_ID;
+    BOOST_CHECK( queue.isEmpty( ));
+    BOOST_CHECK( !queue.pop( cacheId ));
+
+    queue.push( 1, 0.5f );
+    queue.push( 2, 2.f );
+    queue.push( 3, 1.f );
+    queue.push( 1, 4.f ); // reprioritized, queued once
+    BOOST_CHECK_EQUAL( queue.getSize(), 3u );
+
+    const livre::CacheIds cacheIds = queue.getCacheIds();
+    BOOST_REQUIRE_EQUAL( cacheIds.size(), 3u );
+    BOOST_CHECK_EQUAL( cacheIds[0], 1u );
+    BOOST_CHECK_EQUAL( cacheIds[1], 2u );
+    BOOST_CHECK_EQUAL( cacheIds[2], 3u );
+
+    BOOST_REQUIRE( queue.pop( cacheId ));
+    BOOST_CHECK_EQUAL( cacheId, 1u );
+    BOOST_REQUIRE( queue.pop( cacheId ));
+    BOOST_CHECK_EQUAL( cacheId, 2u );
+    BOOST_CHECK_EQUAL( queue.getSize(), 1u );
+
+    // a new epoch drops the stale requests
+    queue.push( 4, 8.f );
+    queue.setEpoch( queue.getEpoch() + 1 );
+    BOOST_CHECK( queue.isEmpty( ));
+    BOOST_CHECK( !queue.pop( cacheId ));
+
+    // the same epoch keeps them
+    queue.push( 5, 1.f );
+    queue.setEpoch( queue.getEpoch( ));
+    BOOST_REQUIRE( queue.pop( cacheId ));
+    BOOST_CHECK_EQUAL( cacheId, 5u );
+
+    // repeated reprioritizing keeps the order and the size
+    for( size_t i = 0; i < 4096; ++i )
+        queue.push( i % 16, float( i ));
+    BOOST_CHECK_EQUAL( queue.getSize(), 16u );
+    BOOST_REQUIRE( queue.pop( cacheId ));
+    BOOST_CHECK_EQUAL( cacheId, 15u );
+    size_t count = 1;
+    while( queue.pop( cacheId ))
+        ++count;
+    BOOST_CHECK_EQUAL( count, 16u );
+
+    // non finite priorities are not queued
+    queue.push( 6, std::numeric_limits< float >::quiet_NaN( ));
+    queue.push( 7, std::numeric_limits< float >::infinity( ));
+    queue.push( 8, 1.f );
+    BOOST_CHECK_EQUAL( queue.getSize(), 1u );
+    BOOST_REQUIRE( queue.pop( cacheId ));
+    BOOST_CHECK_EQUAL( cacheId, 8u );
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define BOOST_TEST_MODULE LibTierWriter
+#include <boost/test/unit_test.hpp>
+
+#include <livre/lib/cache/CompressedCache.h>
+#include <livre/lib/cache/DiskCache.h>
+#include <livre/lib/cache/TierWriter.h>
+#include <livre/core/data/MemoryUnit.h>
+
+#include <boost/filesystem.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+const size_t BRICK_SIZE = 4096;
+const uint32_t FORMAT = 42;
+
+livre::ConstMemoryUnitPtr createBrick( const uint8_t value )
+{
+    livre::AllocMemoryUnitPtr brick( new livre::AllocMemoryUnit );
+    brick->alloc( BRICK_SIZE );
+    ::memset( brick->getData< uint8_t >(), value, BRICK_SIZE );
+    return brick;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testTierWriter )
+{
+    const fs::path directory = fs::temp_directory_path() /
+                               fs::unique_path( "livre-%%%%-%%%%" );
+    const livre::DiskCachePtr diskCache(
+        new livre::DiskCache( directory.string(), "mem:///", LB_1MB ));
+    const livre::CompressedCachePtr compressedCache(
+        livre::CompressedCache::isSupported() ?
+            new livre::CompressedCache( LB_1MB ) : 0 );
+    {
+        livre::TierWriter writer( 2 * BRICK_SIZE );
+
+        // bricks above the maximum memory are dropped
+        writer.write( 1, createBrick( 1 ), compressedCache, diskCache, FORMAT );
+        writer.write( 2, createBrick( 2 ), compressedCache, diskCache, FORMAT );
+        writer.write( 3, createBrick( 3 ), compressedCache, diskCache, FORMAT );
+        BOOST_CHECK_LE( writer.getUsedMemory(), 2 * BRICK_SIZE );
+        writer.flush();
+        BOOST_CHECK_EQUAL( writer.getUsedMemory(), 0u );
+        BOOST_CHECK( diskCache->contains( 1, FORMAT ));
+        BOOST_CHECK( diskCache->contains( 2, FORMAT ));
+        if( compressedCache )
+            BOOST_CHECK( compressedCache->contains( 1 ));
+
+        // a brick taken back is not written
+        const livre::ConstMemoryUnitPtr brick = createBrick( 4 );
+        writer.write( 4, brick, compressedCache, diskCache, FORMAT );
+        const livre::ConstMemoryUnitPtr taken = writer.take( 4 );
+        if( taken ) // unless written already
+        {
+            BOOST_CHECK( taken == brick );
+            writer.flush();
+            BOOST_CHECK( !diskCache->contains( 4, FORMAT ));
+        }
+        BOOST_CHECK( !writer.take( 4 ));
+
+        // the destructor writes the waiting bricks
+        writer.write( 5, createBrick( 5 ), compressedCache, diskCache, FORMAT );
+    }
+    BOOST_CHECK( diskCache->contains( 5, FORMAT ));
+
+    livre::AllocMemoryUnit memory;
+    BOOST_REQUIRE( diskCache->load( 5, FORMAT, BRICK_SIZE, memory ));
+    BOOST_CHECK_EQUAL( memory.getData< uint8_t >()[ BRICK_SIZE - 1 ], 5 );
+    fs::remove_all( directory );
+}
@@ -0,0 +1,97 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Measures the cache lookup throughput with an increasing number of threads
+// looking up and referencing the same set of objects, while one thread queries
+// the cache size like the upload and render threads do.
+
+#define BOOST_TEST_MODULE CacheContention
+#include <boost/test/unit_test.hpp>
+
+#include "../core/cache/Cache.h"
+
+#include <lunchbox/atomic.h>
+#include <lunchbox/clock.h>
+
+#include <boost/thread/thread.hpp>
+
+namespace
+{
+const uint32_t NUM_OBJECTS = 4096;
+const uint32_t NUM_LOOKUPS = 200000;
+
+void lookup( test::Cache& cache, const uint32_t seed )
+{
+    // xorshift, to not contend on a shared random number generator
+    uint32_t random = seed * 2654435761u + 1;
+    for( uint32_t i = 0; i < NUM_LOOKUPS; ++i )
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        const livre::CacheObjectPtr object =
+            cache.getObjectFromCache( random % NUM_OBJECTS + 1 );
+        if( !object )
+            BOOST_ERROR( "Missing cache object" );
+        object->isLoaded();
+    }
+}
+
+void query( const test::Cache& cache,
+            const lunchbox::a_int32_t& done )
+{
+    while( !done )
+        if( cache.getNumberOfCacheObjects() != NUM_OBJECTS )
+            BOOST_ERROR( "Wrong number of cache objects" );
+}
+}
+
+BOOST_AUTO_TEST_CASE( testCacheContention )
+{
+    test::Cache cache;
+    for( uint32_t i = 1; i <= NUM_OBJECTS; ++i )
+        cache.getObjectFromCache( i );
+    BOOST_CHECK_EQUAL( cache.getNumberOfCacheObjects(), NUM_OBJECTS );
+
+    const uint32_t maxThreads =
+        std::max( 2u * boost::thread::hardware_concurrency(), 2u );
+    std::cout << "Threads, million lookups/s" << std::endl;
+    for( uint32_t nThreads = 1; nThreads <= maxThreads; nThreads <<= 1 )
+    {
+        lunchbox::a_int32_t done( 0 );
+        boost::thread queryThread( boost::bind( &query, boost::cref( cache ),
+                                                boost::cref( done )));
+
+        lunchbox::Clock clock;
+        boost::thread_group threads;
+        for( uint32_t i = 0; i < nThreads; ++i )
+            threads.create_thread( boost::bind( &lookup, boost::ref( cache ),
+                                                i ));
+        threads.join_all();
+        const float time = clock.getTimef() / 1000.f;
+
+        done = 1;
+        queryThread.join();
+
+        std::cout << nThreads << ", "
+                  << float( nThreads ) * NUM_LOOKUPS / time / 1000000.f
+                  << std::endl;
+    }
+    BOOST_CHECK_EQUAL( cache.getNumberOfCacheObjects(), NUM_OBJECTS );
+}
@@ -0,0 +1,116 @@
+/* Copyright (c) 2011-2015, EPFL/Blue Brain Project
+ *                          Ahmet Bilgili <ahmet.bilgili@epfl.ch>
+ *
+ * This file is part of Livre <https://github.com/BlueBrain/Livre>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Plays back an animation for many frames, each one requesting new node ids,
+// and checks that the number of cache objects stays flat and that the reclaimed
+// ones are freed.
+
+#define BOOST_TEST_MODULE CacheSoak
+#include <boost/test/unit_test.hpp>
+
+#include "../core/cache/Cache.h"
+
+#include <livre/core/cache/CacheStatistics.h>
+#include <livre/core/data/NodeId.h>
+
+namespace
+{
+const uint32_t NUM_FRAMES = 10000;
+const uint32_t NODES_PER_FRAME = 64;
+const size_t MAX_LOADED_OBJECTS = 256;
+const size_t MAX_OBJECTS = 1024;
+
+size_t _destroyedObjects = 0;
+
+class SoakCacheObject : public test::ValidCacheObject
+{
+public:
+    ~SoakCacheObject() { ++_destroyedObjects; }
+};
+
+class SoakCache : public livre::LRUCache
+{
+private:
+    livre::CacheObject* generateCacheObjectFromID_(
+        const livre::CacheId cacheId ) final
+    {
+        SoakCacheObject* cacheObject = new SoakCacheObject();
+        cacheObject->setCacheId( cacheId );
+        return cacheObject;
+    }
+};
+}
+
+BOOST_AUTO_TEST_CASE( testCacheSoak )
+{
+    SoakCache cache;
+    cache.setMaximumMemory( MAX_LOADED_OBJECTS * test::CACHE_SIZE );
+    cache.setCleanupRatio( 0.25f );
+    cache.setMaximumObjectCount( MAX_OBJECTS );
+
+    // the root of the first frame stays referenced, like by the render nodes
+    const livre::NodeId root( 0, livre::Vector3ui( 0u ), 0 );
+    const livre::CacheObjectPtr rootObject =
+        cache.getObjectFromCache( root.getId( ));
+    rootObject->cacheLoad();
+
+    size_t maxObjectCount = 0;
+    for( uint32_t frame = 1; frame < NUM_FRAMES; ++frame )
+    {
+        for( uint32_t i = 0; i < NODES_PER_FRAME; ++i )
+        {
+            const livre::NodeId nodeId( 3, livre::Vector3ui( i % 4, i / 4 % 4,
+                                                             i / 16 ), frame );
+            cache.getObjectFromCache( nodeId.getId( ))->cacheLoad();
+        }
+        maxObjectCount = std::max( maxObjectCount,
+                                   cache.getNumberOfCacheObjects( ));
+    }
+
+    const livre::CacheStatistics& statistics = cache.getStatistics();
+    std::cout << "Objects: " << cache.getNumberOfCacheObjects() << ", peak "
+              << maxObjectCount << ", reclaimed "
+              << statistics.getReclaimCount() << std::endl;
+
+    BOOST_CHECK_LE( maxObjectCount, MAX_OBJECTS );
+    BOOST_CHECK_EQUAL( _destroyedObjects, statistics.getReclaimCount( ));
+    BOOST_CHECK_EQUAL( statistics.getReclaimCount() +
+                           cache.getNumberOfCacheObjects(),
+                       1 + ( NUM_FRAMES - 1 ) * NODES_PER_FRAME );
+    BOOST_CHECK_LE( statistics.getUsedMemory(),
+                    MAX_LOADED_OBJECTS * test::CACHE_SIZE );
+    BOOST_CHECK( cache.getObjectFromCache( root.getId( )) == rootObject );
+    BOOST_CHECK( rootObject->isLoaded( ));
+
+    // everything unused can be reclaimed on demand, without counting the
+    // reclaimed objects as unloaded
+    const size_t blockCount = statistics.getBlockCount();
+    const size_t unloadCount = statistics.getUnloadCount();
+    const size_t usedMemory = statistics.getUsedMemory();
+    cache.reclaim();
+    BOOST_CHECK_LE( cache.getNumberOfCacheObjects(), MAX_LOADED_OBJECTS + 1 );
+    BOOST_CHECK_EQUAL( statistics.getBlockCount(), blockCount );
+    BOOST_CHECK_EQUAL( statistics.getUnloadCount(), unloadCount );
+    BOOST_CHECK_EQUAL( statistics.getUsedMemory(), usedMemory );
+    BOOST_CHECK_EQUAL( statistics.getUsedMemory(),
+                       statistics.getBlockCount() * test::CACHE_SIZE );
+
+    // the reclaimed objects are destroyed, not only removed from the map
+    BOOST_CHECK_EQUAL( _destroyedObjects, statistics.getReclaimCount( ));
+}
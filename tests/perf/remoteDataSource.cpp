@@ -43,6 +43,8 @@ public:
                      uri.findQuery( "bind" )->second ) + ":" + port )
     {}
 
+    const livre::DataService& getService() const { return _service; }
+
 private:
     livre::DataService _service;
 
@@ -132,6 +134,65 @@ BOOST_AUTO_TEST_CASE( testRemote )
                   << std::endl;
         BOOST_FOREACH( const std::string& string, result )
             std::cout << string << std::endl;
+
+        // Throughput for batched requests against the number of outstanding
+        // requests. Each batch asks for distinct nodes to avoid the dedup.
+        result.clear();
+        const std::string separator =
+            uriBase.find( '?' ) == std::string::npos ? "?" : "&";
+        const uint32_t blockSize = 64;
+        const uint32_t batchSize = 64;
+        for( uint32_t window = 1; window <= 64; window = window << 1 )
+        {
+            livre::VolumeDataSource dataSource(
+                lunchbox::URI( uriBase + separator + "window=" +
+                               lexical_cast< std::string >( window ) +
+                               "#1024,1024,1024," +
+                               lexical_cast< std::string >( blockSize )));
+            const livre::VolumeInformation& info =
+                dataSource.getVolumeInformation();
+            const vmml::Vector3ui block( blockSize );
+            const livre::Boxf worldBox( vmml::Vector3i( 0.f ),
+                                        vmml::Vector3i( 1.f ));
+            const size_t brickSize = ( livre::Vector3ui( blockSize ) +
+                                       info.overlap * 2 ).product();
+
+            size_t bytes = 0;
+            uint32_t batch = 0;
+            lunchbox::Clock clock;
+            while( clock.getTimef() < 300.f )
+            {
+                livre::LODNodes nodes;
+                for( uint32_t j = 0; j < batchSize; ++j )
+                {
+                    const uint32_t id = batch * batchSize + j;
+                    const vmml::Vector3ui position( id % 128, id / 128 % 128,
+                                                    id / 16384 );
+                    nodes.push_back( livre::LODNode(
+                        livre::NodeId( 0, position ), block, worldBox ));
+                }
+                ++batch;
+
+                livre::MemoryUnitFutures futures =
+                    dataSource.getDataAsync( nodes );
+                BOOST_FOREACH( livre::MemoryUnitFuture& future, futures )
+                {
+                    const livre::MemoryUnitPtr mem = future.get();
+                    BOOST_REQUIRE( mem );
+                    BOOST_CHECK_EQUAL( mem->getMemSize(), brickSize );
+                    bytes += mem->getMemSize();
+                }
+            }
+            const float time = clock.getTimef();
+
+            std::ostringstream os;
+            os << window << ", " << bytes/1024.f*1000.f/1024.f / time;
+            result.push_back( os.str( ));
+        }
+        std::cout << std::endl << "Window size, MB/s (" << blockSize
+                  << "^3 bricks)" << std::endl;
+        BOOST_FOREACH( const std::string& string, result )
+            std::cout << string << std::endl;
     }
     catch( const std::runtime_error& e )
     {
@@ -151,6 +212,114 @@ BOOST_AUTO_TEST_CASE( testRemote )
         delete service;
     }
 }
+
+namespace
+{
+const uint32_t nClients = 8;
+const uint32_t nRequests = 32;
+
+/** Called concurrently, so it reports instead of checking with Boost.Test */
+void _requestBricks( livre::VolumeDataSource& dataSource,
+                     const livre::LODNodes& nodes, const size_t brickSize,
+                     bool& valid )
+{
+    valid = true;
+    livre::MemoryUnitFutures futures = dataSource.getDataAsync( nodes );
+    BOOST_FOREACH( livre::MemoryUnitFuture& future, futures )
+    {
+        const livre::MemoryUnitPtr mem = future.get();
+        if( !mem || mem->getMemSize() != brickSize )
+        {
+            valid = false;
+            continue;
+        }
+
+        const uint8_t* bytes = mem->getData< uint8_t >();
+        for( size_t j = 0; j < brickSize; ++j )
+            valid = valid && bytes[j] == 42;
+    }
+}
+}
+
+// Several clients with their own data source request the same bricks at once.
+// The service reads each brick once: the other requests are coalesced while
+// it is pending, or answered from the brick cache.
+BOOST_AUTO_TEST_CASE( testConcurrentRequests )
+{
+    const int argc = boost::unit_test::framework::master_test_suite().argc;
+    if( argc == 2 ) // the external service may not be restarted
+        return;
+
+    const std::string uriBase = "remotemem://127.0.0.1:" + port + "/";
+    zeq::Publisher publisher( lunchbox::URI( "livresink://" ));
+    DataService* service = new DataService( lunchbox::URI( uriBase ));
+    service->start();
+
+    try
+    {
+        const uint32_t blockSize = 32;
+        const lunchbox::URI uri( uriBase + "#256,256,256," +
+                                 lexical_cast< std::string >( blockSize ));
+        std::vector< livre::VolumeDataSourcePtr > dataSources;
+        for( uint32_t i = 0; i < nClients; ++i )
+            dataSources.push_back( livre::VolumeDataSourcePtr(
+                                       new livre::VolumeDataSource( uri )));
+        const livre::VolumeInformation& info =
+            dataSources.front()->getVolumeInformation();
+        const vmml::Vector3ui block( blockSize );
+        const livre::Boxf worldBox( vmml::Vector3i( 0.f ),
+                                    vmml::Vector3i( 1.f ));
+        const size_t brickSize = ( livre::Vector3ui( blockSize ) +
+                                   info.overlap * 2 ).product();
+
+        livre::LODNodes nodes;
+        for( uint32_t i = 0; i < nRequests; ++i )
+        {
+            const vmml::Vector3ui position( i % 8, i / 8, 0 );
+            nodes.push_back( livre::LODNode( livre::NodeId( 0, position ),
+                                             block, worldBox ));
+        }
+
+        bool valid[ nClients ];
+        boost::thread_group clients;
+        for( uint32_t i = 0; i < nClients; ++i )
+            clients.create_thread( boost::bind( &_requestBricks,
+                                                boost::ref( *dataSources[i] ),
+                                                boost::cref( nodes ),
+                                                brickSize,
+                                                boost::ref( valid[i] )));
+        clients.join_all();
+        for( uint32_t i = 0; i < nClients; ++i )
+            BOOST_CHECK_MESSAGE( valid[i], "Invalid data for client " << i );
+
+        const livre::DataService& dataService = service->getService();
+        BOOST_CHECK_EQUAL( dataService.getReadCount(), nRequests );
+        BOOST_CHECK_EQUAL( dataService.getReadCount() +
+                           dataService.getCacheHitCount() +
+                           dataService.getCoalescedCount(),
+                           nClients * nRequests );
+
+        // served from the cache of the service, without reading again
+        const size_t cacheHits = dataService.getCacheHitCount();
+        bool cached = false;
+        _requestBricks( *dataSources.front(), nodes, brickSize, cached );
+        BOOST_CHECK( cached );
+        BOOST_CHECK_EQUAL( dataService.getReadCount(), nRequests );
+        BOOST_CHECK_EQUAL( dataService.getCacheHitCount(),
+                           cacheHits + nRequests );
+    }
+    catch( const std::runtime_error& e )
+    {
+        BOOST_CHECK_EQUAL( e.what(),
+                           std::string( "Cannot connect to publisher" ));
+        service->cancel();
+        return;
+    }
+
+    BOOST_CHECK( publisher.publish( zeq::Event( zeq::vocabulary::EVENT_EXIT )));
+    service->join();
+    delete service;
+}
 #else
 BOOST_AUTO_TEST_CASE( testRemote )
 {